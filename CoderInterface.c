@@ -5,119 +5,444 @@
  *        Do things
  *
  * @creation 2024/04/14
- * @edition 2024/04/14
- * 
+ * @edition 2026/10/17
+ *
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @note fixed point
+ * widths are kept in timer ticks, speeds are Q16 turns per second. The scale
+ * factors are derived from the timer configuration at compile time, every
+ * coder timer ticks at CODER_TICK_HZ. test_coder on the host checks the speed
+ * against the same estimator in float: within 1.5e-4 relative at 0.5 turns/s
+ * (Q16 truncation), under 2e-5 above 3 turns/s.
+ *
+ * @note captures
+ * the DMA copies each captured counter value in the ring of the coder, the
+ * counter is never reset. CoderInterface_Run() reads the captures written
+ * since its last call, by the DMA counter, and the width of each one is the
+ * difference with the previous capture modulo the counter period. Without
+ * captures for half the counter period the coder is stopped: a width could
+ * be longer than the period, the next capture only gives a reference.
+ *
+ * @note M/T estimation
+ * captures add their edges and ticks until CODER_MT_WINDOW_TICKS is reached,
+ * the speed measured is then edges over ticks. At low speed a single period
+ * fills the window (T method), at high speed many edges are counted over the
+ * window (M method), with no switch in between. Above CODER_DIVIDE_ABOVE
+ * edges per window the capture prescaler only captures one edge out of
+ * CODER_IC_DIVIDER, to save DMA transfers and ring space.
+ *
+ * @note filter
+ * the measures go through an alpha-beta filter (speed and its slope), which
+ * follows a ramp without lag where a moving average is late by half its
+ * length. beta = alpha^2 / (2 - alpha) (Benedict-Bordner), alpha is chosen
+ * by CoderInterface_SetResponse(). The slope is per tick, per ms in encoder
+ * mode.
+ *
+ * @note step response
+ * esw_coder_replay plays edge traces (5% period jitter) through the coder and
+ * the former average of the last 30 periods: 90% latency of a step, RMS noise
+ * at the final speed (constant speed trace, once settled).
+ * 			turns/s    average       fast         medium       slow
+ * 			1 -> 2     507 ms 0.5%   76 ms 1.9%   91 ms 1.3%   184 ms 1.1%
+ * 			5 -> 10    102 ms 0.5%   26 ms 1.4%   30 ms 1.2%    75 ms 0.6%
+ * 			20 -> 40    25 ms 0.7%   16 ms 0.8%   23 ms 0.6%    53 ms 0.4%
+ * 			40 -> 20    43 ms 0.6%   18 ms 1.2%   22 ms 0.8%    59 ms 0.6%
+ * 			100 -> 150   7 ms 1.9%   16 ms 0.8%   21 ms 0.6%    54 ms 0.2%
+ * the 5 ms window keeps the default no slower than the average at 20 turns/s
+ * (test_coder_replay), the quantization of the 250 us tick is then up to 5%
+ * per measure, 1% once filtered. Below 10 turns/s the average of 30 periods
+ * spans more time than the filter and is smoother, but 3 to 5 times slower.
+ *
+ * @note encoder mode (CODER_ENCODER_MODE)
+ * the timer counts both edges of both channels, up or down with the
+ * direction, without any interrupt. The update interrupt extends the 16 bits
+ * counter to 32 bits: the counter is near 0 after an overflow and near the
+ * top after an underflow. The speed is the position change over at least
+ * CODER_SAMPLE_MS.
+ ******************************************************************************
  */
 #include "CoderInterface.h"
-#include "Shell.h"
+#include "Telemetry.h"
+#include "Trace.h"
 
-#include <stdint.h>
-#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
 
 // ------------------------------------------------------------------------
 // -------------------------------- MACROS --------------------------------
 // ------------------------------------------------------------------------
 #define CODER_NB_STEPS (30)
 
-#define CODER_TIM (&htim9)
-#define TIM_CHANNEL HAL_TIM_ACTIVE_CHANNEL_1
+#ifdef CODER_ENCODER_MODE
+#define CODER_COUNTS_PER_TURN (4 * CODER_NB_STEPS)		// both edges of both channels
+#define CODER_COUNTER_RANGE 	(0x10000)
+#define CODER_SAMPLE_MS 			(20)		// shortest window of the position derivative
+#endif
 
 #define TIMCLOCK (168000000)
 #define PRESCALAR (42000)
-#define COUNTER_PERIOD (2000)
 
-#define WIDTH_BUF_LENGTH (30)
+#define CODER_Q16_ONE (1UL << 16)
+#define CODER_TICK_HZ (TIMCLOCK / PRESCALAR)
+#define CODER_SPEED_SCALE_Q16 (((uint64_t)CODER_TICK_HZ << 16) / CODER_NB_STEPS)		// turns per second of one edge per tick
+#define CODER_SPEED_GAIN_Q16 	(CODER_Q16_ONE / 5)		// ratio = 1 + (speed - 1) * gain
 
-// ------------------------------------------------------------------------
-// ----------------------------- STATIC TYPES -----------------------------
-// ------------------------------------------------------------------------
+#define CODER_MT_WINDOW_TICKS (CODER_TICK_HZ / 200)		// 5 ms
+#define CODER_IC_DIVIDER 			(8)		// edges per capture when divided (TIM_ICPSC_DIV8)
+#define CODER_DIVIDE_ABOVE 		(32)		// edges per window
+#define CODER_UNDIVIDE_BELOW 	(16)		// edges per window, hysteresis (a divided capture counts 8)
 
 // ------------------------------------------------------------------------
 // -------------------------- STATIC PROTOTYPES ---------------------------
 // ------------------------------------------------------------------------
-static uint8_t timeout_flag = false;
+static Coder* s_coders[CODER_MAX_INSTANCES];
+static uint8_t s_nb_coders = 0;
 
-static bool 	width_buf_full = false;
-static uint8_t 	width_index = 0;
-static uint32_t width_buf[WIDTH_BUF_LENGTH];
-static uint32_t width_sum = 0;
-static uint32_t width_mean = 0;
+static const uint32_t s_response_gains[CODER_NB_RESPONSES][2] = {		// {alpha, beta} Q16
+	{CODER_Q16_ONE / 2, CODER_Q16_ONE / 6},			// CODER_RESPONSE_FAST
+	{CODER_Q16_ONE / 3, CODER_Q16_ONE / 15},		// CODER_RESPONSE_MEDIUM
+	{CODER_Q16_ONE / 8, CODER_Q16_ONE / 120},		// CODER_RESPONSE_SLOW
+};
 
 // ------------------------------------------------------------------------
 // ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
 // ------------------------------------------------------------------------
-void _UpdateWidth(uint32_t width);
+bool _Register(Coder* coder, TIM_HandleTypeDef* htim);
+void _FilterSpeed(Coder* coder, uint32_t measure, uint32_t elapsed);
+void _ResetEstimator(Coder* coder);
+#ifdef CODER_ENCODER_MODE
+void _SampleSpeed(Coder* coder);
+#else
+uint16_t _GetWriteIndex(Coder* coder);
+uint32_t _LatchDmaFlags(Coder* coder);
+bool 		 _IsLapped(Coder* coder, uint16_t write_index, uint32_t flags);
+void _UpdateWidth(Coder* coder, uint32_t width);
+void _SetCaptureDivider(Coder* coder, uint8_t divider);
+#endif
 
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-TIM_HandleTypeDef* CoderInterface_GetTim() {
-	return CODER_TIM;
+#ifdef CODER_ENCODER_MODE
+/*
+ * Starts the encoder interface, the timer update interrupt must call
+ * CoderInterface_UpdateIRQ(). The counter must wrap at 0xFFFF
+ * (CODER_COUNTER_RANGE), even on the 32 bits TIM2 and TIM5
+ */
+bool CoderInterface_Init(Coder* coder, TIM_HandleTypeDef* htim) {
+	if (__HAL_TIM_GET_AUTORELOAD(htim) != CODER_COUNTER_RANGE - 1) return false;
+	if (!_Register(coder, htim)) return false;
+
+	__HAL_TIM_SET_COUNTER(htim, 0);
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+	__HAL_TIM_ENABLE_IT(htim, TIM_IT_UPDATE);
+	if (HAL_TIM_Encoder_Start(htim, TIM_CHANNEL_ALL) != HAL_OK) return false;
+
+	coder->sample_tick = HAL_GetTick();
+	return true;
+}
+
+/*
+ * Before HAL_TIM_IRQHandler(), which clears the update flag. The flag is
+ * cleared even if no coder uses the timer, the interrupt would fire again
+ */
+void CoderInterface_UpdateIRQ(TIM_HandleTypeDef *htim) {
+	if (!__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE)) return;
+	__HAL_TIM_CLEAR_FLAG(htim, TIM_FLAG_UPDATE);
+
+	for (uint8_t index = 0; index < s_nb_coders; index++) {
+		Coder* coder = s_coders[index];
+		if (coder->htim != htim) continue;
+
+		if (__HAL_TIM_GET_COUNTER(htim) < CODER_COUNTER_RANGE / 2) coder->position_high += CODER_COUNTER_RANGE;
+		else coder->position_high -= CODER_COUNTER_RANGE;
+		return;
+	}
+}
+
+/*
+ * Counts since CoderInterface_Init(), CODER_COUNTS_PER_TURN per turn
+ */
+int32_t CoderInterface_GetPosition(Coder* coder) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	int32_t high = coder->position_high;
+	uint32_t counter = __HAL_TIM_GET_COUNTER(coder->htim);
+	if (__HAL_TIM_GET_FLAG(coder->htim, TIM_FLAG_UPDATE)) {		// wrapped, the interrupt is pending
+		counter = __HAL_TIM_GET_COUNTER(coder->htim);
+		high += (counter < CODER_COUNTER_RANGE / 2) ? CODER_COUNTER_RANGE : -CODER_COUNTER_RANGE;
+	}
+	__set_PRIMASK(primask);
+	return high + (int32_t) counter;
+}
+
+/*
+ * 1 forward, -1 backward, 0 stopped over the last speed window
+ */
+int8_t CoderInterface_GetDirection(Coder* coder) {
+	return coder->direction;
 }
 
-void CoderInterface_TimIRQ(TIM_HandleTypeDef *htim) {
-	if (htim->Channel == TIM_CHANNEL)	{
+/*
+ * Main loop
+ */
+void CoderInterface_Run(Coder* coder) {
+	TRACE_ENTER(TRACE_CODER);
+	_SampleSpeed(coder);
+	TRACE_EXIT(TRACE_CODER);
+}
+#else
+/*
+ * Starts the captures of channel in the circular DMA ring, nb_captures values
+ */
+bool CoderInterface_Init(Coder* coder, TIM_HandleTypeDef* htim, uint32_t channel, uint32_t* captures, uint16_t nb_captures) {
+	uint16_t dma_id;
+
+	switch (channel) {
+	case TIM_CHANNEL_1: dma_id = TIM_DMA_ID_CC1; break;
+	case TIM_CHANNEL_2: dma_id = TIM_DMA_ID_CC2; break;
+	case TIM_CHANNEL_3: dma_id = TIM_DMA_ID_CC3; break;
+	case TIM_CHANNEL_4: dma_id = TIM_DMA_ID_CC4; break;
+	default: return false;
+	}
+	if (captures == NULL || nb_captures == 0 || htim->hdma[dma_id] == NULL) return false;
+	if (!_Register(coder, htim)) return false;
+
+	coder->channel = channel;
+	coder->hdma = htim->hdma[dma_id];
+	coder->captures = captures;
+	coder->nb_captures = nb_captures;
+	coder->counter_range = __HAL_TIM_GET_AUTORELOAD(htim) + 1;
+	coder->timeout_ms = (uint32_t)((uint64_t)coder->counter_range * 1000 / CODER_TICK_HZ / 2);
+	coder->stopped = true;
+	coder->dma_pending = 0;
+	coder->nb_laps = 0;
+	coder->edges_per_capture = 1;
+	coder->next_divider = 1;
+	__HAL_TIM_SET_ICPRESCALER(htim, channel, TIM_ICPSC_DIV1);
 
-		if (timeout_flag) {
-			timeout_flag = false;
-			return;
+	return HAL_TIM_IC_Start_DMA(htim, channel, captures, nb_captures) == HAL_OK;
+}
+
+/*
+ * Main loop: speed from the captures written since the last call
+ */
+void CoderInterface_Run(Coder* coder) {
+	uint32_t flags = _LatchDmaFlags(coder);		// before the write index, see _IsLapped()
+	uint16_t write_index = _GetWriteIndex(coder);
+	uint32_t now = HAL_GetTick();
+
+	TRACE_ENTER(TRACE_CODER);
+	if (_IsLapped(coder, write_index, flags)) {
+		coder->nb_laps++;
+		coder->read_index = write_index;		// the captures in the ring are not in order any more
+		coder->stopped = true;
+		coder->last_edge_ms = now;
+		TRACE_EXIT(TRACE_CODER);
+		return;
+	}
+	if (write_index == coder->read_index) {
+		if (!coder->stopped && now - coder->last_edge_ms >= coder->timeout_ms) {
+			coder->stopped = true;
+			_ResetEstimator(coder);
+			_SetCaptureDivider(coder, 1);		// the next edges may be slow
 		}
-		else {
-			uint32_t counter = HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_1);	// read second value
+		TRACE_EXIT(TRACE_CODER);
+		return;
+	}
 
-			float refClock = TIMCLOCK / PRESCALAR;
-			float mFactor = 1000000 / refClock;
+	coder->last_edge_ms = now;
+	while (coder->read_index != write_index) {
+		uint32_t capture = coder->captures[coder->read_index];
+		if (++coder->read_index == coder->nb_captures) coder->read_index = 0;
 
-			_UpdateWidth(counter * mFactor);
+		if (coder->stopped) {
+			coder->stopped = false;
 		}
-		__HAL_TIM_SET_COUNTER(htim, 0);		// reset the counter
+		else {
+			uint32_t width = (capture >= coder->last_capture) ? capture - coder->last_capture
+															  : capture + coder->counter_range - coder->last_capture;
+			_UpdateWidth(coder, width);
+		}
+		coder->last_capture = capture;
 	}
-	
+	_SetCaptureDivider(coder, coder->next_divider);		// the batch was captured with the previous one
+	TRACE_EXIT(TRACE_CODER);
 }
+#endif
 
-void CoderInterface_TimeOut() {
-	if (CODER_TIM->Instance->SR & TIM_FLAG_UPDATE) {
-		//Shell_PrintString("timeout\n");
-		timeout_flag = true;
-	}
+/*
+ * Q16 ratio, 0 when the coder is stopped
+ */
+uint32_t CoderInterface_GetSpeedRatioQ16(Coder* coder) {
+	uint32_t speed = coder->speed_q16;
+
+	if (!speed) return 0;
+	return CODER_Q16_ONE - CODER_SPEED_GAIN_Q16 + (uint32_t)(((uint64_t)speed * CODER_SPEED_GAIN_Q16) >> 16);
+}
+
+float CoderInterface_GetSpeedRatio(Coder* coder) {
+	return CoderInterface_GetSpeedRatioQ16(coder) * (1.0f / CODER_Q16_ONE);
 }
 
-float CoderInterface_GetSpeedRatio() {
-	if (timeout_flag || !width_mean) return 0;
-	float ratio = (1000000.0f / (CODER_NB_STEPS * width_mean));
-	ratio = (ratio - 1) * 0.2f + 1;
-	return ratio;
+/*
+ * Filter response time: about 2 / alpha measures, 4, 6 or 16 windows of 5 ms
+ */
+void CoderInterface_SetResponse(Coder* coder, CODER_RESPONSE response) {
+	if (response >= CODER_NB_RESPONSES) return;
+
+	coder->filter.alpha = s_response_gains[response][0];
+	coder->filter.beta  = s_response_gains[response][1];
 }
 
 // ------------------------------------------------------------------------
 // ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void _UpdateWidth(uint32_t width) {
-	if (width_buf_full) {
-		width_sum -= width_buf[width_index];
-		width_buf[width_index] = width;
-		width_sum += width;
-		
-		width_mean = width_sum / WIDTH_BUF_LENGTH;
-		
-		width_index++;
-		width_index %= WIDTH_BUF_LENGTH;
+/*
+ * Clears the coder and gives it the next telemetry source, at most CODER_MAX_INSTANCES
+ */
+bool _Register(Coder* coder, TIM_HandleTypeDef* htim) {
+	if (s_nb_coders >= CODER_MAX_INSTANCES) return false;
+
+	memset(coder, 0, sizeof(*coder));
+	coder->htim = htim;
+	coder->id = s_nb_coders;
+	CoderInterface_SetResponse(coder, CODER_RESPONSE_MEDIUM);
+	s_coders[s_nb_coders++] = coder;
+	return true;
+}
+
+/*
+ * Alpha-beta update with a measure taken elapsed time units after the previous one
+ */
+void _FilterSpeed(Coder* coder, uint32_t measure, uint32_t elapsed) {
+	Coder_Filter* filter = &coder->filter;
+
+	if (!filter->ready) {
+		filter->speed = measure;
+		filter->slope = 0;
+		filter->ready = true;
 	}
 	else {
-		width_buf[width_index] = width;
-		width_sum += width;
-		
-		width_index++;
-		width_mean = width_sum / width_index;
-		
-		if (width_index >= WIDTH_BUF_LENGTH) {
-			width_buf_full = true;
-			width_index = 0;
-		}
+		int32_t predicted = filter->speed + (int32_t)(((int64_t)filter->slope * elapsed) >> 8);
+		int32_t residual = (int32_t)measure - predicted;
+
+		filter->speed = predicted + (int32_t)(((int64_t)residual * filter->alpha) >> 16);
+		filter->slope += (int32_t)((((int64_t)residual * filter->beta) >> 8) / elapsed);
+	}
+	coder->speed_q16 = (filter->speed > 0) ? filter->speed : 0;
+}
+
+void _ResetEstimator(Coder* coder) {
+#ifndef CODER_ENCODER_MODE
+	coder->mt_edges = 0;
+	coder->mt_ticks = 0;
+#endif
+	coder->filter.ready = false;
+	coder->speed_q16 = 0;
+}
+
+#ifdef CODER_ENCODER_MODE
+/*
+ * Speed magnitude and direction from the position change, once the window
+ * is long enough
+ */
+void _SampleSpeed(Coder* coder) {
+	uint32_t tick = HAL_GetTick();
+	uint32_t elapsed = tick - coder->sample_tick;
+	if (elapsed < CODER_SAMPLE_MS) return;
+
+	int32_t position = CoderInterface_GetPosition(coder);
+	int32_t delta = position - coder->sample_position;
+	uint32_t counts = (delta < 0) ? -(uint32_t)delta : (uint32_t)delta;
+
+	_FilterSpeed(coder, (uint32_t)(((uint64_t)counts * 1000 << 16) / ((uint64_t)CODER_COUNTS_PER_TURN * elapsed)), elapsed);
+	coder->direction = (delta > 0) - (delta < 0);
+	coder->sample_position = position;
+	coder->sample_tick = tick;
+}
+#else
+/*
+ * Next ring entry the DMA writes
+ */
+uint16_t _GetWriteIndex(Coder* coder) {
+	uint16_t index = coder->nb_captures - __HAL_DMA_GET_COUNTER(coder->hdma);
+
+	return (index == coder->nb_captures) ? 0 : index;
+}
+
+/*
+ * Reads and clears the half / complete flags of the stream, only those set:
+ * a flag set in between is kept for the next call
+ */
+uint32_t _LatchDmaFlags(Coder* coder) {
+	uint32_t flags = __HAL_DMA_GET_FLAG(coder->hdma, __HAL_DMA_GET_HT_FLAG_INDEX(coder->hdma) | __HAL_DMA_GET_TC_FLAG_INDEX(coder->hdma));
+
+	if (flags) __HAL_DMA_CLEAR_FLAG(coder->hdma, flags);
+	return flags;
+}
+
+/*
+ * True if the DMA went round the ring past read_index: it then crossed the
+ * half or the end of the ring (flags) although the captures written since
+ * the last call do not, or both. A boundary crossed between the flags and
+ * the write index reads is pending: its flag comes with the next call, and
+ * the DMA crossing it again by then is a lap too.
+ */
+bool _IsLapped(Coder* coder, uint16_t write_index, uint32_t flags) {
+	const uint16_t boundaries[2] = {coder->nb_captures - coder->nb_captures / 2, 0};
+	const uint32_t masks[2] = {__HAL_DMA_GET_HT_FLAG_INDEX(coder->hdma), __HAL_DMA_GET_TC_FLAG_INDEX(coder->hdma)};
+	uint16_t written = (write_index + coder->nb_captures - coder->read_index) % coder->nb_captures;
+	uint8_t pending = 0;
+	uint8_t nb_crossed = 0;
+	bool lapped = false;
+
+	for (uint8_t cpt = 0; cpt < 2; cpt++) {
+		uint16_t distance = (boundaries[cpt] + coder->nb_captures - coder->read_index) % coder->nb_captures;
+		bool crossed = distance && distance <= written;
+		bool flagged = (flags & masks[cpt]) != 0;
+		bool was_pending = (coder->dma_pending >> cpt) & 1;
+
+		if (crossed) nb_crossed++;
+		if (flagged && !was_pending && !crossed) lapped = true;
+		if (was_pending && crossed) lapped = true;
+		if (crossed && !flagged) pending |= 1 << cpt;
 	}
+	coder->dma_pending = pending;
+	return lapped || nb_crossed == 2;
+}
+
+/*
+ * width in timer ticks, of edges_per_capture edges
+ */
+void _UpdateWidth(Coder* coder, uint32_t width) {
+	coder->mt_edges += coder->edges_per_capture;
+	coder->mt_ticks += width;
+	if (coder->mt_ticks < CODER_MT_WINDOW_TICKS) return;
+
+	uint32_t measure = (uint32_t)(CODER_SPEED_SCALE_Q16 * coder->mt_edges / coder->mt_ticks);
+	_FilterSpeed(coder, measure, coder->mt_ticks);
+
+	if (coder->mt_edges > CODER_DIVIDE_ABOVE) coder->next_divider = CODER_IC_DIVIDER;
+	else if (coder->mt_edges < CODER_UNDIVIDE_BELOW) coder->next_divider = 1;
+	coder->mt_edges = 0;
+	coder->mt_ticks = 0;
+
+	uint32_t sample[2] = {width, coder->speed_q16};
+	Telemetry_Send(TLM_CODER_WIDTH, coder->id, sample, sizeof(sample));
 }
 
+/*
+ * The first capture after a change may count less edges, one measure is off
+ */
+void _SetCaptureDivider(Coder* coder, uint8_t divider) {
+	coder->next_divider = divider;
+	if (divider == coder->edges_per_capture) return;
 
+	__HAL_TIM_SET_ICPRESCALER(coder->htim, coder->channel, (divider == 1) ? TIM_ICPSC_DIV1 : TIM_ICPSC_DIV8);
+	coder->edges_per_capture = divider;
+}
+#endif
@@ -5,25 +5,118 @@
  *        Do things
  *
  * @creation 2024/04/14
- * @edition 2024/04/14
- * 
+ * @edition 2026/10/17
+ *
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @setup one Coder per timer, the storage belongs to the caller
+ * 		input capture: the timer counts freely at CODER_TICK_HZ, the channel
+ * 		has a circular DMA (peripheral and memory words) which writes the
+ * 		captured counter values in the ring, without any interrupt per edge.
+ * 		The timer needs a DMA request on the channel: TIM1 to TIM5 or TIM8 on
+ * 		STM32F4, TIM9 to TIM14 have none. e.g. TIM3_CH1 is DMA1 Stream 4
+ * 		Channel 5, linked to htim3.hdma[TIM_DMA_ID_CC1]: CoderInterface_Init()
+ * 		fails without it.
+ * 		The ring must hold twice the captures of the longest main loop
+ * 		iteration at full speed, divided by 8 above 32 edges per 5 ms (capture
+ * 		prescaler). CoderInterface_Run() polls the half / complete flags of
+ * 		the stream to detect a longer stall, which overwrote captures not read
+ * 		yet (nb_laps): the DMA stream interrupt must stay disabled in the NVIC,
+ * 		HAL_DMA_IRQHandler() would clear them.
+ * 			static uint32_t coder1_captures[256];
+ * 			static Coder coder1;
+ * 			CoderInterface_Init(&coder1, &htim3, TIM_CHANNEL_1, coder1_captures, 256);
+ * 		encoder mode: the counter wraps at 0xFFFF (Period 65535, also on the 32
+ * 		bits TIM2 and TIM5), the timer interrupt is enabled in the NVIC and
+ * 		TIMx_IRQHandler calls CoderInterface_UpdateIRQ() before
+ * 		HAL_TIM_IRQHandler(), which would clear the update flag first
+ * 			CoderInterface_Init(&coder1, &htim4);
+ * 			void TIM4_IRQHandler(void) {
+ * 				CoderInterface_UpdateIRQ(&htim4);
+ * 				HAL_TIM_IRQHandler(&htim4);
+ * 			}
+ * 		in both modes CoderInterface_Run() is called from the main loop, more
+ * 		often than half the counter period in input capture.
+ ******************************************************************************
  */
 #ifndef __CODER_INTERFACE_H__
 #define __CODER_INTERFACE_H__
 
 #include "tim.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+//#define CODER_ENCODER_MODE		// quadrature encoder interface of the timer instead of input capture
+
+#define CODER_MAX_INSTANCES (4)
+
 // ------------------------------------------------------------------------
 // ----------------------------- PUBLIC TYPES -----------------------------
 // ------------------------------------------------------------------------
-TIM_HandleTypeDef* CoderInterface_GetTim();
-void CoderInterface_TimIRQ(TIM_HandleTypeDef *htim);
-void CoderInterface_TimeOut();
-float CoderInterface_GetSpeedRatio();
+typedef enum {
+	CODER_RESPONSE_FAST = 0,		// alpha 1/2, noisier
+	CODER_RESPONSE_MEDIUM,			// alpha 1/3 (default)
+	CODER_RESPONSE_SLOW,				// alpha 1/8, smoother
+	CODER_NB_RESPONSES,
+} CODER_RESPONSE;
+
+typedef struct {
+	int32_t  speed;		// Q16 turns per second
+	int32_t  slope;		// Q24 turns per second per tick (per ms in encoder mode)
+	uint32_t alpha;		// Q16
+	uint32_t beta;		// Q16
+	bool 		 ready;		// false until the first measure
+} Coder_Filter;
+
+typedef struct {
+	TIM_HandleTypeDef* htim;
+	uint8_t id;			// telemetry source, order of initialization
+	Coder_Filter filter;
+	volatile uint32_t speed_q16;		// turns per second
+#ifdef CODER_ENCODER_MODE
+	volatile int32_t position_high;		// counter overflows, in counts
+	int32_t  sample_position;
+	uint32_t sample_tick;
+	int8_t 	 direction;
+#else
+	uint32_t channel;								// TIM_CHANNEL_x
+	DMA_HandleTypeDef* hdma;				// of the channel
+	uint32_t* captures;							// ring written by the DMA
+	uint16_t nb_captures;
+	uint16_t read_index;
+	uint32_t last_capture;					// counter value
+	uint32_t counter_range;					// auto-reload + 1
+	uint32_t timeout_ms;						// half the counter period
+	uint32_t last_edge_ms;
+	bool 		 stopped;								// the next capture is only a reference
+	uint8_t  dma_pending;						// ring half / end crossed after the DMA flags were latched
+	uint32_t nb_laps;								// times the DMA went round the ring before the captures were read
+	uint32_t mt_edges;
+	uint32_t mt_ticks;
+	uint8_t  edges_per_capture;
+	uint8_t  next_divider;					// applied at the end of the batch
+#endif
+} Coder;
+
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
+#ifdef CODER_ENCODER_MODE
+bool CoderInterface_Init(Coder* coder, TIM_HandleTypeDef* htim);
+void CoderInterface_UpdateIRQ(TIM_HandleTypeDef *htim);
+int32_t CoderInterface_GetPosition(Coder* coder);
+int8_t CoderInterface_GetDirection(Coder* coder);
+#else
+bool CoderInterface_Init(Coder* coder, TIM_HandleTypeDef* htim, uint32_t channel, uint32_t* captures, uint16_t nb_captures);
+#endif
+void CoderInterface_Run(Coder* coder);
+uint32_t CoderInterface_GetSpeedRatioQ16(Coder* coder);
+float CoderInterface_GetSpeedRatio(Coder* coder);
+void CoderInterface_SetResponse(Coder* coder, CODER_RESPONSE response);
 
 #endif /* __CODER_INTERFACE_H__ */
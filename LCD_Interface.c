@@ -5,16 +5,43 @@
  *        Do things
  *
  * @creation 2024/04/24
- * @edition 2024/04/27
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @note asynchronous mode (LCD_ASYNC_MODE)
+ * each command is queued as two bytes, {flags, value}, in a SPSC buffer:
+ * the main loop produces, the timer interrupt consumes. LCD_Interface_Run()
+ * does one step per tick: set the nibble and raise EN, lower EN (the LCD
+ * latches), same for the low nibble, then wait for the execution time of the
+ * command. EN stays high for one tick, far above the 450 ns minimum.
+ *
+ * @note timer
+ * the tick stops the timer when it finds the queue empty with no command in
+ * progress. _Queue() starts it again after each put, interrupts masked: the
+ * tick either saw the new command or already stopped the timer.
+ *
  * @todo read busy flag
- * @todo switch to interrupt mode
  ******************************************************************************
  */
-#include "../ESW_Libraries/LCD_Interface.h"
+#include "LCD_Interface.h"
+
+#include <stddef.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#ifdef LCD_ASYNC_MODE
+#define _NIBBLE_ONLY 	(0x02)		// flag of the reset sequence commands, RS is bit 0
+
+#define _POWER_UP_US 	(50000)		// 40 ms min
+#define _NIBBLE_US 		(4100)		// reset sequence, the longest of its delays
+#define _CLEAR_US 		(1640)		// clear display and return home
+#define _COMMAND_US 	(40)			// any other instruction or data, 37 us min
+
+#define _TICKS(us) 		(((us) + LCD_TICK_US - 1) / LCD_TICK_US)
+#endif
 
 // ------------------------------------------------------------------------
 // ----------------------------- STATIC TYPES -----------------------------
@@ -24,27 +51,66 @@ typedef enum {
 	DATA = GPIO_PIN_SET,
 } register_select;
 
+#ifdef LCD_ASYNC_MODE
+typedef enum {
+	LCD_IDLE = 0,
+	LCD_HIGH_NIBBLE,		// EN high, high nibble (or the only one) on the bus
+	LCD_LOW_SETUP,
+	LCD_LOW_NIBBLE,			// EN high, low nibble on the bus
+	LCD_WAIT,
+} LCD_STATE;
+#endif
+
 // ------------------------------------------------------------------------
 // -------------------------- STATIC PROTOTYPES ---------------------------
 // ------------------------------------------------------------------------
 static LCD_data *s_LCD;
 
+#ifdef LCD_ASYNC_MODE
+static SPSC_RingBuffer s_queue;
+static uint8_t s_queue_storage[LCD_QUEUE_SIZE];
+static uint32_t s_dropped = 0;
+
+static volatile LCD_STATE s_state = LCD_IDLE;
+static uint8_t s_command[2];		// {flags, value} being sent
+static uint16_t s_wait_ticks = 0;
+static volatile bool s_running = false;		// timer started
+#endif
+
 // ------------------------------------------------------------------------
 // ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
 // ------------------------------------------------------------------------
 static void _SendByte(register_select RS, uint8_t data);
 static void _SendHalfByte(register_select RS, uint8_t data);
+static void _WriteHalfByte(register_select RS, uint8_t data);
 static void _SetPinState(GPIO gpio, GPIO_PinState PinState);
+#ifdef LCD_ASYNC_MODE
+static void _Queue(uint8_t flags, uint8_t data);
+static void _StartWait(uint32_t us);
+static void _StartTimer(void);
+#endif
 
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void LCD_Interface_Init(LCD_data *LCD) {
+/*
+ * False in asynchronous mode without LCD->htim, nothing is sent
+ */
+bool LCD_Interface_Init(LCD_data *LCD) {
+#ifdef LCD_ASYNC_MODE
+	if (LCD->htim == NULL) return false;
+#endif
 	s_LCD = LCD;
 	s_LCD->cursor_row = 0;
 	s_LCD->cursor_position = 0;
 
+#ifdef LCD_ASYNC_MODE
+	_StartWait(_POWER_UP_US);		// the timer steps do not read the queue while it is reset
+	SPSC_RingBuffer_Init(&s_queue, s_queue_storage, LCD_QUEUE_SIZE);
+	s_dropped = 0;
+#else
 	HAL_Delay(50);
+#endif
 	LCD_Interface_Reset();
 
 	_SendHalfByte(INSTRUCTION, 0b0010);	// 4-bit comm
@@ -53,6 +119,7 @@ void LCD_Interface_Init(LCD_data *LCD) {
 	LCD_Interface_SendInstruction(0b00000010);	// Return home
 	LCD_Interface_SendInstruction(0b00001100);	// Display ON/OFF: set display (on), cursor (off), cursor blink (off)
 	LCD_Interface_SendInstruction(0b00000110);	// Entry Mode Set: set the moving direction of cursor (right), display (no shift)
+	return true;
 }
 
 void LCD_Interface_Reset() {
@@ -115,15 +182,86 @@ void LCD_Interface_Shift(LCD_ELEMENT element, LCD_DIRECTION dir) {
 	_SendByte(INSTRUCTION, (0x10 | (element << 3) | (dir << 2)));
 }
 
+#ifdef LCD_ASYNC_MODE
+/*
+ * Timer interrupt every LCD_TICK_US: one step of the command being sent
+ */
+void LCD_Interface_Run() {
+	switch (s_state) {
+	case LCD_WAIT:
+		if (--s_wait_ticks) return;
+		s_state = LCD_IDLE;
+		// fall through
+	case LCD_IDLE:
+		if (SPSC_RingBuffer_GetSeveral(&s_queue, s_command, 2) != RB_OK) {
+			HAL_TIM_Base_Stop_IT(s_LCD->htim);		// drained, _Queue() restarts it
+			s_running = false;
+			return;
+		}
+		_WriteHalfByte(s_command[0] & DATA, (s_command[0] & _NIBBLE_ONLY) ? s_command[1] : s_command[1] >> 4);
+		_SetPinState(s_LCD->EN, GPIO_PIN_SET);
+		s_state = LCD_HIGH_NIBBLE;
+		break;
+
+	case LCD_HIGH_NIBBLE:
+		_SetPinState(s_LCD->EN, GPIO_PIN_RESET);
+		if (s_command[0] & _NIBBLE_ONLY) _StartWait(_NIBBLE_US);
+		else s_state = LCD_LOW_SETUP;
+		break;
+
+	case LCD_LOW_SETUP:
+		_WriteHalfByte(s_command[0] & DATA, s_command[1] & 0x0F);
+		_SetPinState(s_LCD->EN, GPIO_PIN_SET);
+		s_state = LCD_LOW_NIBBLE;
+		break;
+
+	case LCD_LOW_NIBBLE:
+		_SetPinState(s_LCD->EN, GPIO_PIN_RESET);
+		if ((s_command[0] & DATA) == INSTRUCTION && s_command[1] <= 0x03) _StartWait(_CLEAR_US);
+		else _StartWait(_COMMAND_US);
+		break;
+	}
+}
+
+uint32_t LCD_Interface_GetDropped() {
+	return s_dropped;
+}
+#else
+void LCD_Interface_Run() {
+	// every call already waited for the LCD
+}
+#endif
+
 // ------------------------------------------------------------------------
 // ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
 void _SendByte(register_select RS, uint8_t data) {
+#ifdef LCD_ASYNC_MODE
+	_Queue(RS, data);
+#else
 	_SendHalfByte(RS, data >> 4);
 	_SendHalfByte(RS, data & 0x0F);
+#endif
 }
 
 void _SendHalfByte(register_select RS, uint8_t data) {
+#ifdef LCD_ASYNC_MODE
+	_Queue(RS | _NIBBLE_ONLY, data);
+#else
+	_WriteHalfByte(RS, data);
+
+	HAL_Delay(1);
+	_SetPinState(s_LCD->EN, GPIO_PIN_SET);
+	HAL_Delay(1);
+	_SetPinState(s_LCD->EN, GPIO_PIN_RESET);
+	HAL_Delay(1);
+#endif
+}
+
+/*
+ * RS, RW and data lines, EN untouched
+ */
+void _WriteHalfByte(register_select RS, uint8_t data) {
 	_SetPinState(s_LCD->RS, RS);
 	_SetPinState(s_LCD->RW, GPIO_PIN_RESET);
 
@@ -131,16 +269,39 @@ void _SendHalfByte(register_select RS, uint8_t data) {
 	_SetPinState(s_LCD->D6, (data & (1 << 2)));
 	_SetPinState(s_LCD->D5, (data & (1 << 1)));
 	_SetPinState(s_LCD->D4, (data & (1 << 0)));
-
-	HAL_Delay(1);
-	_SetPinState(s_LCD->EN, GPIO_PIN_SET);
-	HAL_Delay(1);
-	_SetPinState(s_LCD->EN, GPIO_PIN_RESET);
-	HAL_Delay(1);
 }
 
 void _SetPinState(GPIO gpio, GPIO_PinState PinState) {
 	HAL_GPIO_WritePin(gpio.Port, gpio.Pin, PinState);
 }
 
+#ifdef LCD_ASYNC_MODE
+/*
+ * Main loop only, never waits: the command is dropped if the queue is full
+ */
+void _Queue(uint8_t flags, uint8_t data) {
+	uint8_t command[2] = {flags, data};
 
+	if (SPSC_RingBuffer_PutSeveral(&s_queue, command, 2) != RB_OK) s_dropped++;
+	_StartTimer();
+}
+
+void _StartWait(uint32_t us) {
+	s_wait_ticks = _TICKS(us);
+	s_state = LCD_WAIT;
+}
+
+/*
+ * Main loop, masked so that the tick cannot stop the timer in between
+ */
+void _StartTimer(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (!s_running) {
+		s_running = true;
+		HAL_TIM_Base_Start_IT(s_LCD->htim);
+	}
+	__set_PRIMASK(primask);
+}
+#endif
@@ -5,19 +5,43 @@
  *        Do things
  *
  * @creation 2024/04/24
- * @edition 2024/04/27
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @setup asynchronous mode: define LCD_ASYNC_MODE below and call
+ * 		LCD_Interface_Run() from a timer interrupt every LCD_TICK_US, e.g.
+ * 		the update of a basic timer at 20 kHz, given in LCD_data.htim and
+ * 		left stopped by the application
+ * 			LCD.htim = &htim6;
+ * 			LCD_Interface_Init(&LCD);		// false without htim
+ * 		The functions only queue their commands, Init() included, the timer
+ * 		sends them nibble by nibble with the HD44780 timings. It is started
+ * 		by the queued commands and stopped once the queue is drained, no
+ * 		interrupt runs while the LCD is idle. A 16x2 redraw takes about
+ * 		10 ms in the background. Commands which do not fit in the queue are
+ * 		dropped and counted by LCD_Interface_GetDropped().
+ * 		Without LCD_ASYNC_MODE every call waits for the LCD (HAL_Delay()).
+ ******************************************************************************
  */
 #ifndef __1602_INTERFACE_H__
 #define __1602_INTERFACE_H__
 
 #include "main.h"
+#include "SPSC_RingBuffer.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+//#define LCD_ASYNC_MODE		// timer driven command queue, no call waits
+
+#define LCD_TICK_US 		(50)		// period of the LCD_Interface_Run() calls
+#define LCD_QUEUE_SIZE 	(256)		// bytes, 2 per command, must be a power of two
+
 // ------------------------------------------------------------------------
 // ----------------------------- PUBLIC TYPES -----------------------------
 // ------------------------------------------------------------------------
@@ -41,6 +65,9 @@ typedef struct {
 		GPIO D6;
 		GPIO D5;
 		GPIO D4;
+#ifdef LCD_ASYNC_MODE
+		TIM_HandleTypeDef* htim;		// calls LCD_Interface_Run() on update
+#endif
 } LCD_data;
 
 typedef enum {
@@ -56,7 +83,7 @@ typedef enum {
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void LCD_Interface_Init(LCD_data *LCD);
+bool LCD_Interface_Init(LCD_data *LCD);
 void LCD_Interface_Reset();
 void LCD_Interface_Home();
 void LCD_Interface_SetCursorPos(uint8_t row, uint8_t col);
@@ -67,5 +94,8 @@ void LCD_Interface_PrintString(uint8_t *data, uint8_t len);
 void LCD_Interface_Shift(LCD_ELEMENT element, LCD_DIRECTION dir);
 void LCD_Interface_StorePattern(uint8_t CGRAM_addr, uint8_t *pattern);
 void LCD_Interface_Run();
+#ifdef LCD_ASYNC_MODE
+uint32_t LCD_Interface_GetDropped();
+#endif
 
 #endif /* __1602_INTERFACE_H__ */
@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ * @file Resampler.c
+ * @brief Resampler implementation file
+ *        Fixed-point linear interpolation sample rate converter
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * block processing: the caller asks how many input samples a block of output
+ * needs (Resampler_GetInputCount), decodes exactly that many, then calls
+ * Resampler_Process which consumes all of them.
+ ******************************************************************************
+ */
+#include "Resampler.h"
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Resampler_Init(Resampler* rs, uint32_t input_rate, uint32_t output_rate, uint16_t initial_value) {
+	Resampler_SetRate(rs, input_rate, output_rate);
+	rs->phase = 0;
+	rs->prev  = initial_value;
+	rs->next  = initial_value;
+}
+
+/*
+ * Change the ratio without breaking the interpolation (track change)
+ */
+void Resampler_SetRate(Resampler* rs, uint32_t input_rate, uint32_t output_rate) {
+	rs->step = (uint32_t)((((uint64_t)input_rate << 16) + output_rate / 2) / output_rate);
+}
+
+uint32_t Resampler_GetInputCount(const Resampler* rs, uint32_t nb_output) {
+	return (uint32_t)((rs->phase + (uint64_t)nb_output * rs->step) >> 16);
+}
+
+/*
+ * Largest number of output samples which consumes at most nb_input samples
+ */
+uint32_t Resampler_GetOutputCount(const Resampler* rs, uint32_t nb_input) {
+	return (uint32_t)(((((uint64_t)nb_input + 1) << 16) - 1 - rs->phase) / rs->step);
+}
+
+void Resampler_Process(Resampler* rs, const uint16_t* input, uint16_t* output, uint32_t nb_output) {
+	uint32_t phase = rs->phase;
+	int32_t  prev  = rs->prev;
+	int32_t  next  = rs->next;
+
+	for (uint32_t cpt = 0; cpt < nb_output; cpt++) {
+		output[cpt] = prev + (((next - prev) * (int32_t)(phase >> 1)) >> 15);
+
+		phase += rs->step;
+		while (phase >= RESAMPLER_ONE) {		// move to the input pair surrounding the next output
+			phase -= RESAMPLER_ONE;
+			prev = next;
+			next = *input++;
+		}
+	}
+
+	rs->phase = phase;
+	rs->prev  = prev;
+	rs->next  = next;
+}
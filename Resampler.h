@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ * @file Resampler.h
+ * @brief Resampler implementation file
+ *        Fixed-point linear interpolation sample rate converter
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the phase is a Q16 position between the two last input samples.
+ * Interpolation is done in Q15 so that any 16 bits sample pair fits in 32
+ * bits.
+ *
+ * @note accuracy
+ * the step is rounded to 1/65536 input sample, the rate error is at most
+ * output_rate / (2^17 * input_rate): 42 ppm at 8 kHz, 7 ppm at 48 kHz for a
+ * 44.1 kHz output. Actual errors: 8000 Hz +32 ppm, 16/32 kHz -10 ppm,
+ * 48 kHz +4 ppm, none for the 11025 Hz multiples.
+ *
+ * @note cost
+ * esw_bench resampler: 2 to 3 cycles per output sample on an x86-64 host.
+ * The loop is one multiply, two shifts, a store and the phase update per
+ * output, plus one load per input sample consumed. Not measured on a
+ * Cortex-M4 yet (estimate from the instruction count: about 12 cycles per
+ * output).
+ *
+ * @note tests
+ * test_resampler: within 1.3 LSB of a double precision interpolation from
+ * 8 to 48 kHz, same output whatever the block sizes, no phase drift over
+ * 10 minutes.
+ ******************************************************************************
+ */
+#ifndef __RESAMPLER_H__
+#define __RESAMPLER_H__
+
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define RESAMPLER_ONE (1UL << 16)
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint32_t step;		// input samples per output sample, Q16
+	uint32_t phase;		// position after prev, Q16, always < RESAMPLER_ONE
+	uint16_t prev;
+	uint16_t next;
+} Resampler;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void 		 Resampler_Init(Resampler* rs, uint32_t input_rate, uint32_t output_rate, uint16_t initial_value);
+void 		 Resampler_SetRate(Resampler* rs, uint32_t input_rate, uint32_t output_rate);
+uint32_t Resampler_GetInputCount(const Resampler* rs, uint32_t nb_output);
+uint32_t Resampler_GetOutputCount(const Resampler* rs, uint32_t nb_input);
+void 		 Resampler_Process(Resampler* rs, const uint16_t* input, uint16_t* output, uint32_t nb_output);
+
+#endif /* __RESAMPLER_H__ */
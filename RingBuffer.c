@@ -5,7 +5,7 @@
  *        Manage a ring buffer for communications
  *
  * @creation 2024/04/06
- * @edition 2024/04/07
+ * @edition 2026/10/17
  *
  * @author Guillaume Dauguen
  *
@@ -13,6 +13,8 @@
  */
 #include "RingBuffer.h"
 
+#include <string.h>
+
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
@@ -22,10 +24,18 @@ void RingBuffer_Init(RingBuffer* buf, uint8_t* raw_buf, uint32_t max_size) {
 	buf->ptr_write 	= 0;
 	buf->ptr_read 	= 0;
 	buf->buf 				= raw_buf;
+	RB_MONITOR_INIT(buf, max_size);
 	
-	for (uint32_t i = 0; i < buf->max_size; i++) {
-		buf->buf[i] = 0;
-	}
+	memset(buf->buf, 0, buf->max_size);
+}
+
+void RingBuffer_InitNoClear(RingBuffer* buf, uint8_t* raw_buf, uint32_t max_size) {
+	buf->size 			= 0;
+	buf->max_size 	= max_size;
+	buf->ptr_write 	= 0;
+	buf->ptr_read 	= 0;
+	buf->buf 				= raw_buf;
+	RB_MONITOR_INIT(buf, max_size);
 }
 
 uint32_t RingBuffer_GetSize(const RingBuffer* buf) {
@@ -45,53 +55,75 @@ uint8_t RingBuffer_IsNotEmpty(const RingBuffer* buf) {
 }
 
 RBRESULT RingBuffer_Put(RingBuffer* buf, const uint8_t byte) {
-	if (buf->size >= buf->max_size) 
+	if (buf->size >= buf->max_size) {
+		RB_MONITOR_OVERFLOW(buf);
 		return RB_BUFFER_FULL;
+	}
 	
 	buf->buf[buf->ptr_write] = byte;
 	buf->ptr_write++;
 	buf->ptr_write %= buf->max_size;
 	buf->size++;
+	RB_MONITOR_WRITE(buf, buf->size, 1);
 	
 	return RB_OK;
 }
 
 RBRESULT RingBuffer_PutSeveral(RingBuffer* buf, const uint8_t* data, const uint32_t length) {
-	if (length > RingBuffer_GetRemainingSize(buf)) 
+	if (length > RingBuffer_GetRemainingSize(buf)) {
+		RB_MONITOR_OVERFLOW(buf);
 		return RB_NOT_ENOUGH_SPACE;
-	
-	for (uint32_t cpt = 0; cpt < length; cpt++) {
-		buf->buf[buf->ptr_write++] = data[cpt];
-		if (buf->ptr_write >= buf->max_size)
-			buf->ptr_write = 0;
 	}
+	
+	uint32_t first = buf->max_size - buf->ptr_write;		// contiguous space before the wrap
+	if (first > length)
+		first = length;
+	
+	memcpy(&buf->buf[buf->ptr_write], data, first);
+	memcpy(buf->buf, &data[first], length - first);
+	
+	buf->ptr_write += length;
+	if (buf->ptr_write >= buf->max_size)
+		buf->ptr_write -= buf->max_size;
 	buf->size += length;
+	RB_MONITOR_WRITE(buf, buf->size, length);
 	
 	return RB_OK;
 }
 
 RBRESULT RingBuffer_Get(RingBuffer* buf, uint8_t* byte) {
-	if (buf->size == 0) 
+	if (buf->size == 0) {
+		RB_MONITOR_UNDERFLOW(buf);
 		return RB_BUFFER_EMPTY;
+	}
 	
 	*byte = buf->buf[buf->ptr_read];
 	buf->ptr_read++;
 	buf->ptr_read %= buf->max_size;
 	buf->size--;
+	RB_MONITOR_READ(buf, buf->size, 1);
 	
 	return RB_OK;
 }
 
 RBRESULT RingBuffer_GetSeveral(RingBuffer* buf, uint8_t* data, const uint32_t length) {
-	if (length > RingBuffer_GetSize(buf)) 
+	if (length > RingBuffer_GetSize(buf)) {
+		RB_MONITOR_UNDERFLOW(buf);
 		return RB_NOT_ENOUGH_DATA;
-	
-	for (uint32_t cpt = 0; cpt < length; cpt++) {
-		data[cpt] = buf->buf[buf->ptr_read++];
-		if (buf->ptr_read >= buf->max_size)
-			buf->ptr_read = 0;
 	}
+	
+	uint32_t first = buf->max_size - buf->ptr_read;		// contiguous data before the wrap
+	if (first > length)
+		first = length;
+	
+	memcpy(data, &buf->buf[buf->ptr_read], first);
+	memcpy(&data[first], buf->buf, length - first);
+	
+	buf->ptr_read += length;
+	if (buf->ptr_read >= buf->max_size)
+		buf->ptr_read -= buf->max_size;
 	buf->size -= length;
+	RB_MONITOR_READ(buf, buf->size, length);
 	
 	return RB_OK;
 }
@@ -101,14 +133,87 @@ RBRESULT RingBuffer_GetAll(RingBuffer* buf, uint8_t* data) {
 }
 
 RBRESULT RingBuffer_IgnoreSeveral(RingBuffer* buf, const uint32_t length) {
-	if (length > RingBuffer_GetSize(buf)) 
+	if (length > RingBuffer_GetSize(buf)) {
+		RB_MONITOR_UNDERFLOW(buf);
 		return RB_NOT_ENOUGH_DATA;
+	}
 
 	buf->ptr_read += length;
-	buf->ptr_read %= buf->max_size;
+	if (buf->ptr_read >= buf->max_size)
+		buf->ptr_read -= buf->max_size;
 	buf->size -= length;
+	RB_MONITOR_READ(buf, buf->size, length);
 	
 	return RB_OK;
 }
 
+/*
+ * Zero-copy access: Reserve/Peek give the largest contiguous span that can be
+ * written/read in place, Commit/Consume then publish/release the bytes used.
+ * A span never crosses the end of the storage, call again after the wrap.
+ */
+uint32_t RingBuffer_Reserve(RingBuffer* buf, uint8_t** data) {
+	uint32_t length = buf->max_size - buf->ptr_write;
+	uint32_t remaining_size = RingBuffer_GetRemainingSize(buf);
+	
+	*data = &buf->buf[buf->ptr_write];
+	return (length > remaining_size) ? remaining_size : length;
+}
+
+RBRESULT RingBuffer_Commit(RingBuffer* buf, const uint32_t length) {
+	if (length > RingBuffer_GetRemainingSize(buf) || length > buf->max_size - buf->ptr_write) {
+		RB_MONITOR_OVERFLOW(buf);
+		return RB_NOT_ENOUGH_SPACE;
+	}
+	
+	buf->ptr_write += length;
+	if (buf->ptr_write >= buf->max_size)
+		buf->ptr_write = 0;
+	buf->size += length;
+	RB_MONITOR_WRITE(buf, buf->size, length);
+	
+	return RB_OK;
+}
+
+uint32_t RingBuffer_Peek(const RingBuffer* buf, const uint8_t** data) {
+	uint32_t length = buf->max_size - buf->ptr_read;
+	
+	*data = &buf->buf[buf->ptr_read];
+	return (length > buf->size) ? buf->size : length;
+}
 
+RBRESULT RingBuffer_Consume(RingBuffer* buf, const uint32_t length) {
+	return RingBuffer_IgnoreSeveral(buf, length);
+}
+
+#ifdef RINGBUFFER_STATS
+void RingBuffer_GetStats(const RingBuffer* buf, RingBuffer_Stats* stats) {
+	*stats = buf->monitor.stats;
+}
+
+void RingBuffer_ResetStats(RingBuffer* buf) {
+	memset(&buf->monitor.stats, 0, sizeof(RingBuffer_Stats));
+	buf->monitor.stats.high_watermark = buf->size;
+	buf->monitor.stats.low_watermark = buf->size;
+}
+
+/*
+ * callback is called with RB_EVENT_HIGH when the fill rises to high_threshold
+ * and with RB_EVENT_LOW when it falls to low_threshold, NULL to stop
+ */
+void RingBuffer_SetThresholds(RingBuffer* buf, uint32_t low_threshold, uint32_t high_threshold, RingBuffer_Callback callback, void* context) {
+	buf->monitor.callback = NULL;		// never called with half set thresholds
+	buf->monitor.low_threshold = low_threshold;
+	buf->monitor.high_threshold = high_threshold;
+	buf->monitor.context = context;
+	buf->monitor.callback = callback;
+}
+
+/*
+ * Shared with SPSC_RingBuffer, no statistics nor threshold
+ */
+void RingBuffer_MonitorInit(RingBuffer_Monitor* monitor, uint32_t max_size) {
+	memset(monitor, 0, sizeof(RingBuffer_Monitor));
+	monitor->stats.low_watermark = max_size;
+}
+#endif
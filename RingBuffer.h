@@ -5,11 +5,20 @@
  *        Manage a ring buffer for communications
  *
  * @creation 2024/04/06
- * @edition 2024/04/10
+ * @edition 2026/10/17
  *
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @note statistics
+ * with RINGBUFFER_STATS defined, every RingBuffer and SPSC_RingBuffer keeps
+ * its fill watermarks, rejected accesses and byte counts, and can call back
+ * when its fill crosses a threshold: RB_EVENT_HIGH when it rises to
+ * high_threshold (wake the consumer), RB_EVENT_LOW when it falls to
+ * low_threshold (wake the producer). The callback runs in the context of the
+ * access, keep it short. On an SPSC buffer the producer only updates the
+ * write side and the consumer the read side.
+ ******************************************************************************
  */
  
 /* Define to prevent recursive inclusion ---------------------------------*/
@@ -18,15 +27,63 @@
 
 #include <stdint.h>
 
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+//#define RINGBUFFER_STATS		// fill statistics and threshold callback on every ring buffer
+
+#ifdef RINGBUFFER_STATS
+#define RB_MONITOR_INIT(buf, max_size) 		 RingBuffer_MonitorInit(&(buf)->monitor, (max_size))
+#define RB_MONITOR_WRITE(buf, size, length) RingBuffer_MonitorWrite(&(buf)->monitor, (size), (length))
+#define RB_MONITOR_READ(buf, size, length) 	RingBuffer_MonitorRead(&(buf)->monitor, (size), (length))
+#define RB_MONITOR_OVERFLOW(buf) 						((buf)->monitor.stats.overflows++)
+#define RB_MONITOR_UNDERFLOW(buf) 					((buf)->monitor.stats.underflows++)
+#else
+#define RB_MONITOR_INIT(buf, max_size) 		 ((void)0)
+#define RB_MONITOR_WRITE(buf, size, length) ((void)0)
+#define RB_MONITOR_READ(buf, size, length) 	((void)0)
+#define RB_MONITOR_OVERFLOW(buf) 						((void)0)
+#define RB_MONITOR_UNDERFLOW(buf) 					((void)0)
+#endif
+
 // ------------------------------------------------------------------------
 // ----------------------------- PUBLIC TYPES -----------------------------
 // ------------------------------------------------------------------------
+#ifdef RINGBUFFER_STATS
+typedef enum {
+	RB_EVENT_LOW = 0,		// fill fell to low_threshold
+	RB_EVENT_HIGH,			// fill rose to high_threshold
+} RB_EVENT;
+
+typedef void (*RingBuffer_Callback)(RB_EVENT event, void* context);
+
+typedef struct {
+	uint32_t high_watermark;		// highest fill after a write
+	uint32_t low_watermark;			// lowest fill after a read, max_size before the first one
+	uint32_t overflows;					// writes rejected or cut for lack of space
+	uint32_t underflows;				// reads rejected for lack of data
+	uint32_t bytes_in;
+	uint32_t bytes_out;
+} RingBuffer_Stats;
+
+typedef struct {
+	RingBuffer_Stats stats;
+	uint32_t low_threshold;
+	uint32_t high_threshold;
+	RingBuffer_Callback callback;		// NULL when no threshold is set
+	void* context;
+} RingBuffer_Monitor;
+#endif
+
 typedef struct {
 	uint32_t size;
 	uint32_t max_size;
 	uint32_t ptr_read;
 	uint32_t ptr_write;
 	uint8_t* buf;
+#ifdef RINGBUFFER_STATS
+	RingBuffer_Monitor monitor;
+#endif
 } RingBuffer;
 
 typedef enum {
@@ -35,12 +92,14 @@ typedef enum {
 	RB_NOT_ENOUGH_SPACE,
 	RB_NOT_ENOUGH_DATA,
 	RB_BUFFER_EMPTY,
+	RB_INVALID_SIZE,
 } RBRESULT;
 
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
 void 		 RingBuffer_Init(RingBuffer* buf, uint8_t* raw_buf, uint32_t max_size);
+void 		 RingBuffer_InitNoClear(RingBuffer* buf, uint8_t* raw_buf, uint32_t max_size);
 uint32_t RingBuffer_GetSize(const RingBuffer* buf);
 uint32_t RingBuffer_GetRemainingSize(const RingBuffer* buf);
 uint8_t  RingBuffer_IsEmpty(const RingBuffer* buf);
@@ -51,5 +110,37 @@ RBRESULT RingBuffer_Get(RingBuffer* buf, uint8_t* byte);
 RBRESULT RingBuffer_GetSeveral(RingBuffer* buf, uint8_t* data, const uint32_t length);
 RBRESULT RingBuffer_GetAll(RingBuffer* buf, uint8_t* data);
 RBRESULT RingBuffer_IgnoreSeveral(RingBuffer* buf, const uint32_t length);
+uint32_t RingBuffer_Reserve(RingBuffer* buf, uint8_t** data);
+RBRESULT RingBuffer_Commit(RingBuffer* buf, const uint32_t length);
+uint32_t RingBuffer_Peek(const RingBuffer* buf, const uint8_t** data);
+RBRESULT RingBuffer_Consume(RingBuffer* buf, const uint32_t length);
+
+#ifdef RINGBUFFER_STATS
+void RingBuffer_GetStats(const RingBuffer* buf, RingBuffer_Stats* stats);
+void RingBuffer_ResetStats(RingBuffer* buf);
+void RingBuffer_SetThresholds(RingBuffer* buf, uint32_t low_threshold, uint32_t high_threshold, RingBuffer_Callback callback, void* context);
+void RingBuffer_MonitorInit(RingBuffer_Monitor* monitor, uint32_t max_size);
+
+/*
+ * Shared with SPSC_RingBuffer, inlined in every access.
+ * size is the fill after the access of length bytes
+ */
+
+static inline void RingBuffer_MonitorWrite(RingBuffer_Monitor* monitor, uint32_t size, uint32_t length) {
+	monitor->stats.bytes_in += length;
+	if (size > monitor->stats.high_watermark) monitor->stats.high_watermark = size;
+	if (monitor->callback && size >= monitor->high_threshold && size - length < monitor->high_threshold) {
+		monitor->callback(RB_EVENT_HIGH, monitor->context);
+	}
+}
+
+static inline void RingBuffer_MonitorRead(RingBuffer_Monitor* monitor, uint32_t size, uint32_t length) {
+	monitor->stats.bytes_out += length;
+	if (size < monitor->stats.low_watermark) monitor->stats.low_watermark = size;
+	if (monitor->callback && size <= monitor->low_threshold && size + length > monitor->low_threshold) {
+		monitor->callback(RB_EVENT_LOW, monitor->context);
+	}
+}
+#endif
 
 #endif /* __RING_BUFFER_H__ */
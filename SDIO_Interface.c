@@ -5,28 +5,73 @@
  *        Manage communication with SD card
  *
  * @creation 2024/04/06
- * @edition 2024/04/11
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @note read-ahead
+ * reads at a sector aligned file offset into a word aligned buffer go
+ * straight to FatFs by whole sectors, which it reads with multi-block
+ * commands up to each cluster end. The rest goes through a word aligned
+ * buffer, refilled with whole chunks at chunk aligned file offsets (sector
+ * and cluster aligned, as a file starts on a cluster) instead of the one
+ * sector window of FatFs. The chunk is one cluster, limited to
+ * SDIO_READ_AHEAD_SIZE. Callers streaming a file should read up to chunk
+ * boundaries, see WAV_Decoder.c.
+ *
+ * @note card latency
+ * stalls of the card are reproduced on the host, with a FAT image and a
+ * latency model behind f_read (host_fat.h, esw_sd_latency).
+ ******************************************************************************
  */
 #include "SDIO_Interface.h"
 #include "Shell.h"
 
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define SDIO_SECTOR_SIZE 			(512)
+#define SDIO_READ_AHEAD_SIZE 	(4096)		// per file, power of two multiple of SDIO_SECTOR_SIZE
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint32_t data[SDIO_READ_AHEAD_SIZE / sizeof(uint32_t)];		// word aligned for the SDIO DMA
+	uint32_t offset;			// file offset of data[0]
+	uint32_t length;			// valid bytes in data
+	uint32_t position;		// file offset of the next byte returned
+} SDIO_ReadAhead;
+
 // ------------------------------------------------------------------------
 // -------------------------- STATIC PROTOTYPES ---------------------------
 // ------------------------------------------------------------------------
 static FATFS fs;				// file system
-static FIL fil;					// file
+static FIL fil[SDIO_NB_FILES];		// files, several can be open at once (gapless playback)
 static FILINFO fno;
 static UINT br, bw;			// file read / write count
 
+static SDIO_ReadAhead s_read_ahead[SDIO_NB_FILES];
+static uint32_t s_chunk_size = SDIO_SECTOR_SIZE;
+static SDIO_Stats s_stats;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static FRESULT _ReadSD(SDIO_FILE file, uint32_t offset, uint8_t* buf, uint32_t length);
+
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
 FRESULT SDIO_Interface_MountSD() {
-	return f_mount(&fs, "/", 1);
+	FRESULT fresult = f_mount(&fs, "/", 1);
+	
+	if (fresult == FR_OK) {		// read-ahead chunk: one cluster, as much as the buffer allows
+		uint32_t cluster_size = fs.csize * SDIO_SECTOR_SIZE;
+		s_chunk_size = (cluster_size < SDIO_READ_AHEAD_SIZE) ? cluster_size : SDIO_READ_AHEAD_SIZE;
+	}
+	return fresult;
 	/*if (fresult != FR_OK) Shell_PrintString("error in mounting SD CARD...\r\n ");
 	else Shell_PrintString("SD CARD mounted successfully...\r\n ");*/
 }
@@ -39,13 +84,13 @@ FRESULT SDIO_Interface_UnmountSD() {
 
 /* Start node to be scanned (***also used as work area***) */
 FRESULT SDIO_Interface_ScanFiles(char* pat) {
-	char result_string[128];
 	FRESULT fresult;
 	DIR dir;
 	UINT i;
 
 	char path[20];
-	sprintf(path, "%s", pat);
+	strncpy(path, pat, sizeof(path) - 1);
+	path[sizeof(path) - 1] = 0;
 
 	fresult = f_opendir(&dir, path);												/* Open the directory */
 	if (fresult == FR_OK) {
@@ -54,17 +99,17 @@ FRESULT SDIO_Interface_ScanFiles(char* pat) {
 			if (fresult != FR_OK || fno.fname[0] == 0) break;		/* Break on error or end of dir */
 			if (fno.fattrib & AM_DIR) {													/* It is a directory */
 				if (!(strcmp ("SYSTEM~1", fno.fname))) continue;
-				sprintf(result_string, "Dir: %s", fno.fname);
-				Shell_PrintString(result_string);
+				Shell_Printf(Shell_GetConsole(), "Dir: %s", fno.fname);
 				i = strlen(path);
-				sprintf(&path[i], "/%s", fno.fname);
+				if (i + 1 + strlen(fno.fname) >= sizeof(path)) continue;		// too deep for the path buffer
+				path[i] = '/';
+				strcpy(&path[i + 1], fno.fname);
 				fresult = SDIO_Interface_ScanFiles(path);												/* Enter the directory */
 				if (fresult != FR_OK) break;
 				path[i] = 0;
 			}
 			else {																							/* It is a file. */
-				 sprintf(result_string, "File: %s/%s\r\n ", path, fno.fname);
-				 Shell_PrintString(result_string);
+				 Shell_Printf(Shell_GetConsole(), "File: %s/%s\r\n ", path, fno.fname);
 			}
 		}
 		f_closedir(&dir);
@@ -72,7 +117,7 @@ FRESULT SDIO_Interface_ScanFiles(char* pat) {
 	return fresult;
 }
 
-FRESULT SDIO_Interface_OpenFile(char* name) {
+FRESULT SDIO_Interface_OpenFile(SDIO_FILE file, char* name) {
 	FRESULT fresult;
 	
 	/**** check whether the file exists or not ****/
@@ -81,24 +126,83 @@ FRESULT SDIO_Interface_OpenFile(char* name) {
 		return fresult;					//"*%s* does not exists\n", name
 	}
 	/* Open file to read */
-	return f_open(&fil, name, FA_READ);
+	s_read_ahead[file].offset   = 0;
+	s_read_ahead[file].length   = 0;
+	s_read_ahead[file].position = 0;
+	return f_open(&fil[file], name, FA_READ);
 	//	if (fresult != FR_OK)
 	//		"error no %d in opening file\n", fresult
 }
 
-FRESULT SDIO_Interface_CloseFile() {
-	return f_close(&fil);
+FRESULT SDIO_Interface_CloseFile(SDIO_FILE file) {
+	return f_close(&fil[file]);
 //	if (fresult != FR_OK)
 //		"error no %d in closing file\n", fresult
 }
 
 
-FRESULT SDIO_Interface_ReadFile(uint8_t* buf, uint32_t length) {
-	return f_read(&fil, buf, length, &br);
+FRESULT SDIO_Interface_SeekFile(SDIO_FILE file, uint32_t offset) {
+	if (offset > f_size(&fil[file]))
+		return FR_INVALID_PARAMETER;
+	
+	s_read_ahead[file].position = offset;		// the SD is only accessed by the next read outside the buffer
+	return FR_OK;
+}
+
+uint32_t SDIO_Interface_GetFileSize(SDIO_FILE file) {
+	return f_size(&fil[file]);
+}
+
+FRESULT SDIO_Interface_ReadFile(SDIO_FILE file, uint8_t* buf, uint32_t length) {
+	SDIO_ReadAhead* read_ahead = &s_read_ahead[file];
+	
+	while (length) {
+		uint32_t position = read_ahead->position;
+		
+		if (position >= read_ahead->offset && position < read_ahead->offset + read_ahead->length) {
+			uint32_t available = read_ahead->offset + read_ahead->length - position;
+			uint32_t to_copy = (length > available) ? available : length;
+			
+			memcpy(buf, (uint8_t*) read_ahead->data + (position - read_ahead->offset), to_copy);
+			buf += to_copy;
+			length -= to_copy;
+			read_ahead->position += to_copy;
+			s_stats.bytes_delivered += to_copy;
+			s_stats.bytes_copied += to_copy;
+			continue;
+		}
+		
+		if ((position & (SDIO_SECTOR_SIZE - 1)) == 0 && length >= SDIO_SECTOR_SIZE && ((uintptr_t) buf & 3) == 0) {	// whole aligned sectors, no copy
+			uint32_t to_read = length & ~(SDIO_SECTOR_SIZE - 1);
+			
+			FRESULT fresult = _ReadSD(file, position, buf, to_read);
+			if (fresult != FR_OK || br == 0) return fresult;
+			buf += br;
+			length -= br;
+			read_ahead->position += br;
+			s_stats.bytes_delivered += br;
+			continue;
+		}
+		
+		read_ahead->offset = position & ~(s_chunk_size - 1);
+		read_ahead->length = 0;
+		FRESULT fresult = _ReadSD(file, read_ahead->offset, (uint8_t*) read_ahead->data, s_chunk_size);
+		if (fresult != FR_OK || br == 0) return fresult;		// error or end of file
+		read_ahead->length = br;
+	}
+	return FR_OK;
 //	if (fresult != FR_OK)
 //		"error no %d in reading file\n", fresult
 }
 
+void SDIO_Interface_GetStats(SDIO_Stats* stats) {
+	*stats = s_stats;
+}
+
+void SDIO_Interface_ResetStats() {
+	memset(&s_stats, 0, sizeof(s_stats));
+}
+
 FRESULT SDIO_Interface_CheckSD(uint32_t* total, uint32_t* free_space) {
 	/**** capacity related *****/
 	FATFS* pfs;
@@ -119,7 +223,6 @@ FRESULT SDIO_Interface_CheckSD(uint32_t* total, uint32_t* free_space) {
 }
 
 FRESULT SDIO_Interface_CheckFile(char* name) {
-	char result_string[128];
 	FRESULT fresult;
 	
 	fresult = f_stat(name, &fno);
@@ -132,21 +235,43 @@ FRESULT SDIO_Interface_CheckFile(char* name) {
 			"An error occurred. (%d)\r\n "
 		*/
 	}
-	sprintf(result_string, "Below are the details of the *%s* \nSize: %lu\r\n ",name, fno.fsize);
-	Shell_PrintString(result_string);
-	sprintf(result_string, "Timestamp: %u/%02u/%02u, %02u:%02u\r\n " ,
+	Shell_Printf(Shell_GetConsole(), "Below are the details of the *%s* \nSize: %u\r\n ", name, (uint32_t) fno.fsize);
+	Shell_Printf(Shell_GetConsole(), "Timestamp: %u/%02u/%02u, %02u:%02u\r\n " ,
 				 (fno.fdate >> 9) + 1980, fno.fdate >> 5 & 15, fno.fdate & 31,
 				 fno.ftime >> 11, fno.ftime >> 5 & 63);
-	Shell_PrintString(result_string);
-	sprintf(result_string, "Attributes: %c%c%c%c%c\r\n ",
+	Shell_Printf(Shell_GetConsole(), "Attributes: %c%c%c%c%c\r\n ",
 				 (fno.fattrib & AM_DIR) ? 'D' : '-',
 				 (fno.fattrib & AM_RDO) ? 'R' : '-',
 				 (fno.fattrib & AM_HID) ? 'H' : '-',
 				 (fno.fattrib & AM_SYS) ? 'S' : '-',
 				 (fno.fattrib & AM_ARC) ? 'A' : '-');
-	Shell_PrintString(result_string);
 	
 	return FR_OK;
 }
 
-
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+FRESULT _ReadSD(SDIO_FILE file, uint32_t offset, uint8_t* buf, uint32_t length) {
+	FRESULT fresult = FR_OK;
+	uint32_t start = HAL_GetTick();
+	
+	if (f_tell(&fil[file]) != offset) {
+		fresult = f_lseek(&fil[file], offset);		// follows the cluster chain, no data is read
+	}
+	if (fresult == FR_OK) {
+		fresult = f_read(&fil[file], buf, length, &br);
+	}
+	if (fresult != FR_OK) {
+		br = 0;
+		return fresult;
+	}
+	
+	s_stats.sd_reads++;
+	s_stats.sd_bytes += br;
+	s_stats.sd_time_ms += HAL_GetTick() - start;
+	if ((offset & (SDIO_SECTOR_SIZE - 1)) == 0 && br >= 2 * SDIO_SECTOR_SIZE) {
+		s_stats.multi_sector_reads++;
+	}
+	return FR_OK;
+}
@@ -5,7 +5,7 @@
  *        Manage communication with SD card
  *
  * @creation 2024/04/06
- * @edition 2024/04/11
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
@@ -18,16 +18,38 @@
 #include "string.h"
 #include "stdio.h"
 
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef enum {
+	SDIO_FILE_0 = 0,
+	SDIO_FILE_1,
+	SDIO_NB_FILES,
+} SDIO_FILE;
+
+typedef struct {
+	uint32_t bytes_delivered;			// bytes returned by SDIO_Interface_ReadFile()
+	uint32_t bytes_copied;				// part of bytes_delivered which went through the read-ahead buffer
+	uint32_t sd_bytes;						// bytes read from the card
+	uint32_t sd_reads;						// f_read calls
+	uint32_t multi_sector_reads;	// f_read calls sector aligned and of at least two sectors
+	uint32_t sd_time_ms;					// time spent in f_read/f_lseek, throughput = sd_bytes / sd_time_ms
+} SDIO_Stats;
+
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
 FRESULT SDIO_Interface_MountSD();
 FRESULT SDIO_Interface_UnmountSD();
 FRESULT SDIO_Interface_ScanFiles(char* pat);
-FRESULT SDIO_Interface_OpenFile(char* name);
-FRESULT SDIO_Interface_ReadFile(uint8_t* buf, uint32_t );
-FRESULT SDIO_Interface_CloseFile();
+FRESULT SDIO_Interface_OpenFile(SDIO_FILE file, char* name);
+FRESULT SDIO_Interface_ReadFile(SDIO_FILE file, uint8_t* buf, uint32_t length);
+FRESULT SDIO_Interface_CloseFile(SDIO_FILE file);
+FRESULT SDIO_Interface_SeekFile(SDIO_FILE file, uint32_t offset);
+uint32_t SDIO_Interface_GetFileSize(SDIO_FILE file);
 FRESULT SDIO_Interface_CheckSD(uint32_t* total, uint32_t* free_space);
 FRESULT SDIO_Interface_CheckFile(char* name);
+void    SDIO_Interface_GetStats(SDIO_Stats* stats);
+void    SDIO_Interface_ResetStats();
 
 #endif /* __SDIO_INTERFACE_H__ */
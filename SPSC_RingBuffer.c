@@ -0,0 +1,255 @@
+/**
+ ******************************************************************************
+ * @file SPSC_RingBuffer.c
+ * @brief Lock-free ring buffer implementation file
+ *        Single producer / single consumer ring buffer, safe to share between
+ *        an ISR and the main loop without critical sections
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * head and tail are free running counters, head - tail is the fill level even
+ * after they wrap around 2^32. The producer only writes head, the consumer
+ * only writes tail, so there is no shared read-modify-write.
+ ******************************************************************************
+ */
+#include "SPSC_RingBuffer.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+// data accesses must be complete before the index publishing them is seen
+#if defined(__GNUC__) || defined(__clang__)
+#define _MEMORY_BARRIER() __sync_synchronize()
+#else
+#define _MEMORY_BARRIER() __dmb(0xF)
+#endif
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+RBRESULT SPSC_RingBuffer_Init(SPSC_RingBuffer* buf, uint8_t* raw_buf, uint32_t max_size) {
+	if (max_size == 0 || (max_size & (max_size - 1)))
+		return RB_INVALID_SIZE;
+
+	buf->head = 0;
+	buf->tail = 0;
+	buf->mask = max_size - 1;
+	buf->buf  = raw_buf;
+	RB_MONITOR_INIT(buf, max_size);
+
+	return RB_OK;
+}
+
+uint32_t SPSC_RingBuffer_GetSize(const SPSC_RingBuffer* buf) {
+	return buf->head - buf->tail;
+}
+
+uint32_t SPSC_RingBuffer_GetRemainingSize(const SPSC_RingBuffer* buf) {
+	return buf->mask + 1 - (buf->head - buf->tail);
+}
+
+uint8_t SPSC_RingBuffer_IsEmpty(const SPSC_RingBuffer* buf) {
+	return buf->head == buf->tail;
+}
+
+uint8_t SPSC_RingBuffer_IsNotEmpty(const SPSC_RingBuffer* buf) {
+	return buf->head != buf->tail;
+}
+
+RBRESULT SPSC_RingBuffer_Put(SPSC_RingBuffer* buf, const uint8_t byte) {
+	uint32_t head = buf->head;
+
+	if (head - buf->tail > buf->mask) {
+		RB_MONITOR_OVERFLOW(buf);
+		return RB_BUFFER_FULL;
+	}
+	_MEMORY_BARRIER();		// consumer must be done with the slot before it is overwritten
+
+	buf->buf[head & buf->mask] = byte;
+	_MEMORY_BARRIER();
+	buf->head = head + 1;
+	RB_MONITOR_WRITE(buf, head + 1 - buf->tail, 1);
+
+	return RB_OK;
+}
+
+RBRESULT SPSC_RingBuffer_PutSeveral(SPSC_RingBuffer* buf, const uint8_t* data, const uint32_t length) {
+	uint32_t head = buf->head;
+
+	if (length > buf->mask + 1 - (head - buf->tail)) {
+		RB_MONITOR_OVERFLOW(buf);
+		return RB_NOT_ENOUGH_SPACE;
+	}
+	_MEMORY_BARRIER();
+
+	uint32_t index = head & buf->mask;
+	uint32_t first = buf->mask + 1 - index;		// contiguous space before the wrap
+	if (first > length)
+		first = length;
+
+	memcpy(&buf->buf[index], data, first);
+	memcpy(buf->buf, &data[first], length - first);
+	_MEMORY_BARRIER();
+	buf->head = head + length;
+	RB_MONITOR_WRITE(buf, head + length - buf->tail, length);
+
+	return RB_OK;
+}
+
+/*
+ * Publish length bytes already written in the storage from index head & mask
+ * (by a DMA for instance). Only the free space is published if length exceeds
+ * it, the rest can be published by a later call once the consumer caught up.
+ */
+RBRESULT SPSC_RingBuffer_Commit(SPSC_RingBuffer* buf, const uint32_t length) {
+	uint32_t head = buf->head;
+	uint32_t free_space = buf->mask + 1 - (head - buf->tail);
+	RBRESULT result = RB_OK;
+	uint32_t published = length;
+
+	if (published > free_space) {
+		published = free_space;
+		result = RB_NOT_ENOUGH_SPACE;
+		RB_MONITOR_OVERFLOW(buf);
+	}
+	_MEMORY_BARRIER();
+	buf->head = head + published;
+	RB_MONITOR_WRITE(buf, head + published - buf->tail, published);
+
+	return result;
+}
+
+RBRESULT SPSC_RingBuffer_Get(SPSC_RingBuffer* buf, uint8_t* byte) {
+	uint32_t tail = buf->tail;
+
+	if (buf->head == tail) {
+		RB_MONITOR_UNDERFLOW(buf);
+		return RB_BUFFER_EMPTY;
+	}
+	_MEMORY_BARRIER();		// data must not be read before the head publishing it
+
+	*byte = buf->buf[tail & buf->mask];
+	_MEMORY_BARRIER();
+	buf->tail = tail + 1;
+	RB_MONITOR_READ(buf, buf->head - (tail + 1), 1);
+
+	return RB_OK;
+}
+
+RBRESULT SPSC_RingBuffer_GetSeveral(SPSC_RingBuffer* buf, uint8_t* data, const uint32_t length) {
+	uint32_t tail = buf->tail;
+
+	if (length > buf->head - tail) {
+		RB_MONITOR_UNDERFLOW(buf);
+		return RB_NOT_ENOUGH_DATA;
+	}
+	_MEMORY_BARRIER();
+
+	uint32_t index = tail & buf->mask;
+	uint32_t first = buf->mask + 1 - index;		// contiguous data before the wrap
+	if (first > length)
+		first = length;
+
+	memcpy(data, &buf->buf[index], first);
+	memcpy(&data[first], buf->buf, length - first);
+	_MEMORY_BARRIER();
+	buf->tail = tail + length;
+	RB_MONITOR_READ(buf, buf->head - (tail + length), length);
+
+	return RB_OK;
+}
+
+RBRESULT SPSC_RingBuffer_IgnoreSeveral(SPSC_RingBuffer* buf, const uint32_t length) {
+	uint32_t tail = buf->tail;
+
+	if (length > buf->head - tail) {
+		RB_MONITOR_UNDERFLOW(buf);
+		return RB_NOT_ENOUGH_DATA;
+	}
+
+	buf->tail = tail + length;
+	RB_MONITOR_READ(buf, buf->head - (tail + length), length);
+
+	return RB_OK;
+}
+
+/*
+ * Zero-copy access, same as RingBuffer_Reserve/Peek: the largest contiguous
+ * span that can be written (producer) or read (consumer) in place.
+ * SPSC_RingBuffer_Commit/Consume then publish/release the bytes used.
+ */
+uint32_t SPSC_RingBuffer_Reserve(const SPSC_RingBuffer* buf, uint8_t** data) {
+	uint32_t head = buf->head;
+	uint32_t index = head & buf->mask;
+	uint32_t length = buf->mask + 1 - index;
+	uint32_t free_space = buf->mask + 1 - (head - buf->tail);
+
+	*data = &buf->buf[index];
+	return (length > free_space) ? free_space : length;
+}
+
+uint32_t SPSC_RingBuffer_Peek(const SPSC_RingBuffer* buf, const uint8_t** data) {
+	uint32_t tail = buf->tail;
+	uint32_t index = tail & buf->mask;
+	uint32_t length = buf->mask + 1 - index;
+	uint32_t size = buf->head - tail;
+	_MEMORY_BARRIER();		// data must not be read before the head publishing it
+
+	*data = &buf->buf[index];
+	return (length > size) ? size : length;
+}
+
+RBRESULT SPSC_RingBuffer_Consume(SPSC_RingBuffer* buf, const uint32_t length) {
+	uint32_t tail = buf->tail;
+
+	if (length > buf->head - tail) {
+		RB_MONITOR_UNDERFLOW(buf);
+		return RB_NOT_ENOUGH_DATA;
+	}
+	_MEMORY_BARRIER();		// reads in place must be complete before the slots are released
+
+	buf->tail = tail + length;
+	RB_MONITOR_READ(buf, buf->head - (tail + length), length);
+
+	return RB_OK;
+}
+
+#ifdef RINGBUFFER_STATS
+/*
+ * Counters of both sides, each one may be a few accesses behind the other
+ */
+void SPSC_RingBuffer_GetStats(const SPSC_RingBuffer* buf, RingBuffer_Stats* stats) {
+	*stats = buf->monitor.stats;
+}
+
+/*
+ * Call with both sides stopped, or accept a few lost updates
+ */
+void SPSC_RingBuffer_ResetStats(SPSC_RingBuffer* buf) {
+	uint32_t size = SPSC_RingBuffer_GetSize(buf);
+
+	memset(&buf->monitor.stats, 0, sizeof(RingBuffer_Stats));
+	buf->monitor.stats.high_watermark = size;
+	buf->monitor.stats.low_watermark = size;
+}
+
+/*
+ * RB_EVENT_HIGH is called by the producer, RB_EVENT_LOW by the consumer
+ */
+void SPSC_RingBuffer_SetThresholds(SPSC_RingBuffer* buf, uint32_t low_threshold, uint32_t high_threshold, RingBuffer_Callback callback, void* context) {
+	buf->monitor.callback = NULL;		// never called with half set thresholds
+	_MEMORY_BARRIER();
+	buf->monitor.low_threshold = low_threshold;
+	buf->monitor.high_threshold = high_threshold;
+	buf->monitor.context = context;
+	_MEMORY_BARRIER();
+	buf->monitor.callback = callback;
+}
+#endif
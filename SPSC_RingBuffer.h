@@ -0,0 +1,63 @@
+/**
+ ******************************************************************************
+ * @file SPSC_RingBuffer.h
+ * @brief Lock-free ring buffer implementation file
+ *        Single producer / single consumer ring buffer, safe to share between
+ *        an ISR and the main loop without critical sections
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @caution
+ * max_size must be a power of two
+ * only one context may call the Put functions, only one the Get functions
+ ******************************************************************************
+ */
+#ifndef __SPSC_RING_BUFFER_H__
+#define __SPSC_RING_BUFFER_H__
+
+#include "RingBuffer.h"
+
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	volatile uint32_t head;		// free running write index, only written by the producer
+	volatile uint32_t tail;		// free running read index, only written by the consumer
+	uint32_t mask;
+	uint8_t* buf;
+#ifdef RINGBUFFER_STATS
+	RingBuffer_Monitor monitor;		// see RingBuffer.h
+#endif
+} SPSC_RingBuffer;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+RBRESULT SPSC_RingBuffer_Init(SPSC_RingBuffer* buf, uint8_t* raw_buf, uint32_t max_size);
+uint32_t SPSC_RingBuffer_GetSize(const SPSC_RingBuffer* buf);
+uint32_t SPSC_RingBuffer_GetRemainingSize(const SPSC_RingBuffer* buf);
+uint8_t  SPSC_RingBuffer_IsEmpty(const SPSC_RingBuffer* buf);
+uint8_t  SPSC_RingBuffer_IsNotEmpty(const SPSC_RingBuffer* buf);
+RBRESULT SPSC_RingBuffer_Put(SPSC_RingBuffer* buf, const uint8_t byte);
+RBRESULT SPSC_RingBuffer_PutSeveral(SPSC_RingBuffer* buf, const uint8_t* data, const uint32_t length);
+RBRESULT SPSC_RingBuffer_Commit(SPSC_RingBuffer* buf, const uint32_t length);
+RBRESULT SPSC_RingBuffer_Get(SPSC_RingBuffer* buf, uint8_t* byte);
+RBRESULT SPSC_RingBuffer_GetSeveral(SPSC_RingBuffer* buf, uint8_t* data, const uint32_t length);
+RBRESULT SPSC_RingBuffer_IgnoreSeveral(SPSC_RingBuffer* buf, const uint32_t length);
+uint32_t SPSC_RingBuffer_Reserve(const SPSC_RingBuffer* buf, uint8_t** data);
+uint32_t SPSC_RingBuffer_Peek(const SPSC_RingBuffer* buf, const uint8_t** data);
+RBRESULT SPSC_RingBuffer_Consume(SPSC_RingBuffer* buf, const uint32_t length);
+
+#ifdef RINGBUFFER_STATS
+void SPSC_RingBuffer_GetStats(const SPSC_RingBuffer* buf, RingBuffer_Stats* stats);
+void SPSC_RingBuffer_ResetStats(SPSC_RingBuffer* buf);
+void SPSC_RingBuffer_SetThresholds(SPSC_RingBuffer* buf, uint32_t low_threshold, uint32_t high_threshold, RingBuffer_Callback callback, void* context);
+#endif
+
+#endif /* __SPSC_RING_BUFFER_H__ */
@@ -5,27 +5,103 @@
  *        Bridge between user and UART interface
  *
  * @creation 2024/04/10
- * @edition 2024/04/11
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @setup one Shell per USART, with its own buffers (power of two sizes)
+ * 			static Shell console;
+ * 			static uint8_t console_rx[SHELL_RX_STORAGE_SIZE(512)];
+ * 			static uint8_t console_tx[1024];
+ * 			Shell_Init(&console, &huart2, console_rx, 512, console_tx, 1024, UART_MODE_IT);
+ * 		the first shell initialized is the console used by the other modules
+ * 		(Shell_GetConsole), see Shell_SetConsole to change it.
+ *
+ * @setup commands, the table must be sorted by name (strcmp order)
+ * 			static const Shell_Command commands[] = {
+ * 				{"ls",   Cmd_Ls},
+ * 				{"play", Cmd_Play},
+ * 			};
+ * 			Shell_SetCommands(&console, commands, sizeof(commands) / sizeof(commands[0]));
+ * 		then call Shell_Run(&console) from the main loop, it echoes what was
+ * 		received and runs each complete line, e.g. "play song.wav" calls
+ * 		Cmd_Play(&console, 2, {"play", "song.wav"})
+ * 		Shell_StatsCommand can be put in the table to print the drop counters
+ ******************************************************************************
  */
 #ifndef __SHELL_H__
 #define __SHELL_H__
 
 #include "usart.h"
+#include "SPSC_RingBuffer.h"
+#include "UART_Interface.h"
 
 #include <stdbool.h>
 
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define SHELL_MAX_ARGS 				(8)		// command name included
+#define SHELL_LINE_MAX_LENGTH (128)		// longer lines are dropped
+#define SHELL_RX_STORAGE_SIZE(rx_size) ((rx_size) + SHELL_LINE_MAX_LENGTH)		// spare bytes to unwrap a line
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef enum {
+	SHELL_TX_REJECT = 0,		// a message which does not fit is dropped whole (default)
+	SHELL_TX_PARTIAL,				// what fits is sent, the end of the message is dropped
+	SHELL_TX_DROP_OLDEST,		// the oldest bytes not being sent yet are dropped to make room
+	SHELL_TX_BLOCK,					// wait for room up to the timeout then reject, rejects at once in interrupts
+} SHELL_TX_POLICY;
+
+typedef struct {
+	uint32_t dropped_bytes;			// never sent, whatever the policy
+	uint32_t dropped_messages;	// messages dropped whole or partly (drop-oldest is counted in bytes only)
+	uint32_t blocked_ms;				// time spent waiting for room
+} Shell_TxStats;
+
+typedef struct Shell Shell;
+
+typedef void (*Shell_Function)(Shell* shell, int argc, char** argv);
+
+typedef struct {
+	const char* name;
+	Shell_Function function;
+} Shell_Command;
+
+struct Shell {
+	UART_Port port;
+	SPSC_RingBuffer rx_buffer;
+	SPSC_RingBuffer tx_buffer;
+	const Shell_Command* commands;
+	uint32_t nb_commands;
+	uint32_t lines_read;		// compared with UART_Interface_GetLineCount()
+	uint32_t echo_index;		// free running Rx index of the next byte to echo
+	bool line_dropped;			// the Rx line in progress was too long, drop it up to its end
+	SHELL_TX_POLICY tx_policy;
+	uint32_t tx_timeout_ms;
+	Shell_TxStats tx_stats;
+};
+
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void Shell_Init(UART_HandleTypeDef* huart);
-bool Shell_IsNotEmpty();
-char Shell_ReadLetter();
-void Shell_PrintLetter(uint8_t letter);
-void Shell_PrintString(const char* string);
-void Shell_ClearBuf(char *buf, uint16_t word_length);
+bool 	 Shell_Init(Shell* shell, UART_HandleTypeDef* huart, uint8_t* rx_storage, uint32_t rx_size, uint8_t* tx_storage, uint32_t tx_size, UART_MODE mode);
+void 	 Shell_SetConsole(Shell* shell);
+Shell* Shell_GetConsole();
+bool 	 Shell_SetCommands(Shell* shell, const Shell_Command* commands, uint32_t nb_commands);
+bool 	 Shell_IsLineReady(const Shell* shell);
+void 	 Shell_Run(Shell* shell);
+bool 	 Shell_IsNotEmpty(Shell* shell);
+char 	 Shell_ReadLetter(Shell* shell);
+void 	 Shell_PrintLetter(Shell* shell, uint8_t letter);
+void 	 Shell_PrintString(Shell* shell, const char* string);
+void 	 Shell_Printf(Shell* shell, const char* format, ...);
+void 	 Shell_ClearBuf(char *buf, uint16_t word_length);
+void 	 Shell_SetTxPolicy(Shell* shell, SHELL_TX_POLICY policy, uint32_t timeout_ms);
+void 	 Shell_GetTxStats(const Shell* shell, Shell_TxStats* stats);
+void 	 Shell_StatsCommand(Shell* shell, int argc, char** argv);
 
 #endif /* __SHELL_H__ */
@@ -0,0 +1,141 @@
+/**
+ ******************************************************************************
+ * @file Telemetry.c
+ * @brief Telemetry implementation file
+ *        Binary records framed with COBS and CRC16 on a UART port
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the frame is built and encoded on the stack, in place: the raw record is
+ * written one byte after the start of the frame, which is where COBS puts
+ * it, then each zero is replaced by the distance to the next one. Only the
+ * copy into the Tx buffer is done with interrupts masked, records may be
+ * sent from the main loop and from any interrupt.
+ ******************************************************************************
+ */
+#include "Telemetry.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _HEADER_SIZE 	(6)		// type, source, timestamp
+#define _CRC_SIZE 		(2)
+#define _FRAME_MAX_SIZE (1 + _HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + _CRC_SIZE + 1)		// COBS code and delimiter
+
+#define _CRC_INIT (0xFFFF)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static UART_Port* s_port;
+static Telemetry_Stats s_stats;
+
+// CRC16 CCITT of a nibble, two lookups per byte instead of a 512 bytes table
+static const uint16_t s_crc_table[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static uint16_t _Crc16(const uint8_t* data, uint32_t length);
+static uint32_t _EncodeCOBS(uint8_t* frame, uint32_t length);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * port must have been initialized, its Tx buffer is only written by the telemetry
+ */
+void Telemetry_Init(UART_Port* port) {
+	memset(&s_stats, 0, sizeof(s_stats));
+	s_port = port;
+}
+
+/*
+ * Queue a record, never waits: returns false and counts it as dropped
+ * if the Tx buffer is full
+ */
+bool Telemetry_Send(uint8_t type, uint8_t source, const void* payload, uint8_t length) {
+	uint8_t frame[_FRAME_MAX_SIZE];
+	uint8_t* record = &frame[1];		// raw record, after the COBS code
+	uint32_t timestamp = HAL_GetTick();
+
+	if (s_port == NULL) return false;
+	if (length > TELEMETRY_MAX_PAYLOAD) {
+		s_stats.dropped++;
+		return false;
+	}
+
+	record[0] = type;
+	record[1] = source;
+	record[2] = timestamp;
+	record[3] = timestamp >> 8;
+	record[4] = timestamp >> 16;
+	record[5] = timestamp >> 24;
+	memcpy(&record[_HEADER_SIZE], payload, length);
+
+	uint32_t raw_length = _HEADER_SIZE + length;
+	uint16_t crc = _Crc16(record, raw_length);
+	record[raw_length++] = crc;
+	record[raw_length++] = crc >> 8;
+
+	uint32_t frame_length = _EncodeCOBS(frame, raw_length);
+
+	uint32_t primask = __get_PRIMASK();		// several producers, the SPSC buffer needs one at a time
+	__disable_irq();
+	bool queued = SPSC_RingBuffer_PutSeveral(s_port->tx_buffer, frame, frame_length) == RB_OK;
+	if (queued) {
+		s_stats.records++;
+		UART_Interface_EnableIT(s_port);
+	}
+	else {
+		s_stats.dropped++;
+	}
+	__set_PRIMASK(primask);
+	return queued;
+}
+
+void Telemetry_GetStats(Telemetry_Stats* stats) {
+	*stats = s_stats;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint16_t _Crc16(const uint8_t* data, uint32_t length) {
+	uint16_t crc = _CRC_INIT;
+
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		crc = (crc << 4) ^ s_crc_table[(crc >> 12) ^ (data[cpt] >> 4)];
+		crc = (crc << 4) ^ s_crc_table[(crc >> 12) ^ (data[cpt] & 0x0F)];
+	}
+	return crc;
+}
+
+/*
+ * The length raw bytes are at frame[1], encoded in place (less than 254 bytes,
+ * no extra code byte) and followed by the delimiter. Returns the frame length
+ */
+uint32_t _EncodeCOBS(uint8_t* frame, uint32_t length) {
+	uint32_t code_index = 0;
+
+	for (uint32_t index = 1; index <= length; index++) {
+		if (frame[index] == 0) {
+			frame[code_index] = index - code_index;
+			code_index = index;
+		}
+	}
+	frame[code_index] = length + 1 - code_index;
+	frame[length + 1] = 0;
+	return length + 2;
+}
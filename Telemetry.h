@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ * @file Telemetry.h
+ * @brief Telemetry implementation file
+ *        Binary records framed with COBS and CRC16 on a UART port
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @setup a UART port of its own, e.g. a 921600 bauds link with DMA
+ * 			static SPSC_RingBuffer tlm_rx, tlm_tx;
+ * 			static uint8_t tlm_rx_storage[16], tlm_tx_storage[4096];
+ * 			static UART_Port tlm_port;
+ * 			SPSC_RingBuffer_Init(&tlm_rx, tlm_rx_storage, 16);
+ * 			SPSC_RingBuffer_Init(&tlm_tx, tlm_tx_storage, 4096);
+ * 			UART_Interface_Init(&tlm_port, &huart3, &tlm_rx, &tlm_tx, UART_MODE_TX_DMA);
+ * 			Telemetry_Init(&tlm_port);
+ * 		records are dropped while Telemetry_Init() has not been called
+ *
+ * @note frame
+ * 		type (1), source (1), timestamp in ms (4), payload (0 to TELEMETRY_MAX_PAYLOAD),
+ * 		CRC16 (2), multi-byte fields little endian. The CRC is CCITT (poly
+ * 		0x1021, init 0xFFFF) over everything before it. The frame is COBS
+ * 		encoded (one overhead byte, frames are shorter than 254 bytes) and
+ * 		followed by a 0x00 delimiter: a decoder splits the stream on 0x00,
+ * 		decodes, checks the CRC and gets the payload length from the frame size.
+ *
+ * @note throughput
+ * 		a record takes 10 + payload bytes on the line, i.e. 18 bytes with two
+ * 		32 bits values: 5120 records/s at 921600 bauds, 640 at 115200 bauds
+ * 		(10 bits per byte).
+ ******************************************************************************
+ */
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "UART_Interface.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define TELEMETRY_MAX_PAYLOAD (32)
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef enum {
+	TLM_CODER_WIDTH = 0x01,		// {width in timer ticks, speed in turns/s Q16}, source is the coder id
+	TLM_WAV_FILL 		= 0x02,		// {lowest buffer fill in bytes, DAC values missing}, over 50 ms
+	TLM_USER 				= 0x80,		// first type free for the application
+} TELEMETRY_TYPE;
+
+typedef struct {
+	uint32_t records;		// queued in the Tx buffer
+	uint32_t dropped;		// Tx buffer full or payload too long
+} Telemetry_Stats;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Telemetry_Init(UART_Port* port);
+bool Telemetry_Send(uint8_t type, uint8_t source, const void* payload, uint8_t length);
+void Telemetry_GetStats(Telemetry_Stats* stats);
+
+#endif /* __TELEMETRY_H__ */
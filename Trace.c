@@ -0,0 +1,226 @@
+/**
+ ******************************************************************************
+ * @file Trace.c
+ * @brief Trace implementation file
+ *        Timestamped enter / exit events of interrupts and main loop tasks
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note recording
+ * the buffer keeps the last TRACE_BUFFER_LENGTH events. A slot is claimed
+ * with a compare and swap on the event count (LDREX / STREX on Cortex-M3/M4)
+ * which also covers the timestamp read: an interrupt recording in between
+ * makes the claim fail and start again, so the buffer is in time order.
+ * Recording stops while the command reads the buffer.
+ *
+ * @note summary
+ * events are replayed with a stack of the running sources. The time spent
+ * in a source excludes the sources which preempted it, its load is that
+ * time over the recorded window.
+ ******************************************************************************
+ */
+#include "Trace.h"
+
+#ifdef TRACE_ENABLE
+
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__arm__)
+#include "main.h"
+#else
+#include <time.h>
+#endif
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#if defined(__arm__)
+#define _TIMESTAMP() 		(DWT->CYCCNT)
+#define _TICKS_PER_US() (SystemCoreClock / 1000000)
+#else
+#define _TIMESTAMP() 		_HostTimestamp()
+#define _TICKS_PER_US() (1000)
+#endif
+
+#define _MASK 			(TRACE_BUFFER_LENGTH - 1)
+#define _MAX_DEPTH 	(8)		// nested sources replayed by the summary
+
+#define _DUMP_TIMEOUT_MS (100)		// the dump waits for room in the Tx buffer
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint32_t count;
+	uint32_t busy;		// ticks, preemptions excluded
+	uint32_t max;			// ticks, worst execution time
+} TRACE_Load;
+
+typedef struct {
+	uint16_t source;
+	uint32_t start;
+	uint32_t preempted;		// ticks spent in the sources nested in this one
+} TRACE_Frame;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static Trace_Event s_events[TRACE_BUFFER_LENGTH];
+static volatile uint32_t s_nb_events;		// free running, next slot is s_nb_events & _MASK
+static volatile bool s_frozen;
+
+static const char* const s_names[TRACE_NB_SOURCES] = {"uart", "coder", "dac", "feed"};
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Summarize(Shell* shell, uint32_t first, uint32_t nb_events);
+static void _Dump(Shell* shell, uint32_t first, uint32_t nb_events);
+#if !defined(__arm__)
+static uint32_t _HostTimestamp();
+#endif
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Trace_Init() {
+#if defined(__arm__)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;		// enable the DWT
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	Trace_Clear();
+}
+
+void Trace_Record(TRACE_SOURCE source, uint16_t exit) {
+	uint32_t index;
+	uint32_t timestamp;
+
+	if (s_frozen) return;
+	do {
+		index = s_nb_events;
+		timestamp = _TIMESTAMP();
+	} while (!__atomic_compare_exchange_n(&s_nb_events, &index, index + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	Trace_Event* event = &s_events[index & _MASK];
+	event->timestamp = timestamp;
+	event->source = source;
+	event->exit = exit;
+}
+
+void Trace_Clear() {
+	s_frozen = true;
+	s_nb_events = 0;
+	s_frozen = false;
+}
+
+/*
+ * Shell command: "trace", "trace dump" or "trace clear"
+ */
+void Trace_Command(Shell* shell, int argc, char** argv) {
+	if (argc > 1 && strcmp(argv[1], "clear") == 0) {
+		Trace_Clear();
+		return;
+	}
+
+	s_frozen = true;		// events being written are complete before the shell runs again
+	uint32_t nb_events = s_nb_events;
+	uint32_t first = 0;
+	if (nb_events > TRACE_BUFFER_LENGTH) {
+		first = nb_events - TRACE_BUFFER_LENGTH;
+		nb_events = TRACE_BUFFER_LENGTH;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "dump") == 0) {
+		_Dump(shell, first, nb_events);
+	}
+	else {
+		_Summarize(shell, first, nb_events);
+	}
+	s_frozen = false;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Summarize(Shell* shell, uint32_t first, uint32_t nb_events) {
+	TRACE_Load loads[TRACE_NB_SOURCES];
+	TRACE_Frame stack[_MAX_DEPTH];
+	uint8_t depth = 0;
+
+	if (nb_events < 2) {
+		Shell_PrintString(shell, "No trace\r\n");
+		return;
+	}
+	memset(loads, 0, sizeof(loads));
+
+	for (uint32_t cpt = 0; cpt < nb_events; cpt++) {
+		const Trace_Event* event = &s_events[(first + cpt) & _MASK];
+
+		if (!event->exit) {
+			if (depth < _MAX_DEPTH) {
+				stack[depth].source = event->source;
+				stack[depth].start = event->timestamp;
+				stack[depth].preempted = 0;
+				depth++;
+			}
+			continue;
+		}
+
+		uint8_t level = depth;		// the enter may be older than the window
+		while (level && stack[level - 1].source != event->source) level--;
+		if (level == 0) continue;
+
+		depth = level - 1;
+		uint32_t elapsed = event->timestamp - stack[depth].start;
+		uint32_t own = elapsed - stack[depth].preempted;
+		TRACE_Load* load = &loads[event->source];
+		load->count++;
+		load->busy += own;
+		if (own > load->max) load->max = own;
+		if (depth) stack[depth - 1].preempted += elapsed;
+	}
+
+	uint32_t window = s_events[(first + nb_events - 1) & _MASK].timestamp - s_events[first & _MASK].timestamp;
+	uint32_t ticks_per_us = _TICKS_PER_US();
+
+	Shell_Printf(shell, "%u events over %u us\r\n", nb_events, window / ticks_per_us);
+	Shell_PrintString(shell, "source   calls  load    max us\r\n");
+	for (uint8_t source = 0; source < TRACE_NB_SOURCES; source++) {
+		uint32_t permille = window ? (uint32_t)((uint64_t) loads[source].busy * 1000 / window) : 0;
+		Shell_Printf(shell, "%-8s %6u %3u.%u%% %6u\r\n", s_names[source], loads[source].count,
+					 permille / 10, permille % 10, loads[source].max / ticks_per_us);
+	}
+}
+
+/*
+ * One line per event, timestamps in ticks from the first event
+ */
+void _Dump(Shell* shell, uint32_t first, uint32_t nb_events) {
+	SHELL_TX_POLICY policy = shell->tx_policy;
+	uint32_t timeout_ms = shell->tx_timeout_ms;
+	uint32_t origin = s_events[first & _MASK].timestamp;
+
+	Shell_SetTxPolicy(shell, SHELL_TX_BLOCK, _DUMP_TIMEOUT_MS);		// more lines than the Tx buffer holds
+	for (uint32_t cpt = 0; cpt < nb_events; cpt++) {
+		const Trace_Event* event = &s_events[(first + cpt) & _MASK];
+		Shell_Printf(shell, "%10u %-6s %s\r\n", event->timestamp - origin, s_names[event->source], event->exit ? "exit" : "enter");
+	}
+	Shell_SetTxPolicy(shell, policy, timeout_ms);
+}
+
+#if !defined(__arm__)
+uint32_t _HostTimestamp() {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+#endif
+
+#endif /* TRACE_ENABLE */
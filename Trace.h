@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ * @file Trace.h
+ * @brief Trace implementation file
+ *        Timestamped enter / exit events of interrupts and main loop tasks
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @setup define TRACE_ENABLE below, call Trace_Init() once at startup and
+ * 		add the command to the shell table (sorted)
+ * 			#ifdef TRACE_ENABLE
+ * 				{"trace", Trace_Command},
+ * 			#endif
+ * 		"trace" prints the load and worst execution time of each source,
+ * 		"trace dump" the events, "trace clear" empties the buffer.
+ * 		Without TRACE_ENABLE, TRACE_ENTER() and TRACE_EXIT() are empty and
+ * 		nothing of Trace.c is compiled.
+ *
+ * @note timestamps are DWT cycles on target, ns from clock_gettime() on host
+ ******************************************************************************
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+//#define TRACE_ENABLE		// record enter / exit events, costs about 20 cycles per event
+
+#define TRACE_BUFFER_LENGTH (512)		// events, must be a power of two
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef enum {
+	TRACE_UART = 0,		// UART_Interface_IRQHandler()
+	TRACE_CODER,			// CoderInterface_Run()
+	TRACE_DAC,				// DAC values rendering, DMA callbacks or per sample
+	TRACE_FEED,				// WavDecoder_FeedDacBuffer()
+	TRACE_NB_SOURCES,
+} TRACE_SOURCE;
+
+#ifdef TRACE_ENABLE
+
+#include "Shell.h"
+
+#include <stdint.h>
+
+#define TRACE_ENTER(source) Trace_Record((source), 0)
+#define TRACE_EXIT(source) 	Trace_Record((source), 1)
+
+typedef struct {
+	uint32_t timestamp;
+	uint16_t source;
+	uint16_t exit;			// 0 on enter, 1 on exit
+} Trace_Event;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Trace_Init();
+void Trace_Record(TRACE_SOURCE source, uint16_t exit);
+void Trace_Clear();
+void Trace_Command(Shell* shell, int argc, char** argv);
+
+#else
+
+#define TRACE_ENTER(source) ((void)0)
+#define TRACE_EXIT(source) 	((void)0)
+
+#endif /* TRACE_ENABLE */
+
+#endif /* __TRACE_H__ */
@@ -5,41 +5,131 @@
  *        Manage UART communication
  *
  * @creation 2024/04/10
- * @edition 2024/04/12
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
+ * @note DMA reception
+ * the DMA writes the received bytes straight into the Rx buffer storage,
+ * which it loops over. Half transfer, transfer complete and idle line events
+ * publish everything written since the last event at once, so there is one
+ * interrupt per burst (or half buffer) instead of one per byte. The DMA
+ * position is the next write index: the bytes to publish are the ones from
+ * the buffer head up to it.
+ *
+ * @note DMA transmission
+ * the Tx DMA reads the largest contiguous span of the Tx buffer in place.
+ * Its completion releases the span and starts the next one: the rest after
+ * the wrap and whatever was added meanwhile. UART_Interface_EnableIT() only
+ * starts a transfer when none is running.
+ *
+ * @note interrupt priorities
+ * in DMA reception UART_Interface_RxEvent() runs from the DMA stream and the
+ * USART (idle line) interrupts. Give both the same NVIC priority, so neither
+ * preempts the other; the event also masks the interrupts while it
+ * publishes, a wrong setting then delays the DMA interrupt instead of
+ * committing the same bytes twice.
+ *
+ * @note ports
+ * each USART has its own UART_Port context, registered at init in a table
+ * indexed by USART number. The interrupt handlers find it with a switch on
+ * the peripheral address, in constant time.
+ ******************************************************************************
  */
 #include "UART_Interface.h"
-#include "RingBuffer.h"
-#include "Shell.h"
+#include "SPSC_RingBuffer.h"
+#include "Trace.h"
 
+#include <stddef.h>
 #include <string.h>
 
 // ------------------------------------------------------------------------
 // -------------------------- STATIC PROTOTYPES ---------------------------
 // ------------------------------------------------------------------------
-static UART_HandleTypeDef* uart;
-static RingBuffer* _rx_buffer;
-static RingBuffer* _tx_buffer;
+static UART_Port* s_ports[UART_NB_PORTS];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static int8_t _GetPortIndex(const USART_TypeDef* usart);
+static void _CountErrors(UART_Port* port, uint32_t isrflags);
+static inline bool _IsLineEnd(uint8_t c);
+static void _StartTxDMA(UART_Port* port);
+static void _TxDMAComplete(DMA_HandleTypeDef* hdma);
 
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void UART_Interface_Init(UART_HandleTypeDef* huart, RingBuffer* rx_buffer, RingBuffer* tx_buffer) {
-	uart = huart;
-  _rx_buffer = rx_buffer;
-  _tx_buffer = tx_buffer;
+/*
+ * In DMA reception, rx_buffer storage is the circular DMA destination,
+ * its size must fit the DMA counter (65535).
+ * Returns false if the peripheral is not a known USART or the Rx DMA does
+ * not start
+ */
+bool UART_Interface_Init(UART_Port* port, UART_HandleTypeDef* huart, SPSC_RingBuffer* rx_buffer, SPSC_RingBuffer* tx_buffer, UART_MODE mode) {
+	int8_t index = _GetPortIndex(huart->Instance);
+	if (index < 0) return false;
+	
+	memset(port, 0, sizeof(UART_Port));
+	port->huart = huart;
+  port->rx_buffer = rx_buffer;
+  port->tx_buffer = tx_buffer;
+  port->mode = mode;
+  s_ports[index] = port;		// before any interrupt is enabled
   
-  __HAL_UART_ENABLE_IT(uart, UART_IT_ERR);		// Enable the UART Error Interrupt: (Frame error, noise error, overrun error)
-  __HAL_UART_ENABLE_IT(uart, UART_IT_RXNE);		// Enable the UART Data Register not empty Interrupt
+  __HAL_UART_ENABLE_IT(huart, UART_IT_ERR);		// Enable the UART Error Interrupt: (Frame error, noise error, overrun error)
+  if (mode & UART_MODE_RX_DMA) {
+	  if (HAL_UART_Receive_DMA(huart, rx_buffer->buf, rx_buffer->mask + 1) != HAL_OK) {
+		  s_ports[index] = NULL;
+		  return false;
+	  }
+	  __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);		// Enable the UART Idle line Interrupt, end of a burst
+  }
+  else {
+	  __HAL_UART_ENABLE_IT(huart, UART_IT_RXNE);		// Enable the UART Data Register not empty Interrupt
+  }
+  if (mode & UART_MODE_TX_DMA) {
+	  huart->hdmatx->XferCpltCallback = _TxDMAComplete;		// driven without the HAL UART state machine
+	  huart->hdmatx->XferHalfCpltCallback = NULL;
+	  SET_BIT(huart->Instance->CR3, USART_CR3_DMAT);
+  }
+  return true;
+}
+
+UART_Port* UART_Interface_GetPort(const USART_TypeDef* usart) {
+	int8_t index = _GetPortIndex(usart);
+	return (index < 0) ? NULL : s_ports[index];
 }
 
-void UART_Interface_Run() {
+void UART_Interface_IRQHandler(const USART_TypeDef* usart) {
+	UART_Port* port = UART_Interface_GetPort(usart);
+	
+	TRACE_ENTER(TRACE_UART);
+	if (port) UART_Interface_Run(port);
+	TRACE_EXIT(TRACE_UART);
+}
+
+void UART_Interface_Run(UART_Port* port) {
+	UART_HandleTypeDef* uart = port->huart;
 	uint32_t isrflags   = READ_REG(uart->Instance->SR);
 	uint32_t cr1its     = READ_REG(uart->Instance->CR1);
 
+	if (isrflags & (USART_SR_ORE | USART_SR_FE | USART_SR_NE)) {
+		_CountErrors(port, isrflags);
+		if (port->mode & UART_MODE_RX_DMA) {		// no RXNE branch to clear them, the byte is lost anyway
+			uart->Instance->SR;
+			uart->Instance->DR;
+		}
+	}
+
+	/* if the line went idle after a burst received by DMA */
+	if (((isrflags & USART_SR_IDLE) != RESET) && ((cr1its & USART_CR1_IDLEIE) != RESET)) {
+		uart->Instance->SR;                       /* IDLE is cleared by a read of SR then DR */
+		uart->Instance->DR;
+		UART_Interface_RxEvent(uart);
+	}
+
 	/* if DR is not empty and the Rx Int is enabled */
 	if (((isrflags & USART_SR_RXNE) != RESET) && ((cr1its & USART_CR1_RXNEIE) != RESET)) {
 		/******************
@@ -55,14 +145,18 @@ void UART_Interface_Run() {
 		*********************/
 		uart->Instance->SR;                       /* Read status register */
 		unsigned char c = uart->Instance->DR;     /* Read data register */
-		RingBuffer_Put(_rx_buffer, c);  // store data in buffer
-		Shell_PrintLetter(c);
+		if (SPSC_RingBuffer_Put(port->rx_buffer, c) != RB_OK) {  // store data in buffer
+			port->stats.rx_overflows++;
+		}
+		else if (_IsLineEnd(c)) {
+			port->rx_lines++;
+		}
 		return;
 	}
 
 	/*If interrupt is caused due to Transmit Data Register Empty */
 	if (((isrflags & USART_SR_TXE) != RESET) && ((cr1its & USART_CR1_TXEIE) != RESET)) {
-		if(RingBuffer_IsEmpty(_tx_buffer)) {
+		if(SPSC_RingBuffer_IsEmpty(port->tx_buffer)) {
 				// Buffer empty, so disable interrupts
 				__HAL_UART_DISABLE_IT(uart, UART_IT_TXE);
 		}
@@ -70,7 +164,7 @@ void UART_Interface_Run() {
 		else {
 			// There is more data in the output buffer. Send the next byte
 			uint8_t c;
-			RingBuffer_Get(_tx_buffer, &c);
+			SPSC_RingBuffer_Get(port->tx_buffer, &c);
 
 			/******************
 			*  @note   PE (Parity error), FE (Framing error), NE (Noise error), ORE (Overrun
@@ -91,8 +185,157 @@ void UART_Interface_Run() {
 	}
 }
 
-void UART_Interface_EnableIT() {
-	__HAL_UART_ENABLE_IT(uart, UART_IT_TXE); // Enable UART transmission interrupt
+/*
+ * Publish the bytes written by the Rx DMA since the last event.
+ * Called from the DMA and the USART interrupts, which must not preempt each
+ * other in here: the head is read, the bytes counted and committed masked
+ */
+void UART_Interface_RxEvent(UART_HandleTypeDef* huart) {
+	UART_Port* port = UART_Interface_GetPort(huart->Instance);
+	if (port == NULL || !(port->mode & UART_MODE_RX_DMA)) return;
+	
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	SPSC_RingBuffer* rx_buffer = port->rx_buffer;
+	uint32_t position = (rx_buffer->mask + 1 - __HAL_DMA_GET_COUNTER(huart->hdmarx)) & rx_buffer->mask;
+	uint32_t head = rx_buffer->head;
+	uint32_t length = (position - head) & rx_buffer->mask;
+	uint32_t free_space = SPSC_RingBuffer_GetRemainingSize(rx_buffer);
+
+	if (length > free_space) {		// the DMA overwrote unread bytes
+		port->stats.rx_overflows++;
+		length = free_space;
+	}
+	uint32_t nb_lines = 0;
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		nb_lines += _IsLineEnd(rx_buffer->buf[(head + cpt) & rx_buffer->mask]);
+	}
+	SPSC_RingBuffer_Commit(rx_buffer, length);
+	port->rx_lines += nb_lines;		// after the commit, a counted line is always readable
+	__set_PRIMASK(primask);
+}
+
+/*
+ * Free running count of CR and LF received, compare with a previous value
+ * to know whether a complete line is waiting in the Rx buffer
+ */
+uint32_t UART_Interface_GetLineCount(const UART_Port* port) {
+	return port->rx_lines;
+}
+
+/*
+ * Drop up to length of the oldest bytes waiting in the Tx buffer, to make
+ * room when it is full. Bytes being sent by the DMA are kept, the newer ones
+ * are then moved down over the dropped ones. Returns the number dropped
+ */
+uint32_t UART_Interface_DropTx(UART_Port* port, uint32_t length) {
+	SPSC_RingBuffer* tx_buffer = port->tx_buffer;
+	uint32_t primask = __get_PRIMASK();		// the consumer side is changed, keep the Tx interrupts out
+	__disable_irq();
+	
+	uint32_t in_flight = port->tx_dma_length;
+	uint32_t waiting = SPSC_RingBuffer_GetSize(tx_buffer) - in_flight;
+	if (length > waiting) length = waiting;
+	
+	if (in_flight == 0) {
+		SPSC_RingBuffer_Consume(tx_buffer, length);
+	}
+	else {
+		uint32_t index = tx_buffer->tail + in_flight;
+		for (uint32_t cpt = length; cpt < waiting; cpt++, index++) {
+			tx_buffer->buf[index & tx_buffer->mask] = tx_buffer->buf[(index + length) & tx_buffer->mask];
+		}
+		tx_buffer->head -= length;
+	}
+	__set_PRIMASK(primask);
+	return length;
+}
+
+void UART_Interface_EnableIT(UART_Port* port) {
+	if (!(port->mode & UART_MODE_TX_DMA)) {
+		__HAL_UART_ENABLE_IT(port->huart, UART_IT_TXE); // Enable UART transmission interrupt
+		return;
+	}
+	
+	uint32_t primask = __get_PRIMASK();		// the completion interrupt may start a transfer too
+	__disable_irq();
+	if (port->tx_dma_length == 0) {
+		_StartTxDMA(port);
+	}
+	__set_PRIMASK(primask);
+}
+
+void UART_Interface_GetStats(const UART_Port* port, UART_Stats* stats) {
+	*stats = port->stats;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Index in s_ports, -1 if usart is not a USART of this device
+ */
+int8_t _GetPortIndex(const USART_TypeDef* usart) {
+	switch ((uintptr_t) usart) {
+#ifdef USART1
+		case USART1_BASE: return 0;
+#endif
+#ifdef USART2
+		case USART2_BASE: return 1;
+#endif
+#ifdef USART3
+		case USART3_BASE: return 2;
+#endif
+#ifdef UART4
+		case UART4_BASE: 	return 3;
+#endif
+#ifdef UART5
+		case UART5_BASE: 	return 4;
+#endif
+#ifdef USART6
+		case USART6_BASE: return 5;
+#endif
+#ifdef UART7
+		case UART7_BASE: 	return 6;
+#endif
+#ifdef UART8
+		case UART8_BASE: 	return 7;
+#endif
+		default: 					return -1;
+	}
+}
+
+void _CountErrors(UART_Port* port, uint32_t isrflags) {
+	if (isrflags & USART_SR_ORE) port->stats.overrun_errors++;
+	if (isrflags & USART_SR_FE) port->stats.framing_errors++;
+	if (isrflags & USART_SR_NE) port->stats.noise_errors++;
+}
+
+bool _IsLineEnd(uint8_t c) {
+	return c == '\r' || c == '\n';
+}
+
+void _StartTxDMA(UART_Port* port) {
+	const uint8_t* span;
+	uint32_t length = SPSC_RingBuffer_Peek(port->tx_buffer, &span);
+	
+	if (length > 0xFFFF) length = 0xFFFF;		// DMA counter size
+	port->tx_dma_length = length;
+	if (length && HAL_DMA_Start_IT(port->huart->hdmatx, (uintptr_t) span, (uintptr_t) &port->huart->Instance->DR, length) != HAL_OK) {
+		port->stats.tx_dma_errors++;
+		port->tx_dma_length = 0;		// nothing in flight, the next UART_Interface_EnableIT() retries
+	}
+}
+
+/*
+ * The DMA handle is linked to its UART handle by __HAL_LINKDMA (Parent)
+ */
+void _TxDMAComplete(DMA_HandleTypeDef* hdma) {
+	UART_Port* port = UART_Interface_GetPort(((UART_HandleTypeDef*) hdma->Parent)->Instance);
+	if (port == NULL) return;
+	
+	SPSC_RingBuffer_Consume(port->tx_buffer, port->tx_dma_length);
+	_StartTxDMA(port);
 }
 
 
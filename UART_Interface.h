@@ -5,13 +5,23 @@
  *        Manage UART communication
  *
  * @creation 2024/04/10
- * @edition 2024/04/11
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
- * @setup the following function must be put in the USART IRQ Handler
- * 			UART_Interface_Run();
+ * @setup the following function must be put in each USARTx IRQ Handler
+ * 			UART_Interface_IRQHandler(USARTx);
+ *
+ * @setup DMA modes (UART_MODE_RX_DMA / UART_MODE_TX_DMA), the DMA streams are
+ * 		byte to byte and their IRQ handled by HAL_DMA_IRQHandler(). The Rx
+ * 		stream must be circular, the Tx stream normal. The following function
+ * 		must be put in HAL_UART_RxHalfCpltCallback() and HAL_UART_RxCpltCallback()
+ * 			UART_Interface_RxEvent(huart);
+ * 		the Rx DMA stream IRQ and the USARTx IRQ must have the same NVIC
+ * 		priority (preemption and sub priority), e.g. in MX_NVIC_Init()
+ * 			HAL_NVIC_SetPriority(DMA2_Stream2_IRQn, 5, 0);
+ * 			HAL_NVIC_SetPriority(USART1_IRQn, 5, 0);
  *
  ******************************************************************************
  */
@@ -19,13 +29,54 @@
 #define __UART_INTERFACE_H__
 
 #include "usart.h"
-#include "RingBuffer.h"
+#include "SPSC_RingBuffer.h"
+
+#include <stdbool.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define UART_NB_PORTS (8)		// USART1 to UART8
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef enum {
+	UART_MODE_IT 			= 0x00,		// one RXNE / TXE interrupt per byte
+	UART_MODE_RX_DMA 	= 0x01,		// circular DMA reception
+	UART_MODE_TX_DMA 	= 0x02,		// DMA transmission of contiguous spans
+	UART_MODE_DMA 		= UART_MODE_RX_DMA | UART_MODE_TX_DMA,
+} UART_MODE;
+
+typedef struct {
+	uint32_t overrun_errors;		// byte lost by the UART, read too late
+	uint32_t framing_errors;
+	uint32_t noise_errors;
+	uint32_t rx_overflows;			// received bytes which did not fit in the Rx buffer, in events
+	uint32_t tx_dma_errors;			// Tx DMA transfers which did not start
+} UART_Stats;
+
+typedef struct {
+	UART_HandleTypeDef* huart;
+	SPSC_RingBuffer* rx_buffer;
+	SPSC_RingBuffer* tx_buffer;
+	UART_MODE mode;
+	volatile uint32_t tx_dma_length;		// bytes being sent by the Tx DMA, 0 when idle
+	volatile uint32_t rx_lines;					// free running count of received line ends
+	UART_Stats stats;
+} UART_Port;
 
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void UART_Interface_Init(UART_HandleTypeDef* huart, RingBuffer* rx_buffer, RingBuffer* tx_buffer);
-void UART_Interface_Run();
-void UART_Interface_EnableIT();
+bool 		 UART_Interface_Init(UART_Port* port, UART_HandleTypeDef* huart, SPSC_RingBuffer* rx_buffer, SPSC_RingBuffer* tx_buffer, UART_MODE mode);
+UART_Port* UART_Interface_GetPort(const USART_TypeDef* usart);
+void 		 UART_Interface_IRQHandler(const USART_TypeDef* usart);
+void 		 UART_Interface_Run(UART_Port* port);
+void 		 UART_Interface_RxEvent(UART_HandleTypeDef* huart);
+uint32_t UART_Interface_GetLineCount(const UART_Port* port);
+void 		 UART_Interface_EnableIT(UART_Port* port);
+uint32_t UART_Interface_DropTx(UART_Port* port, uint32_t length);
+void 		 UART_Interface_GetStats(const UART_Port* port, UART_Stats* stats);
 
 #endif /* __UART_INTERFACE_H__ */
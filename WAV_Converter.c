@@ -0,0 +1,217 @@
+/**
+ ******************************************************************************
+ * @file WAV_Converter.c
+ * @brief WAV converter implementation file
+ *        Convert blocks of PCM frames into DAC values
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * every sample is first brought to 16 bits offset binary (signed ^ 0x8000),
+ * then shifted down to the DAC resolution. Kernels load whole words and work
+ * on two 16 bits lanes at once where the layout allows it, each iteration
+ * converts 2 to 4 frames and stores one word per 2 DAC values. The Cortex-M
+ * DSP extension is used for the stereo downmix when available. Float samples
+ * are clamped to [-1, 1] one by one (the FPU converts one value at a time),
+ * NaN gives silence.
+ * Source data may be unaligned (ring buffer spans), loads go through memcpy
+ * which compiles to a single LDR on Cortex-M3/M4.
+ ******************************************************************************
+ */
+#include "WAV_Converter.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+#endif
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _LANE_MASK ((0xFFFFu >> WAV_DAC_SHIFT) * 0x00010001u)	// DAC value mask on both 16 bits lanes
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static inline uint32_t _Load32(const uint8_t* src);
+static inline void 		 _Store32(uint16_t* dst, uint32_t value);
+static inline uint16_t _ToDac(int32_t sample);
+static inline uint16_t _FloatToDac(float sample);
+static inline int32_t  _Downmix(uint32_t frame);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+WAV_Converter WavConverter_Select(uint16_t audio_format, uint16_t nb_channels, uint16_t bits_per_sample) {
+	if (nb_channels != 1 && nb_channels != 2) return NULL;
+
+	if (audio_format == WAV_FORMAT_PCM) {
+		switch (bits_per_sample) {
+			case 8:  return (nb_channels == 1) ? WavConverter_U8Mono  : WavConverter_U8Stereo;
+			case 16: return (nb_channels == 1) ? WavConverter_S16Mono : WavConverter_S16Stereo;
+			case 24: return (nb_channels == 1) ? WavConverter_S24Mono : WavConverter_S24Stereo;
+		}
+	}
+	if (audio_format == WAV_FORMAT_IEEE_FLOAT && bits_per_sample == 32) {
+		return (nb_channels == 1) ? WavConverter_F32Mono : WavConverter_F32Stereo;
+	}
+	return NULL;
+}
+
+void WavConverter_U8Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 4; nb_frames -= 4, src += 4, dst += 4) {
+		uint32_t bytes = _Load32(src);
+		uint32_t lanes_01 = (bytes & 0x000000FF) | ((bytes & 0x0000FF00) << 8);
+		uint32_t lanes_23 = ((bytes >> 16) & 0x000000FF) | ((bytes >> 8) & 0x00FF0000);
+#if WAV_DAC_SHIFT >= 8
+		_Store32(dst, (lanes_01 >> (WAV_DAC_SHIFT - 8)) & _LANE_MASK);
+		_Store32(dst + 2, (lanes_23 >> (WAV_DAC_SHIFT - 8)) & _LANE_MASK);
+#else
+		_Store32(dst, (lanes_01 << (8 - WAV_DAC_SHIFT)) & _LANE_MASK);
+		_Store32(dst + 2, (lanes_23 << (8 - WAV_DAC_SHIFT)) & _LANE_MASK);
+#endif
+	}
+	for (; nb_frames; nb_frames--) {
+		*dst++ = (uint16_t)(*src++ << 8) >> WAV_DAC_SHIFT;
+	}
+}
+
+void WavConverter_U8Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 2; nb_frames -= 2, src += 4, dst += 2) {
+		uint32_t bytes = _Load32(src);
+		uint32_t lanes = (bytes & 0x00FF00FF) + ((bytes >> 8) & 0x00FF00FF);	// L + R of both frames, 9 bits per lane
+		_Store32(dst, (lanes << 7 >> WAV_DAC_SHIFT) & _LANE_MASK);
+	}
+	if (nb_frames) {
+		*dst = (uint16_t)((src[0] + src[1]) << 7) >> WAV_DAC_SHIFT;
+	}
+}
+
+void WavConverter_S16Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 4; nb_frames -= 4, src += 8, dst += 4) {
+		uint32_t samples_01 = _Load32(src) ^ 0x80008000;		// offset binary on both lanes
+		uint32_t samples_23 = _Load32(src + 4) ^ 0x80008000;
+		_Store32(dst, (samples_01 >> WAV_DAC_SHIFT) & _LANE_MASK);
+		_Store32(dst + 2, (samples_23 >> WAV_DAC_SHIFT) & _LANE_MASK);
+	}
+	for (; nb_frames; nb_frames--, src += 2) {
+		*dst++ = (uint16_t)((src[0] | (src[1] << 8)) ^ 0x8000) >> WAV_DAC_SHIFT;
+	}
+}
+
+void WavConverter_S16Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 2; nb_frames -= 2, src += 8, dst += 2) {
+		uint32_t mono_0 = _ToDac(_Downmix(_Load32(src)));
+		uint32_t mono_1 = _ToDac(_Downmix(_Load32(src + 4)));
+		_Store32(dst, mono_0 | (mono_1 << 16));
+	}
+	if (nb_frames) {
+		*dst = _ToDac(_Downmix(_Load32(src)));
+	}
+}
+
+void WavConverter_S24Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 4; nb_frames -= 4, src += 12, dst += 4) {	// 4 samples in 3 words, keep the 16 MSB
+		uint32_t word_0 = _Load32(src);
+		uint32_t word_1 = _Load32(src + 4);
+		uint32_t word_2 = _Load32(src + 8);
+		uint32_t samples_01 = ((word_0 >> 8) & 0x0000FFFF) | (word_1 << 16);
+		uint32_t samples_23 = (word_1 >> 24) | ((word_2 & 0x000000FF) << 8) | (word_2 & 0xFFFF0000);
+		_Store32(dst, ((samples_01 ^ 0x80008000) >> WAV_DAC_SHIFT) & _LANE_MASK);
+		_Store32(dst + 2, ((samples_23 ^ 0x80008000) >> WAV_DAC_SHIFT) & _LANE_MASK);
+	}
+	for (; nb_frames; nb_frames--, src += 3) {
+		*dst++ = (uint16_t)((src[1] | (src[2] << 8)) ^ 0x8000) >> WAV_DAC_SHIFT;
+	}
+}
+
+void WavConverter_S24Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 2; nb_frames -= 2, src += 12, dst += 2) {	// 2 frames in 3 words, keep the 16 MSB
+		uint32_t word_0 = _Load32(src);
+		uint32_t word_1 = _Load32(src + 4);
+		uint32_t word_2 = _Load32(src + 8);
+		uint32_t frame_0 = ((word_0 >> 8) & 0x0000FFFF) | (word_1 << 16);
+		uint32_t frame_1 = (word_1 >> 24) | ((word_2 & 0x000000FF) << 8) | (word_2 & 0xFFFF0000);
+		_Store32(dst, _ToDac(_Downmix(frame_0)) | ((uint32_t)_ToDac(_Downmix(frame_1)) << 16));
+	}
+	if (nb_frames) {
+		int32_t left  = (int16_t)(src[1] | (src[2] << 8));
+		int32_t right = (int16_t)(src[4] | (src[5] << 8));
+		*dst = _ToDac((left + right) >> 1);
+	}
+}
+
+void WavConverter_F32Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 4; nb_frames -= 4, src += 16, dst += 4) {
+		float samples[4];
+		memcpy(samples, src, sizeof(samples));
+		_Store32(dst, _FloatToDac(samples[0]) | ((uint32_t)_FloatToDac(samples[1]) << 16));
+		_Store32(dst + 2, _FloatToDac(samples[2]) | ((uint32_t)_FloatToDac(samples[3]) << 16));
+	}
+	for (; nb_frames; nb_frames--, src += 4) {
+		float sample;
+		memcpy(&sample, src, sizeof(sample));
+		*dst++ = _FloatToDac(sample);
+	}
+}
+
+void WavConverter_F32Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames) {
+	for (; nb_frames >= 2; nb_frames -= 2, src += 16, dst += 2) {
+		float frames[4];
+		memcpy(frames, src, sizeof(frames));
+		_Store32(dst, _FloatToDac((frames[0] + frames[1]) * 0.5f) | ((uint32_t)_FloatToDac((frames[2] + frames[3]) * 0.5f) << 16));
+	}
+	if (nb_frames) {
+		float frame[2];
+		memcpy(frame, src, sizeof(frame));
+		*dst = _FloatToDac((frame[0] + frame[1]) * 0.5f);
+	}
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t _Load32(const uint8_t* src) {
+	uint32_t value;
+	memcpy(&value, src, sizeof(value));
+	return value;
+}
+
+void _Store32(uint16_t* dst, uint32_t value) {
+	memcpy(dst, &value, sizeof(value));
+}
+
+/*
+ * sample in [-32768, 32767]
+ */
+uint16_t _ToDac(int32_t sample) {
+	return (uint16_t)(sample ^ 0x8000) >> WAV_DAC_SHIFT;
+}
+
+/*
+ * Clamped to [-1, 1] before the conversion to integer, which is undefined out
+ * of range, NaN is silence
+ */
+uint16_t _FloatToDac(float sample) {
+	if (sample != sample) sample = 0.0f;
+	else if (sample > 1.0f) sample = 1.0f;
+	else if (sample < -1.0f) sample = -1.0f;
+	return _ToDac((int32_t)(sample * 32767.0f));
+}
+
+/*
+ * (L + R) / 2 of a 16 bits stereo frame
+ */
+int32_t _Downmix(uint32_t frame) {
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+	return __smuad(frame, 0x00010001) >> 1;		// dual 16 bits multiply-add in one cycle
+#else
+	return ((int32_t)(int16_t)frame + (int32_t)(int16_t)(frame >> 16)) >> 1;
+#endif
+}
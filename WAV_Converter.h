@@ -0,0 +1,52 @@
+/**
+ ******************************************************************************
+ * @file WAV_Converter.h
+ * @brief WAV converter implementation file
+ *        Convert blocks of PCM frames into DAC values
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * DAC values are right aligned, unsigned (silence at mid scale) and attenuated
+ * by WAV_DAC_ATTENUATION bits. Stereo files are downmixed to one output.
+ ******************************************************************************
+ */
+#ifndef __WAV_CONVERTER_H__
+#define __WAV_CONVERTER_H__
+
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define WAV_DAC_RESOLUTION 	(12)
+#define WAV_DAC_ATTENUATION (5)
+#define WAV_DAC_SHIFT 			(16 - WAV_DAC_RESOLUTION + WAV_DAC_ATTENUATION)
+#define WAV_DAC_SILENCE 		(0x8000 >> WAV_DAC_SHIFT)
+
+#define WAV_FORMAT_PCM 				(0x0001)
+#define WAV_FORMAT_IEEE_FLOAT (0x0003)
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef void (*WAV_Converter)(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+WAV_Converter WavConverter_Select(uint16_t audio_format, uint16_t nb_channels, uint16_t bits_per_sample);
+void WavConverter_U8Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_U8Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_S16Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_S16Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_S24Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_S24Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_F32Mono(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+void WavConverter_F32Stereo(const uint8_t* src, uint16_t* dst, uint32_t nb_frames);
+
+#endif /* __WAV_CONVERTER_H__ */
@@ -5,7 +5,7 @@
  *        Decode WAV file and store in a ring buffer
  *
  * @creation 2024/04/06
- * @edition 2024/04/12
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
@@ -13,20 +13,71 @@
  * @caution
  * only command one DAC (one output), see WavDecoder_GetDacValue()
  *
- * @todo see why there is few dac buffer loop at the and of file reading
- * @todo move end of music condition/actions
+ * @note gapless playback
+ * two tracks, each with its own file and ring buffer. When the playing file
+ * is nearly read, WavDecoder_FeedDacBuffer() opens the queued file on the
+ * other track, parses its header and pre-fills its buffer (TRACK_READY).
+ * The output switches track as soon as the playing buffer is drained, in the
+ * middle of a DAC buffer if needed. The drained track is closed from the main
+ * loop (TRACK_DONE), never from the DMA interrupt.
+ * The track buffers are SPSC_RingBuffer: only the main loop writes them and
+ * only the output reads them, without masking the DAC DMA interrupt.
+ *
+ * @note card reads
+ * the buffer index of a byte is its file offset modulo WAV_BUFFER_SIZE and
+ * the reads end on WAV_READ_ALIGN boundaries (but the last one). After the
+ * first chunk of the file, every read is of whole chunks into a word aligned
+ * span, which SDIO_Interface_ReadFile() passes to FatFs as multi-block reads
+ * without copy. The buffer holds two chunks so that one can be read while
+ * the other plays.
+ *
+ * @note open time
+ * the header is walked chunk by chunk, unneeded chunks are skipped with a
+ * seek whatever their size, at most WAV_MAX_CHUNKS of them. esw_bench wav,
+ * class 10 card model: 1.3 ms worst with a small LIST, 1.9 ms with a 64 kB
+ * or 1 MB one, 7.2 ms for 16 chunks (one read per chunk header).
+ *
+ * @note statistics
+ * the output records the lowest buffer fill and every underrun, i.e. when it
+ * runs dry while the file is not completely read. The bytes missing during
+ * the longest underrun added to the lowest fill seen give the buffer size
+ * which would have played without a click (see esw_sd_latency on the host).
+ * The telemetry gets the lowest fill and the values missing over each
+ * WAV_TELEMETRY_MS, not every render.
+ *
  * @todo manage SDIO_Interface errors
  ******************************************************************************
  */
 #include "WAV_Decoder.h"
-#include "RingBuffer.h"
+#include "WAV_Converter.h"
+#include "Resampler.h"
+#include "SPSC_RingBuffer.h"
 #include "SDIO_Interface.h"
-#include "Shell.h"
+#include "Telemetry.h"
+#include "Trace.h"
+
+#include <stddef.h>
 
 // ------------------------------------------------------------------------
 // -------------------------------- MACROS --------------------------------
 // ------------------------------------------------------------------------
-#define WAV_BUFFER_SIZE (4095)
+#define WAV_BUFFER_SIZE (8192)		// power of two (SPSC_RingBuffer), multiple of WAV_READ_ALIGN
+#define WAV_MAX_BYTE_PER_BLOCK (8)		// 32 bits stereo
+#define WAV_NB_TRACKS (2)							// playing + prefetched
+#define WAV_PREFETCH_DISTANCE (4 * WAV_BUFFER_SIZE)		// bytes left in the playing file when the next one is opened
+#define WAV_READ_ALIGN 				(4096)		// card reads end on read-ahead chunks (SDIO_READ_AHEAD_SIZE)
+
+#define WAV_MAX_CHUNKS 				(16)		// bounds the open time: one 8 bytes read and one seek per chunk
+#define WAV_RIFF_HEADER_SIZE 	(12)
+#define WAV_CHUNK_HEADER_SIZE (8)
+#define WAV_FMT_SIZE 					(16)
+#define WAV_FMT_EXTENSIBLE_SIZE (40)
+#define WAV_FORMAT_EXTENSIBLE (0xFFFE)
+
+#define WAV_MIN_SAMPLE_RATE 	(8000)
+#define WAV_MAX_SAMPLE_RATE 	(48000)
+#define WAV_RESAMPLE_BLOCK 		(64)		// input frames converted per resampler pass
+#define WAV_TELEMETRY_MS 			(50)		// one TLM_WAV_FILL record per period at most
 
 // ------------------------------------------------------------------------
 // ----------------------------- STATIC TYPES -----------------------------
@@ -34,142 +85,487 @@
 typedef enum {
 	BI_UNKNOWN,
 	BI_RIFF,
+	BI_WAVE,
 	BI_FMT_,
 	BI_DATA,
 } BLOCK_ID;
 
+typedef enum {
+	TRACK_IDLE,				// no file open
+	TRACK_PLAYING,
+	TRACK_READY,			// header parsed and buffer pre-filled, waiting for the playing track to end
+	TRACK_DONE,				// drained by the output, file to be closed
+} TRACK_STATE;
+
+typedef struct {
+	volatile TRACK_STATE state;
+	SDIO_FILE 		file;
+	WAV_parameters 	hwav;
+	WAV_Converter 	converter;		// selected once per file from the fmt block
+	SPSC_RingBuffer buffer;		// written by the main loop, read by the output
+	uint32_t 			read_offset;		// file offset of the next card read
+	uint32_t 			raw_buffer[WAV_BUFFER_SIZE / sizeof(uint32_t)];		// word aligned, read straight by the SDIO DMA
+} WAV_track;
+
 // ------------------------------------------------------------------------
 // -------------------------- STATIC PROTOTYPES ---------------------------
 // ------------------------------------------------------------------------
-static WAV_parameters hwav;
+static WAV_track s_tracks[WAV_NB_TRACKS];
+static WAV_track* volatile s_track = &s_tracks[0];		// playing track
+static char* volatile s_next_name;
+
+static Resampler 	s_resampler;
+static uint16_t 	s_frames[WAV_RESAMPLE_BLOCK];
+static uint16_t 	s_last_value = WAV_DAC_SILENCE;
 
-static RingBuffer wav_buffer;
-static uint8_t _buffer[WAV_BUFFER_SIZE];
-static uint8_t read_file_buffer[WAV_BUFFER_SIZE];
+static uint16_t* s_dac_buf;
+static uint32_t  s_dac_half_length;
+
+static WAV_Stats s_stats;
+static uint32_t  s_underrun_deficit;		// bytes missing since the current underrun started
+static uint32_t  s_tlm_tick;						// start of the telemetry period
+static uint32_t  s_tlm_min_fill = WAV_BUFFER_SIZE;		// over the period
+static uint32_t  s_tlm_missing;
 
 // ------------------------------------------------------------------------
 // ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
 // ------------------------------------------------------------------------
-static void 	_ReadHeader();
-static void 	_ReadBlock(BLOCK_ID block_id);
-static BLOCK_ID _ReadBlockID();
-static uint32_t _ReadBlockData(const uint8_t nb_bytes);
-static uint8_t 	_StrCmp(uint8_t* data, char* block_id);
+static WAV_track* _NextTrack(WAV_track* track);
+static WAVRESULT _OpenTrack(WAV_track* track, char* name);
+static void 	_CloseTrack(WAV_track* track);
+static void 	_FeedTrack(WAV_track* track);
+static uint8_t 	_SwitchTrack();
+static void 	_FillBuffer(WAV_track* track, uint32_t length);
+static uint32_t _Render(uint16_t* dac_values, uint32_t nb_values);
+static void 	_UpdateStats(WAV_track* track, uint32_t nb_missing);
+static uint32_t _DecodeFrames(WAV_track* track, uint16_t* dac_values, uint32_t nb_frames);
+static WAVRESULT _ReadHeader(WAV_track* track);
+static WAVRESULT _ReadFormat(WAV_track* track, uint32_t block_size);
+static BLOCK_ID _ReadBlockID(const uint8_t* data);
+static uint32_t _ReadBlockData(const uint8_t* data, const uint8_t nb_bytes);
+static uint8_t 	_StrCmp(const uint8_t* data, char* block_id);
 
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
 void WavDecoder_Init() {
-	RingBuffer_Init(&wav_buffer, _buffer, WAV_BUFFER_SIZE);
+	for (uint8_t cpt = 0; cpt < WAV_NB_TRACKS; cpt++) {
+		s_tracks[cpt].state = TRACK_IDLE;
+		s_tracks[cpt].file  = (SDIO_FILE) cpt;
+		SPSC_RingBuffer_Init(&s_tracks[cpt].buffer, (uint8_t*) s_tracks[cpt].raw_buffer, WAV_BUFFER_SIZE);
+	}
+	s_track = &s_tracks[0];
+	s_next_name = NULL;
+	WavDecoder_ResetStats();
 }
 
-void WavDecoder_OpenFile(char *name) {
-	SDIO_Interface_OpenFile(name);
-	_ReadHeader();
+/*
+ * Stop what is playing and start name right away
+ */
+WAVRESULT WavDecoder_OpenFile(char *name) {
+	WAV_track* track = s_track;
+	
+	s_next_name = NULL;
+	for (uint8_t cpt = 0; cpt < WAV_NB_TRACKS; cpt++) {
+		_CloseTrack(&s_tracks[cpt]);
+	}
+	
+	WAVRESULT result = _OpenTrack(track, name);
+	if (result == WAV_OK) {
+		_FeedTrack(track);		// start with a full buffer, as a prefetched track does
+		Resampler_Init(&s_resampler, track->hwav.sample_rate, WAV_OUTPUT_RATE, WAV_DAC_SILENCE);
+		track->state = TRACK_PLAYING;
+	}
+	return result;
+}
+
+/*
+ * Play name right after the current file, without gap
+ * name must stay valid until the file is opened
+ */
+WAVRESULT WavDecoder_QueueFile(char *name) {
+	if (s_track->state != TRACK_PLAYING)
+		return WavDecoder_OpenFile(name);
+
+	s_next_name = name;
+	return WAV_OK;
+}
+
+uint8_t WavDecoder_IsNextQueued() {
+	return s_next_name != NULL || _NextTrack(s_track)->state == TRACK_READY;
 }
 
 WAV_parameters* WavDecoder_GetMusicData() {
-	return &hwav;
+	return &s_track->hwav;
 }
 
 void WavDecoder_FeedDacBuffer() {
-	if (hwav.remaining_data) {
+	WAV_track* track = s_track;
+	WAV_track* next  = _NextTrack(track);
 	
-		uint32_t buffer_remaining_size = RingBuffer_GetRemainingSize(&wav_buffer);
-		uint32_t buffer_size           = RingBuffer_GetSize(&wav_buffer);
-		
-		uint32_t bytes_to_read = (hwav.remaining_data > buffer_remaining_size) ? buffer_remaining_size : hwav.remaining_data;
+	TRACE_ENTER(TRACE_FEED);
+	if (next->state == TRACK_DONE) {		// the output switched to this track
+		_CloseTrack(next);
+	}
+	
+	if (track->state == TRACK_PLAYING) {
+		_FeedTrack(track);
 		
-		if(buffer_remaining_size > buffer_size) {
-			SDIO_Interface_ReadFile(read_file_buffer, bytes_to_read);
-			RingBuffer_PutSeveral(&wav_buffer, read_file_buffer, bytes_to_read);
-			hwav.remaining_data -= bytes_to_read;
+		if (track->hwav.remaining_data <= WAV_PREFETCH_DISTANCE && next->state == TRACK_IDLE && s_next_name != NULL) {
+			char* name = s_next_name;
+			s_next_name = NULL;
+			if (_OpenTrack(next, name) == WAV_OK) {
+				_FeedTrack(next);
+				next->state = TRACK_READY;		// published last, the output may switch from now on
+			}
 		}
 	}
-}
-
-uint16_t WavDecoder_GetDacValue() { // return ok/error, param in: *dac_value
-	if (RingBuffer_IsEmpty(&wav_buffer)) {
-		if (hwav.remaining_data == 0) {
-			//playing_wav_flag = 0;
-			//__HAL_TIM_SET_AUTORELOAD(WAV_HTIM, (TIM_FREQ / 42000) - 1); // 42000 denined in music.c for hardcoded music
-			SDIO_Interface_CloseFile();
+	else if (track->state == TRACK_DONE) {		// end of playlist, or the next track was not ready in time
+		_CloseTrack(track);
+		if (next->state == TRACK_READY) {
+			Resampler_Init(&s_resampler, next->hwav.sample_rate, WAV_OUTPUT_RATE, s_last_value);
+			next->state = TRACK_PLAYING;
+			s_track = next;
 		}
-		return 0;
 	}
+	TRACE_EXIT(TRACE_FEED);
+}
+
+uint16_t WavDecoder_GetDacValue() {
+	uint16_t value;
 	
-	uint8_t data[hwav.byte_per_block];
-	uint32_t value = 0;
-	
-	RingBuffer_GetSeveral(&wav_buffer, data, hwav.byte_per_block);
+	TRACE_ENTER(TRACE_DAC);
+	_Render(&value, 1);
+	TRACE_EXIT(TRACE_DAC);
+	return value;
+}
+
+void WavDecoder_StartOutput(uint16_t* dac_buf, uint32_t length) {
+	s_dac_buf = dac_buf;
+	s_dac_half_length = length / 2;
 	
-	switch (hwav.byte_per_block) {
-		case 1:
-			value = data[0] << 4;
-			break;
+	_Render(s_dac_buf, s_dac_half_length);
+	_Render(s_dac_buf + s_dac_half_length, s_dac_half_length);
+}
 
-		case 2:
-			value = (data[0] + data[1]) << 4;
-			break;
+void WavDecoder_HalfTransferCallback() {
+	TRACE_ENTER(TRACE_DAC);
+	_Render(s_dac_buf, s_dac_half_length);		// DMA is now reading the second half
+	TRACE_EXIT(TRACE_DAC);
+}
 
-		case 4:
-			value = (((data[1] + data[3]) << 7) | ((data[0] + data[2]) >> 1)) >> 4;
-			value &= 0b0000111111111111;
-	}
-	
-	return value >> 5;
+void WavDecoder_TransferCompleteCallback() {
+	TRACE_ENTER(TRACE_DAC);
+	_Render(s_dac_buf + s_dac_half_length, s_dac_half_length);		// DMA wrapped to the first half
+	TRACE_EXIT(TRACE_DAC);
+}
+
+void WavDecoder_GetStats(WAV_Stats* stats) {
+	*stats = s_stats;
+	stats->min_buffer_size = WAV_BUFFER_SIZE - s_stats.min_fill + s_stats.max_deficit;
+}
+
+void WavDecoder_ResetStats() {
+	s_stats.underruns = 0;
+	s_stats.underrun_values = 0;
+	s_stats.min_fill = WAV_BUFFER_SIZE;
+	s_stats.max_deficit = 0;
+	s_underrun_deficit = 0;
 }
 
 // ------------------------------------------------------------------------
 // -------------------- STATIC FUCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
-void _ReadHeader() {
-	SDIO_Interface_ReadFile(read_file_buffer, WAV_BUFFER_SIZE);
-	RingBuffer_PutSeveral(&wav_buffer, read_file_buffer, WAV_BUFFER_SIZE);
+WAV_track* _NextTrack(WAV_track* track) {
+	return (track == &s_tracks[0]) ? &s_tracks[1] : &s_tracks[0];
+}
+
+WAVRESULT _OpenTrack(WAV_track* track, char* name) {
+	if (SDIO_Interface_OpenFile(track->file, name) != FR_OK)
+		return WAV_FILE_ERROR;
+
+	SPSC_RingBuffer_Init(&track->buffer, (uint8_t*) track->raw_buffer, WAV_BUFFER_SIZE);		// drop what is left of the previous file
+
+	WAVRESULT result = _ReadHeader(track);
+	if (result != WAV_OK) {
+		track->hwav.remaining_data = 0;
+		SDIO_Interface_CloseFile(track->file);
+		return result;
+	}
+
+	uint32_t index = track->read_offset & (WAV_BUFFER_SIZE - 1);		// buffer index = file offset modulo its size
+	SPSC_RingBuffer_Commit(&track->buffer, index);
+	SPSC_RingBuffer_Consume(&track->buffer, index);
+	return WAV_OK;
+}
+
+void _CloseTrack(WAV_track* track) {
+	if (track->state == TRACK_IDLE) return;
+
+	track->state = TRACK_IDLE;		// first, so that the output stops reading it
+	track->hwav.remaining_data = 0;
+	SDIO_Interface_CloseFile(track->file);
+}
+
+void _FeedTrack(WAV_track* track) {
+	if (track->hwav.remaining_data) {
+
+		uint32_t buffer_remaining_size = SPSC_RingBuffer_GetRemainingSize(&track->buffer);
+		uint32_t buffer_size           = SPSC_RingBuffer_GetSize(&track->buffer);
+
+		uint32_t bytes_to_read = (track->hwav.remaining_data > buffer_remaining_size) ? buffer_remaining_size : track->hwav.remaining_data;
+
+		if (bytes_to_read < track->hwav.remaining_data) {		// stop on a sector, the next read starts aligned
+			bytes_to_read -= (track->read_offset + bytes_to_read) & (WAV_READ_ALIGN - 1);
+		}
+		if(buffer_remaining_size > buffer_size && bytes_to_read) {
+			_FillBuffer(track, bytes_to_read);
+			track->hwav.remaining_data -= bytes_to_read;
+			track->read_offset += bytes_to_read;
+		}
+	}
+}
+
+/*
+ * Called by the output when the playing buffer cannot deliver,
+ * returns 1 if playback continues on the next track
+ */
+uint8_t _SwitchTrack() {
+	WAV_track* track = s_track;
+	WAV_track* next  = _NextTrack(track);
+
+	if (track->state != TRACK_PLAYING || track->hwav.remaining_data)
+		return 0;		// not playing, or underrun: the file is not over
+
+	track->state = TRACK_DONE;
+	if (next->state != TRACK_READY)
+		return 0;
+
+	if (track->hwav.sample_rate == WAV_OUTPUT_RATE) {		// resampler was idle
+		Resampler_Init(&s_resampler, next->hwav.sample_rate, WAV_OUTPUT_RATE, s_last_value);
+	}
+	else {
+		Resampler_SetRate(&s_resampler, next->hwav.sample_rate, WAV_OUTPUT_RATE);
+	}
+	next->state = TRACK_PLAYING;
+	s_track = next;
+	return 1;
+}
+
+/*
+ * Read the file straight into the ring buffer storage,
+ * length must not exceed the remaining size of the buffer
+ */
+void _FillBuffer(WAV_track* track, uint32_t length) {
+	uint8_t* span;
 	
-	BLOCK_ID block_id = -1;
-	while (block_id != BI_DATA) {		// infinite loop... bof
-		block_id = _ReadBlockID();
-		_ReadBlock(block_id);
+	while (length) {		// at most two spans, before and after the wrap
+		uint32_t span_length = SPSC_RingBuffer_Reserve(&track->buffer, &span);
+		if (span_length == 0) break;
+		if (span_length > length) span_length = length;
+		
+		SDIO_Interface_ReadFile(track->file, span, span_length);
+		SPSC_RingBuffer_Commit(&track->buffer, span_length);
+		length -= span_length;
 	}
 }
 
-void _ReadBlock(BLOCK_ID block_id) {
-	switch (block_id) {
-		case BI_UNKNOWN: {		// brackets to declare variable in switch case
-			uint32_t bytes_to_skip = _ReadBlockData(4);						// get the number of bytes in the block
-			RingBuffer_IgnoreSeveral(&wav_buffer, bytes_to_skip);	// ignore entire block
+/*
+ * Produce nb_values DAC values at WAV_OUTPUT_RATE, going on with the next
+ * track when the playing one is over. Missing input (underrun or end of
+ * playlist) is replaced by silence.
+ * Returns the number of values produced before the input ran out
+ */
+uint32_t _Render(uint16_t* dac_values, uint32_t nb_values) {
+	uint32_t nb_rendered = 0;
+	
+	while (nb_rendered < nb_values) {
+		WAV_track* track = s_track;
+		uint32_t nb_output = nb_values - nb_rendered;
+
+		if (track->state != TRACK_PLAYING) break;
+
+		if (track->hwav.sample_rate == WAV_OUTPUT_RATE) {		// no resampling needed, decode in place
+			nb_output = _DecodeFrames(track, &dac_values[nb_rendered], nb_output);
+		}
+		else {		// only take the frames the outputs need, the rest stays for the next call
+			uint32_t nb_available = SPSC_RingBuffer_GetSize(&track->buffer) / track->hwav.byte_per_block;
+			if (nb_available > WAV_RESAMPLE_BLOCK) nb_available = WAV_RESAMPLE_BLOCK;
+
+			uint32_t nb_max_output = Resampler_GetOutputCount(&s_resampler, nb_available);
+			if (nb_output > nb_max_output) nb_output = nb_max_output;
+
+			_DecodeFrames(track, s_frames, Resampler_GetInputCount(&s_resampler, nb_output));
+			Resampler_Process(&s_resampler, s_frames, &dac_values[nb_rendered], nb_output);
+		}
+
+		if (nb_output) {
+			nb_rendered += nb_output;
+			s_last_value = dac_values[nb_rendered - 1];
+		}
+		else if (!_SwitchTrack()) {
 			break;
 		}
+	}
+	if (s_track->state == TRACK_PLAYING) {		// file not over: values are missing only on underrun
+		_UpdateStats(s_track, nb_values - nb_rendered);
+	}
+
+	for (uint32_t cpt = nb_rendered; cpt < nb_values; cpt++) {
+		dac_values[cpt] = WAV_DAC_SILENCE;
+	}
+	return nb_rendered;
+}
+
+/*
+ * Called at the end of each render, when the buffer is at its lowest.
+ * nb_missing is the number of DAC values which could not be produced
+ */
+void _UpdateStats(WAV_track* track, uint32_t nb_missing) {
+	if (track->hwav.remaining_data == 0) return;
+
+	uint32_t fill = SPSC_RingBuffer_GetSize(&track->buffer);
+	if (fill < s_stats.min_fill) s_stats.min_fill = fill;
+
+	if (fill < s_tlm_min_fill) s_tlm_min_fill = fill;
+	s_tlm_missing += nb_missing;
+	uint32_t tick = HAL_GetTick();
+	if (tick - s_tlm_tick >= WAV_TELEMETRY_MS) {		// renders run every few ms, send the period summary
+		uint32_t sample[2] = {s_tlm_min_fill, s_tlm_missing};
+		Telemetry_Send(TLM_WAV_FILL, 0, sample, sizeof(sample));
+		s_tlm_tick = tick;
+		s_tlm_min_fill = WAV_BUFFER_SIZE;
+		s_tlm_missing = 0;
+	}
+
+	if (nb_missing == 0) {
+		s_underrun_deficit = 0;		// data is flowing again
+		return;
+	}
+	if (s_underrun_deficit == 0) s_stats.underruns++;
+	s_stats.underrun_values += nb_missing;		// input frames those values would have used, rounded up
+	s_underrun_deficit += (uint32_t)(((uint64_t)nb_missing * track->hwav.sample_rate + WAV_OUTPUT_RATE - 1) / WAV_OUTPUT_RATE) * track->hwav.byte_per_block;
+	if (s_underrun_deficit > s_stats.max_deficit) s_stats.max_deficit = s_underrun_deficit;
+}
+
+/*
+ * Convert up to nb_frames frames of the ring buffer into DAC values,
+ * frames are read in place and only the one split by the wrap is copied
+ */
+uint32_t _DecodeFrames(WAV_track* track, uint16_t* dac_values, uint32_t nb_frames) {
+	const uint32_t frame_size = track->hwav.byte_per_block;
+	uint32_t nb_decoded = 0;
+	
+	if (track->converter == NULL || frame_size == 0 || frame_size > WAV_MAX_BYTE_PER_BLOCK) return 0;
+	
+	while (nb_decoded < nb_frames && SPSC_RingBuffer_GetSize(&track->buffer) >= frame_size) {
+		const uint8_t* span;
+		uint32_t span_frames = SPSC_RingBuffer_Peek(&track->buffer, &span) / frame_size;
+		
+		if (span_frames == 0) {		// frame split by the end of the buffer
+			uint8_t data[WAV_MAX_BYTE_PER_BLOCK];
+			SPSC_RingBuffer_GetSeveral(&track->buffer, data, frame_size);
+			track->converter(data, &dac_values[nb_decoded++], 1);
+			continue;
+		}
 		
-		case BI_RIFF:
-			hwav.file_size = _ReadBlockData(4);
-			RingBuffer_IgnoreSeveral(&wav_buffer, 4);		// ingnore file format (WAVE)
-			break;
+		if (span_frames > nb_frames - nb_decoded) span_frames = nb_frames - nb_decoded;
+		track->converter(span, &dac_values[nb_decoded], span_frames);
+		SPSC_RingBuffer_Consume(&track->buffer, span_frames * frame_size);
+		nb_decoded += span_frames;
+	}
+	return nb_decoded;
+}
+
+/*
+ * Walk the RIFF chunks with only the 8 bytes headers read, every chunk which
+ * is not needed (LIST, id3, fact...) is skipped with a seek, whatever its size.
+ * Leaves the file positioned at the start of the audio data.
+ */
+WAVRESULT _ReadHeader(WAV_track* track) {
+	uint8_t header[WAV_RIFF_HEADER_SIZE];
+	uint32_t file_size = SDIO_Interface_GetFileSize(track->file);
+	uint8_t format_found = 0;
+	
+	if (file_size < WAV_RIFF_HEADER_SIZE || SDIO_Interface_ReadFile(track->file, header, WAV_RIFF_HEADER_SIZE) != FR_OK)
+		return WAV_FILE_ERROR;
+	if (_ReadBlockID(header) != BI_RIFF || _ReadBlockID(&header[8]) != BI_WAVE)
+		return WAV_NOT_RIFF;
+	track->hwav.file_size = _ReadBlockData(&header[4], 4);
+	
+	uint32_t offset = WAV_RIFF_HEADER_SIZE;
+	for (uint8_t cpt = 0; cpt < WAV_MAX_CHUNKS; cpt++) {
+		if (offset + WAV_CHUNK_HEADER_SIZE > file_size || SDIO_Interface_ReadFile(track->file, header, WAV_CHUNK_HEADER_SIZE) != FR_OK)
+			return WAV_NO_DATA;
 		
-		case BI_FMT_:
-			RingBuffer_IgnoreSeveral(&wav_buffer, 4);		// ignore block size (16)
-			hwav.audio_format 		= _ReadBlockData(2);
-			hwav.nb_channels 		= _ReadBlockData(2);
-			hwav.sample_rate 		= _ReadBlockData(4);
-			hwav.byte_per_sec 		= _ReadBlockData(4);
-			hwav.byte_per_block 	= _ReadBlockData(2);
-			hwav.bits_per_sample	= _ReadBlockData(2);
-			break;
+		uint32_t block_size = _ReadBlockData(&header[4], 4);
+		offset += WAV_CHUNK_HEADER_SIZE;
 		
-		case BI_DATA:
-			hwav.remaining_data = _ReadBlockData(4);
-			break;
+		switch (_ReadBlockID(header)) {
+			case BI_FMT_: {		// brackets to declare variable in switch case
+				WAVRESULT result = _ReadFormat(track, block_size);
+				if (result != WAV_OK) return result;
+				format_found = 1;
+				break;
+			}
+			
+			case BI_DATA:
+				if (!format_found) return WAV_NO_FORMAT;
+				track->hwav.data_size = block_size;
+				track->read_offset = offset;
+				track->hwav.remaining_data = (block_size > file_size - offset) ? file_size - offset : block_size;	// truncated file
+				return WAV_OK;
+			
+			default:
+				break;
+		}
+		
+		if (block_size > file_size - offset)
+			return WAV_NO_DATA;
+		offset += block_size + (block_size & 1);		// chunks are padded to an even size
+		if (SDIO_Interface_SeekFile(track->file, offset) != FR_OK)
+			return WAV_NO_DATA;
 	}
+	return WAV_NO_DATA;
 }
 
-BLOCK_ID _ReadBlockID() {
-	uint8_t data[4];
-	RingBuffer_GetSeveral(&wav_buffer, data, 4);
+WAVRESULT _ReadFormat(WAV_track* track, uint32_t block_size) {
+	WAV_parameters* hwav = &track->hwav;
+	uint8_t data[WAV_FMT_EXTENSIBLE_SIZE];
+	uint32_t length = (block_size > WAV_FMT_EXTENSIBLE_SIZE) ? WAV_FMT_EXTENSIBLE_SIZE : block_size;
+	
+	if (block_size < WAV_FMT_SIZE || SDIO_Interface_ReadFile(track->file, data, length) != FR_OK)
+		return WAV_NO_FORMAT;
+	
+	hwav->block_size 			= block_size;
+	hwav->audio_format 		= _ReadBlockData(&data[0], 2);
+	hwav->nb_channels 		= _ReadBlockData(&data[2], 2);
+	hwav->sample_rate 		= _ReadBlockData(&data[4], 4);
+	hwav->byte_per_sec 		= _ReadBlockData(&data[8], 4);
+	hwav->byte_per_block 	= _ReadBlockData(&data[12], 2);
+	hwav->bits_per_sample	= _ReadBlockData(&data[14], 2);
+	
+	if (hwav->audio_format == WAV_FORMAT_EXTENSIBLE && length == WAV_FMT_EXTENSIBLE_SIZE) {
+		hwav->audio_format = _ReadBlockData(&data[24], 2);		// first bytes of the SubFormat GUID
+	}
 	
+	track->converter = WavConverter_Select(hwav->audio_format, hwav->nb_channels, hwav->bits_per_sample);
+	if (track->converter == NULL || hwav->byte_per_block > WAV_MAX_BYTE_PER_BLOCK)
+		return WAV_UNSUPPORTED_FORMAT;
+	if (hwav->byte_per_block != hwav->nb_channels * hwav->bits_per_sample / 8)		// the converters read packed frames
+		return WAV_UNSUPPORTED_FORMAT;
+	if (hwav->sample_rate < WAV_MIN_SAMPLE_RATE || hwav->sample_rate > WAV_MAX_SAMPLE_RATE)
+		return WAV_UNSUPPORTED_FORMAT;
+	return WAV_OK;
+}
+
+BLOCK_ID _ReadBlockID(const uint8_t* data) {
 	if (_StrCmp(data, "RIFF")) {
 		return BI_RIFF;
 	}
+	if (_StrCmp(data, "WAVE")) {
+		return BI_WAVE;
+	}
 	if (_StrCmp(data, "fmt ")) {
 		return BI_FMT_;
 	}
@@ -179,19 +575,16 @@ BLOCK_ID _ReadBlockID() {
 	return BI_UNKNOWN;
 }
 
-uint32_t _ReadBlockData(const uint8_t nb_bytes) {
-	uint8_t data[nb_bytes];
-	RingBuffer_GetSeveral(&wav_buffer, data, nb_bytes);
-	
-	uint64_t value = 0;
+uint32_t _ReadBlockData(const uint8_t* data, const uint8_t nb_bytes) {
+	uint32_t value = 0;
 	
 	for(uint8_t cpt = 0; cpt < nb_bytes; cpt++) {
-		value += data[cpt] << (8 * cpt);
+		value |= (uint32_t)data[cpt] << (8 * cpt);
 	}
 	return value;
 }
 
-uint8_t _StrCmp(uint8_t* data, char* block_id) {
+uint8_t _StrCmp(const uint8_t* data, char* block_id) {
 	for (uint8_t cpt = 0; cpt < 4; cpt++) {
 		if (data[cpt] != block_id[cpt]) {
 			return 0;
@@ -199,5 +592,3 @@ uint8_t _StrCmp(uint8_t* data, char* block_id) {
 	}
 	return 1;
 }
-
-
@@ -5,13 +5,23 @@
  *        Decode WAV file and store in a ring buffer
  *
  * @creation 2024/04/06
- * @edition 2024/04/12
+ * @edition 2026/10/17
  * 
  * @author Guillaume Dauguen
  *
  ******************************************************************************
  * @caution
  * only command one DAC (one output), see WavDecoder_GetDacValue()
+ * the sample timer always runs at WAV_OUTPUT_RATE, files are resampled to it
+ * WavDecoder_QueueFile() plays the next file without gap, it is opened and
+ * pre-loaded by WavDecoder_FeedDacBuffer() which must be called from the main loop
+ ******************************************************************************
+ * @setup DMA output (replaces the per sample WavDecoder_GetDacValue() call)
+ * 			WavDecoder_StartOutput(dac_buf, LENGTH);
+ * 			HAL_DAC_Start_DMA(&hdac, DAC_CHANNEL_1, (uint32_t*) dac_buf, LENGTH, DAC_ALIGN_12B_R);
+ * 		with a circular DMA triggered by the sample timer, and
+ * 			WavDecoder_HalfTransferCallback(); in HAL_DAC_ConvHalfCpltCallbackCh1()
+ * 			WavDecoder_TransferCompleteCallback(); in HAL_DAC_ConvCpltCallbackCh1()
  ******************************************************************************
  */
 #ifndef __WAV_DECODER_H__
@@ -19,6 +29,11 @@
 
 #include <stdint.h>
 
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define WAV_OUTPUT_RATE (44100)		// DAC sample timer frequency, every file is resampled to it
+
 // ------------------------------------------------------------------------
 // ----------------------------- PUBLIC TYPES -----------------------------
 // ------------------------------------------------------------------------
@@ -39,13 +54,37 @@ typedef struct {
 	char* title;
 } WAV_parameters;
 
+typedef enum {
+	WAV_OK = 0,
+	WAV_FILE_ERROR,
+	WAV_NOT_RIFF,
+	WAV_NO_FORMAT,
+	WAV_NO_DATA,
+	WAV_UNSUPPORTED_FORMAT,
+} WAVRESULT;
+
+typedef struct {
+	uint32_t underruns;					// times the output ran dry while the file was not over
+	uint32_t underrun_values;		// DAC values replaced by silence by those underruns
+	uint32_t min_fill;					// lowest buffer fill seen by the output while the file was not over, bytes
+	uint32_t max_deficit;				// bytes missing during the longest underrun
+	uint32_t min_buffer_size;		// buffer which would have absorbed every stall seen, bytes
+} WAV_Stats;
+
 // ------------------------------------------------------------------------
 // ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
 // ------------------------------------------------------------------------
 void     WavDecoder_Init();
-void     WavDecoder_OpenFile(char *name);
+WAVRESULT WavDecoder_OpenFile(char *name);
+WAVRESULT WavDecoder_QueueFile(char *name);
+uint8_t  WavDecoder_IsNextQueued();
 WAV_parameters* WavDecoder_GetMusicData();
 uint16_t WavDecoder_GetDacValue();
 void     WavDecoder_FeedDacBuffer();
+void     WavDecoder_StartOutput(uint16_t* dac_buf, uint32_t length);
+void     WavDecoder_HalfTransferCallback();
+void     WavDecoder_TransferCompleteCallback();
+void     WavDecoder_GetStats(WAV_Stats* stats);
+void     WavDecoder_ResetStats();
 
 #endif /* __WAV_DECODER_H__ */
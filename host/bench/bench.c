@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * @file bench.c
+ * @brief Benchmark implementation file
+ *        Micro-benchmarks of the libraries on the host
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @setup
+ * 			esw_bench            every suite
+ * 			esw_bench wav coder  the suites named
+ * 			esw_bench --quick    every suite, 1/100 of the operations (smoke test)
+ ******************************************************************************
+ */
+#include "bench.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	const char* name;
+	void (*run)(void);
+} BENCH_Suite;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const BENCH_Suite s_suites[] = {
+	{"ringbuffer", Bench_RingBuffer},
+	{"converter",  Bench_Converter},
+	{"resampler",  Bench_Resampler},
+	{"wav", 			 Bench_Wav},
+	{"coder", 		 Bench_Coder},
+	{"shell", 		 Bench_Shell},
+};
+
+static uint32_t s_divider = 1;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+	bool selected = false;
+
+	for (int arg = 1; arg < argc; arg++) {
+		if (strcmp(argv[arg], "--quick") == 0) s_divider = 100;
+	}
+	for (int arg = 1; arg < argc; arg++) {
+		for (unsigned cpt = 0; cpt < sizeof(s_suites) / sizeof(s_suites[0]); cpt++) {
+			if (strcmp(argv[arg], s_suites[cpt].name) == 0) {
+				s_suites[cpt].run();
+				selected = true;
+			}
+		}
+	}
+	if (!selected) {
+		for (unsigned cpt = 0; cpt < sizeof(s_suites) / sizeof(s_suites[0]); cpt++) s_suites[cpt].run();
+	}
+	return 0;
+}
+
+uint64_t Bench_Now(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+uint64_t Bench_Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	uint64_t value;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+	return value;
+#else
+	return 0;
+#endif
+}
+
+/*
+ * Best of BENCH_REPEAT runs of nb_ops operations
+ */
+Bench_Result Bench_Run(Bench_Function function, void* context, uint32_t nb_ops) {
+	Bench_Result best = {0, 0};
+
+	if (nb_ops == 0) nb_ops = 1;
+	function(context, nb_ops / 10 + 1);		// warm the caches
+	for (int run = 0; run < BENCH_REPEAT; run++) {
+		uint64_t start = Bench_Now();
+		uint64_t start_cycles = Bench_Cycles();
+		function(context, nb_ops);
+		double cycles = (double)(Bench_Cycles() - start_cycles) / nb_ops;
+		double ns = (double)(Bench_Now() - start) / nb_ops;
+
+		if (run == 0 || ns < best.ns) {
+			best.ns = ns;
+			best.cycles = cycles;
+		}
+	}
+	return best;
+}
+
+/*
+ * One line: ns/op, cycles/op and, when bytes_per_op is given, MB/s and bytes/cycle
+ */
+void Bench_Print(const char* name, Bench_Result result, uint32_t bytes_per_op) {
+	printf("  %-40s %10.1f ns/op %10.1f cyc/op", name, result.ns, result.cycles);
+	if (bytes_per_op) {
+		printf(" %9.1f MB/s", bytes_per_op * 1000.0 / result.ns);
+		if (result.cycles > 0) printf(" %6.2f B/cyc", bytes_per_op / result.cycles);
+	}
+	printf("\n");
+}
+
+void Bench_Header(const char* suite) {
+	printf("%s\n", suite);
+}
+
+/*
+ * Operations of a measure, reduced by --quick
+ */
+uint32_t Bench_Scale(uint32_t nb_ops) {
+	return (nb_ops / s_divider) ? nb_ops / s_divider : 1;
+}
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file bench.h
+ * @brief Benchmark implementation file
+ *        Timing helpers shared by the benchmark suites
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * times are wall clock ns (CLOCK_MONOTONIC), cycles are the TSC on x86 and
+ * the virtual counter on aarch64, 0 elsewhere. Each measure keeps the best
+ * of BENCH_REPEAT runs, the lowest being the least disturbed by the host.
+ ******************************************************************************
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define BENCH_REPEAT (5)
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	double ns;				// per operation
+	double cycles;		// per operation
+} Bench_Result;
+
+typedef void (*Bench_Function)(void* context, uint32_t nb_ops);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint64_t Bench_Now(void);
+uint64_t Bench_Cycles(void);
+Bench_Result Bench_Run(Bench_Function function, void* context, uint32_t nb_ops);
+void Bench_Print(const char* name, Bench_Result result, uint32_t bytes_per_op);
+void Bench_Header(const char* suite);
+uint32_t Bench_Scale(uint32_t nb_ops);
+
+void Bench_RingBuffer(void);
+void Bench_Converter(void);
+void Bench_Resampler(void);
+void Bench_Wav(void);
+void Bench_Coder(void);
+void Bench_Shell(void);
+
+#endif /* __BENCH_H__ */
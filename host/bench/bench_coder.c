@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file bench_coder.c
+ * @brief Benchmark implementation file
+ *        Coder captures processed by CoderInterface_Run()
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the captures are written in the ring as the DMA would, CODER_BENCH_BATCH
+ * per CoderInterface_Run() call. One operation is one capture. The float
+ * copy of the same estimator (coder_float.c) gets the same widths with the
+ * gains of the coder, its accuracy is checked by test_coder.
+ ******************************************************************************
+ */
+#include "bench.h"
+#include "CoderInterface.h"
+#include "coder_float.h"
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define CODER_BENCH_CAPTURES 	(256)
+#define CODER_BENCH_BATCH 		(32)
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	Coder coder;
+	uint32_t width;		// ticks between captures
+	uint32_t counter;
+	CoderFloat reference;
+} BENCH_Coder;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint32_t s_captures[CODER_BENCH_CAPTURES];
+static DMA_HandleTypeDef s_hdma;
+static TIM_HandleTypeDef s_htim;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Capture(void* context, uint32_t nb_ops);
+static void _CaptureFloat(void* context, uint32_t nb_ops);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Bench_Coder(void) {
+#ifndef CODER_ENCODER_MODE
+	static const uint32_t widths[] = {400, 40, 4};		// ~0.3, 3.3 and 33 turns/s
+	static BENCH_Coder bench;
+
+	Bench_Header("coder (one op = one capture)");
+	Host_InitDma(&s_hdma);
+	s_htim.Instance = TIM3;
+	s_htim.Instance->ARR = 0xFFFF;
+	s_htim.hdma[TIM_DMA_ID_CC1] = &s_hdma;
+	if (!CoderInterface_Init(&bench.coder, &s_htim, TIM_CHANNEL_1, s_captures, CODER_BENCH_CAPTURES)) return;
+
+	for (unsigned cpt = 0; cpt < sizeof(widths) / sizeof(widths[0]); cpt++) {
+		char name[48];
+		bench.width = widths[cpt];
+		snprintf(name, sizeof(name), "CoderInterface_Run width %u", (unsigned) widths[cpt]);
+		Bench_Print(name, Bench_Run(_Capture, &bench, Bench_Scale(10000000)), 0);
+		CoderFloat_Init(&bench.reference, bench.coder.filter.alpha / 65536.0f, bench.coder.filter.beta / 65536.0f);
+		snprintf(name, sizeof(name), "float estimator width %u", (unsigned) widths[cpt]);
+		Bench_Print(name, Bench_Run(_CaptureFloat, &bench, Bench_Scale(10000000)), 0);
+	}
+#endif
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Capture(void* context, uint32_t nb_ops) {
+#ifndef CODER_ENCODER_MODE
+	BENCH_Coder* bench = context;
+	uint32_t done = 0;
+
+	while (done < nb_ops) {
+		for (uint32_t cpt = 0; cpt < CODER_BENCH_BATCH; cpt++) {
+			uint32_t position = s_hdma.length - s_hdma.Instance->NDTR;
+
+			bench->counter = (bench->counter + bench->width) & 0xFFFF;
+			s_captures[position] = bench->counter;
+			if (--s_hdma.Instance->NDTR == 0) s_hdma.Instance->NDTR = s_hdma.length;
+		}
+		CoderInterface_Run(&bench->coder);
+		done += CODER_BENCH_BATCH;
+	}
+#else
+	(void) context;
+	(void) nb_ops;
+#endif
+}
+
+/*
+ * Same captures and widths as _Capture, through the float estimator
+ */
+void _CaptureFloat(void* context, uint32_t nb_ops) {
+	BENCH_Coder* bench = context;
+	uint32_t last = bench->counter;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		bench->counter = (bench->counter + bench->width) & 0xFFFF;
+		CoderFloat_Update(&bench->reference, (bench->counter - last) & 0xFFFF, 1);
+		last = bench->counter;
+	}
+}
@@ -0,0 +1,111 @@
+/**
+ ******************************************************************************
+ * @file bench_converter.c
+ * @brief Benchmark implementation file
+ *        PCM to DAC conversion kernels
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * one operation is one frame. Each kernel converts blocks of
+ * CONVERTER_BENCH_BLOCK frames, as _DecodeFrames() does with a ring buffer
+ * span, then one frame per call, as the per sample output did.
+ ******************************************************************************
+ */
+#include "bench.h"
+#include "WAV_Converter.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define CONVERTER_BENCH_BLOCK (256)
+#define CONVERTER_BENCH_BYTES (CONVERTER_BENCH_BLOCK * 8)		// 32 bits stereo
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	const char* 	name;
+	uint16_t 			audio_format;
+	uint16_t 			nb_channels;
+	uint16_t 			bits_per_sample;
+} BENCH_Format;
+
+typedef struct {
+	WAV_Converter converter;
+	uint32_t 			frame_size;
+	uint32_t 			block;		// frames per call
+} BENCH_Kernel;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const BENCH_Format s_formats[] = {
+	{"U8Mono",    WAV_FORMAT_PCM, 1, 8},
+	{"U8Stereo",  WAV_FORMAT_PCM, 2, 8},
+	{"S16Mono",   WAV_FORMAT_PCM, 1, 16},
+	{"S16Stereo", WAV_FORMAT_PCM, 2, 16},
+	{"S24Mono",   WAV_FORMAT_PCM, 1, 24},
+	{"S24Stereo", WAV_FORMAT_PCM, 2, 24},
+	{"F32Mono",   WAV_FORMAT_IEEE_FLOAT, 1, 32},
+	{"F32Stereo", WAV_FORMAT_IEEE_FLOAT, 2, 32},
+};
+
+static uint8_t  s_src[CONVERTER_BENCH_BYTES];
+static uint16_t s_dst[CONVERTER_BENCH_BLOCK];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Convert(void* context, uint32_t nb_ops);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Bench_Converter(void) {
+	char name[64];
+
+	Bench_Header("converter (one op = one frame)");
+	for (uint32_t cpt = 0; cpt < sizeof(s_src); cpt++) {
+		s_src[cpt] = (uint8_t)(cpt * 73 + 5);
+	}
+	for (uint32_t cpt = 0; cpt < CONVERTER_BENCH_BYTES; cpt += 4) {		// finite floats for the F32 kernels
+		float sample = (float)(int8_t) s_src[cpt] / 128.0f;
+		memcpy(&s_src[cpt], &sample, sizeof(sample));
+	}
+
+	for (uint32_t cpt = 0; cpt < sizeof(s_formats) / sizeof(s_formats[0]); cpt++) {
+		const BENCH_Format* format = &s_formats[cpt];
+		BENCH_Kernel kernel = {
+			.converter = WavConverter_Select(format->audio_format, format->nb_channels, format->bits_per_sample),
+			.frame_size = format->nb_channels * format->bits_per_sample / 8,
+		};
+
+		kernel.block = CONVERTER_BENCH_BLOCK;
+		snprintf(name, sizeof(name), "WavConverter_%s block %u", format->name, CONVERTER_BENCH_BLOCK);
+		Bench_Print(name, Bench_Run(_Convert, &kernel, Bench_Scale(20000000)), kernel.frame_size);
+		kernel.block = 1;
+		snprintf(name, sizeof(name), "WavConverter_%s frame by frame", format->name);
+		Bench_Print(name, Bench_Run(_Convert, &kernel, Bench_Scale(5000000)), kernel.frame_size);
+	}
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Convert(void* context, uint32_t nb_ops) {
+	const BENCH_Kernel* kernel = context;
+	uint32_t frame = 0;
+
+	for (uint32_t done = 0; done < nb_ops; done += kernel->block) {
+		kernel->converter(&s_src[frame * kernel->frame_size], &s_dst[frame], kernel->block);
+		frame = (frame + kernel->block) % CONVERTER_BENCH_BLOCK;
+	}
+}
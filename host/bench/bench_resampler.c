@@ -0,0 +1,75 @@
+/**
+ ******************************************************************************
+ * @file bench_resampler.c
+ * @brief Benchmark implementation file
+ *        Resampler block processing and ratio error
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * one operation is one output sample, produced by blocks of
+ * RESAMPLER_BENCH_BLOCK as _Render() does. The ratio error is the Q16 step
+ * against the exact input / output ratio.
+ ******************************************************************************
+ */
+#include "bench.h"
+#include "Resampler.h"
+#include "WAV_Decoder.h"
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define RESAMPLER_BENCH_BLOCK (64)		// WAV_RESAMPLE_BLOCK
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint16_t s_input[2 * RESAMPLER_BENCH_BLOCK];
+static uint16_t s_output[RESAMPLER_BENCH_BLOCK];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Process(void* context, uint32_t nb_ops);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Bench_Resampler(void) {
+	static const uint32_t rates[] = {8000, 11025, 16000, 22050, 32000, 48000};
+	char name[64];
+
+	Bench_Header("resampler (one op = one output sample at WAV_OUTPUT_RATE)");
+	for (uint32_t cpt = 0; cpt < sizeof(s_input) / sizeof(s_input[0]); cpt++) {
+		s_input[cpt] = (uint16_t)(cpt * 97);
+	}
+
+	for (uint32_t cpt = 0; cpt < sizeof(rates) / sizeof(rates[0]); cpt++) {
+		Resampler rs;
+		double exact = (double) rates[cpt] * RESAMPLER_ONE / WAV_OUTPUT_RATE;
+
+		Resampler_Init(&rs, rates[cpt], WAV_OUTPUT_RATE, 0);
+		snprintf(name, sizeof(name), "Resampler_Process %u Hz", (unsigned) rates[cpt]);
+		Bench_Print(name, Bench_Run(_Process, &rs, Bench_Scale(20000000)), 0);
+		printf("    ratio error %+.1f ppm, bound %.1f ppm\n", (rs.step - exact) / exact * 1e6, 0.5 / exact * 1e6);
+	}
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Process(void* context, uint32_t nb_ops) {
+	Resampler* rs = context;
+
+	for (uint32_t done = 0; done < nb_ops; done += RESAMPLER_BENCH_BLOCK) {
+		uint32_t nb_input = Resampler_GetInputCount(rs, RESAMPLER_BENCH_BLOCK);		// at most 2 blocks below 88.2 kHz
+		Resampler_Process(rs, s_input, s_output, RESAMPLER_BENCH_BLOCK);
+		__asm__ volatile("" :: "r"(nb_input) : "memory");
+	}
+}
@@ -0,0 +1,190 @@
+/**
+ ******************************************************************************
+ * @file bench_ringbuffer.c
+ * @brief Benchmark implementation file
+ *        RingBuffer and SPSC_RingBuffer accesses
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the block accesses are compared with the byte per byte loops they
+ * replaced (_LoopPutSeveral, _LoopGetSeveral), on the same ring. The ring
+ * size is not a power of two, as the WAV buffer was, and the blocks move
+ * along it so that a share of them is split by the wrap.
+ ******************************************************************************
+ */
+#include "bench.h"
+#include "RingBuffer.h"
+#include "SPSC_RingBuffer.h"
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _STORAGE_SIZE (8192)
+#define _MAX_BLOCK 		(4096)
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	RingBuffer ring;
+	SPSC_RingBuffer spsc;
+	uint32_t length;
+} BENCH_Rings;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint8_t s_storage[_STORAGE_SIZE];
+static uint8_t s_data[_MAX_BLOCK];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _LoopPutSeveral(RingBuffer* buf, const uint8_t* data, uint32_t length);
+static void _LoopGetSeveral(RingBuffer* buf, uint8_t* data, uint32_t length);
+static void _PutGet(void* context, uint32_t nb_ops);
+static void _LoopPutGetSeveral(void* context, uint32_t nb_ops);
+static void _PutGetSeveral(void* context, uint32_t nb_ops);
+static void _Init(void* context, uint32_t nb_ops);
+static void _InitNoClear(void* context, uint32_t nb_ops);
+static void _SpscPutGet(void* context, uint32_t nb_ops);
+static void _SpscPutGetSeveral(void* context, uint32_t nb_ops);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Bench_RingBuffer(void) {
+	static const uint32_t lengths[] = {1, 4, 16, 64, 256, 1024, 4096};
+	const uint32_t nb_lengths = sizeof(lengths) / sizeof(lengths[0]);
+	BENCH_Rings rings;
+	char name[64];
+
+	Bench_Header("ringbuffer (one op = put then get of the block)");
+	RingBuffer_InitNoClear(&rings.ring, s_storage, _STORAGE_SIZE - 1);
+	Bench_Print("RingBuffer_Put/Get", Bench_Run(_PutGet, &rings, Bench_Scale(10000000)), 1);
+	for (uint32_t cpt = 0; cpt < nb_lengths; cpt++) {
+		uint32_t nb_ops = Bench_Scale(4000000 / (lengths[cpt] < 16 ? 16 : lengths[cpt]));
+
+		rings.length = lengths[cpt];
+		snprintf(name, sizeof(name), "byte loop %u B", lengths[cpt]);
+		Bench_Print(name, Bench_Run(_LoopPutGetSeveral, &rings, nb_ops), lengths[cpt]);
+		snprintf(name, sizeof(name), "RingBuffer_Put/GetSeveral %u B", lengths[cpt]);
+		Bench_Print(name, Bench_Run(_PutGetSeveral, &rings, nb_ops), lengths[cpt]);
+	}
+
+	rings.length = 4095;		// WAV_BUFFER_SIZE
+	Bench_Print("RingBuffer_Init 4095 B", Bench_Run(_Init, &rings, Bench_Scale(200000)), rings.length);
+	Bench_Print("RingBuffer_InitNoClear 4095 B", Bench_Run(_InitNoClear, &rings, Bench_Scale(200000)), rings.length);
+
+	SPSC_RingBuffer_Init(&rings.spsc, s_storage, _STORAGE_SIZE);
+	Bench_Print("SPSC_RingBuffer_Put/Get", Bench_Run(_SpscPutGet, &rings, Bench_Scale(10000000)), 1);
+	for (uint32_t cpt = 0; cpt < nb_lengths; cpt++) {
+		rings.length = lengths[cpt];
+		snprintf(name, sizeof(name), "SPSC_RingBuffer_Put/GetSeveral %u B", lengths[cpt]);
+		Bench_Print(name, Bench_Run(_SpscPutGetSeveral, &rings, Bench_Scale(4000000 / (lengths[cpt] < 16 ? 16 : lengths[cpt]))), lengths[cpt]);
+	}
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Reference: the RingBuffer_PutSeveral loop before the block copy
+ */
+void _LoopPutSeveral(RingBuffer* buf, const uint8_t* data, uint32_t length) {
+	if (length > RingBuffer_GetRemainingSize(buf))
+		return;
+
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		buf->buf[buf->ptr_write++] = data[cpt];
+		if (buf->ptr_write >= buf->max_size)
+			buf->ptr_write = 0;
+	}
+	buf->size += length;
+}
+
+/*
+ * Reference: the RingBuffer_GetSeveral loop before the block copy
+ */
+void _LoopGetSeveral(RingBuffer* buf, uint8_t* data, uint32_t length) {
+	if (length > RingBuffer_GetSize(buf))
+		return;
+
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		data[cpt] = buf->buf[buf->ptr_read++];
+		if (buf->ptr_read >= buf->max_size)
+			buf->ptr_read = 0;
+	}
+	buf->size -= length;
+}
+
+void _PutGet(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+	uint8_t byte;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		RingBuffer_Put(&rings->ring, (uint8_t) cpt);
+		RingBuffer_Get(&rings->ring, &byte);
+	}
+}
+
+void _LoopPutGetSeveral(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		_LoopPutSeveral(&rings->ring, s_data, rings->length);
+		_LoopGetSeveral(&rings->ring, s_data, rings->length);
+	}
+}
+
+void _PutGetSeveral(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		RingBuffer_PutSeveral(&rings->ring, s_data, rings->length);
+		RingBuffer_GetSeveral(&rings->ring, s_data, rings->length);
+	}
+}
+
+void _Init(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		RingBuffer_Init(&rings->ring, s_storage, rings->length);
+	}
+}
+
+void _InitNoClear(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		RingBuffer_InitNoClear(&rings->ring, s_storage, rings->length);
+		__asm__ volatile("" ::: "memory");		// not merged with the next call
+	}
+}
+
+void _SpscPutGet(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+	uint8_t byte;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		SPSC_RingBuffer_Put(&rings->spsc, (uint8_t) cpt);
+		SPSC_RingBuffer_Get(&rings->spsc, &byte);
+	}
+}
+
+void _SpscPutGetSeveral(void* context, uint32_t nb_ops) {
+	BENCH_Rings* rings = context;
+
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		SPSC_RingBuffer_PutSeveral(&rings->spsc, s_data, rings->length);
+		SPSC_RingBuffer_GetSeveral(&rings->spsc, s_data, rings->length);
+	}
+}
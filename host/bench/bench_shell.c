@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * @file bench_shell.c
+ * @brief Benchmark implementation file
+ *        Shell transmission, formatting and interrupt driven sending
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#include "bench.h"
+#include "Shell.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define SHELL_BENCH_RX_SIZE (512)
+#define SHELL_BENCH_TX_SIZE (4096)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static Shell s_shell;
+static UART_HandleTypeDef s_huart;
+static uint8_t s_rx[SHELL_RX_STORAGE_SIZE(SHELL_BENCH_RX_SIZE)];
+static uint8_t s_tx[SHELL_BENCH_TX_SIZE];
+
+static const char s_line[] = "the quick brown fox jumps over\r\n";		// 32 bytes
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _PrintString(void* context, uint32_t nb_ops);
+static void _Printf(void* context, uint32_t nb_ops);
+static void _Sprintf(void* context, uint32_t nb_ops);
+static void _SendIRQ(void* context, uint32_t nb_ops);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Bench_Shell(void) {
+	Bench_Header("shell (one op = one 32 bytes message)");
+	s_huart.Instance = USART2;
+	if (!Shell_Init(&s_shell, &s_huart, s_rx, SHELL_BENCH_RX_SIZE, s_tx, SHELL_BENCH_TX_SIZE, UART_MODE_IT)) return;
+
+	Bench_Print("Shell_PrintString", Bench_Run(_PrintString, NULL, Bench_Scale(2000000)), sizeof(s_line) - 1);
+	Bench_Print("Shell_Printf", Bench_Run(_Printf, NULL, Bench_Scale(1000000)), sizeof(s_line) - 1);
+	Bench_Print("sprintf + Shell_PrintString", Bench_Run(_Sprintf, NULL, Bench_Scale(1000000)), sizeof(s_line) - 1);
+	Bench_Print("PrintString + TXE interrupts", Bench_Run(_SendIRQ, NULL, Bench_Scale(500000)), sizeof(s_line) - 1);
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _PrintString(void* context, uint32_t nb_ops) {
+	(void) context;
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		Shell_PrintString(&s_shell, s_line);
+		if (SPSC_RingBuffer_GetRemainingSize(&s_shell.tx_buffer) < sizeof(s_line)) {
+			SPSC_RingBuffer_IgnoreSeveral(&s_shell.tx_buffer, SPSC_RingBuffer_GetSize(&s_shell.tx_buffer));
+		}
+	}
+}
+
+void _Printf(void* context, uint32_t nb_ops) {
+	(void) context;
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		Shell_Printf(&s_shell, "speed %5u fill %4u 0x%08x\r\n", cpt & 0xFFFF, cpt & 0xFFF, cpt);
+		if (SPSC_RingBuffer_GetRemainingSize(&s_shell.tx_buffer) < sizeof(s_line)) {
+			SPSC_RingBuffer_IgnoreSeveral(&s_shell.tx_buffer, SPSC_RingBuffer_GetSize(&s_shell.tx_buffer));
+		}
+	}
+}
+
+/*
+ * Same line as _Printf, formatted in a stack buffer as the library did
+ */
+void _Sprintf(void* context, uint32_t nb_ops) {
+	char line[128];
+
+	(void) context;
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		sprintf(line, "speed %5u fill %4u 0x%08x\r\n", cpt & 0xFFFF, cpt & 0xFFF, cpt);
+		Shell_PrintString(&s_shell, line);
+		if (SPSC_RingBuffer_GetRemainingSize(&s_shell.tx_buffer) < sizeof(s_line)) {
+			SPSC_RingBuffer_IgnoreSeveral(&s_shell.tx_buffer, SPSC_RingBuffer_GetSize(&s_shell.tx_buffer));
+		}
+	}
+}
+
+void _SendIRQ(void* context, uint32_t nb_ops) {
+	(void) context;
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		Shell_PrintString(&s_shell, s_line);
+		while (SPSC_RingBuffer_IsNotEmpty(&s_shell.tx_buffer)) {
+			UART_Interface_IRQHandler(USART2);
+		}
+	}
+}
@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file bench_wav.c
+ * @brief Benchmark implementation file
+ *        WAV decoder output, fed from a FAT image in memory
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * one operation renders WAV_BENCH_HALF DAC values, as a DMA half transfer
+ * interrupt does, followed by the main loop feed. The file is kept queued
+ * after itself, so that it loops without gap. The card reads of each file
+ * are summed up after its timing.
+ *
+ * @note open time
+ * WavDecoder_OpenFile() walks the chunks and fills the track buffer. It is
+ * timed on the host, then WAV_BENCH_OPENS times with the card latency model
+ * of a class 10 card (HostFat_SetLatency): worst and mean simulated time,
+ * over small and large metadata chunks and the most chunks walked. Seeks
+ * are free, FatFs is taken to have the FAT sectors cached.
+ ******************************************************************************
+ */
+#include "bench.h"
+#include "host_fat.h"
+#include "wav_file.h"
+#include "SDIO_Interface.h"
+#include "WAV_Decoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define WAV_BENCH_HALF 			(256)		// DAC values per half transfer
+#define WAV_BENCH_SECONDS 	(4)
+#define WAV_BENCH_IMAGE 		(8 * 1024 * 1024)
+#define WAV_BENCH_OPENS 		(200)
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	const char* 		name;		// 8.3
+	WavFile_Format 	format;
+} BENCH_WavFile;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const BENCH_WavFile s_files[] = {
+	{"S16_44K.WAV", {.audio_format = 1, .nb_channels = 2, .sample_rate = 44100, .bits_per_sample = 16}},
+	{"U8_22K.WAV",  {.audio_format = 1, .nb_channels = 1, .sample_rate = 22050, .bits_per_sample = 8}},
+	{"S24_48K.WAV", {.audio_format = 1, .nb_channels = 2, .sample_rate = 48000, .bits_per_sample = 24}},
+};
+
+static const BENCH_WavFile s_open_files[] = {
+	{"META_S.WAV",  {.audio_format = 1, .nb_channels = 2, .sample_rate = 44100, .bits_per_sample = 16, .list_size = 100}},
+	{"META_L.WAV",  {.audio_format = 1, .nb_channels = 2, .sample_rate = 44100, .bits_per_sample = 16, .list_size = 64 * 1024}},
+	{"META_XL.WAV", {.audio_format = 1, .nb_channels = 2, .sample_rate = 44100, .bits_per_sample = 16, .list_size = 1024 * 1024 + 1}},
+	{"CHUNKS.WAV",  {.audio_format = 1, .nb_channels = 2, .sample_rate = 44100, .bits_per_sample = 16, .list_size = 3000, .nb_lists = 14}},
+};
+
+static const HostFat_Latency s_card = {300, 20, 200, 0, 0};		// fixed, per sector, jitter: class 10 card
+
+static uint16_t s_dac_buf[2 * WAV_BENCH_HALF];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static bool _AddFile(const BENCH_WavFile* file);
+static void _Play(void* context, uint32_t nb_ops);
+static void _Open(void* context, uint32_t nb_ops);
+static void _OpenTime(const char* name);
+static void _PrintReads(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Bench_Wav(void) {
+	const uint32_t nb_files = sizeof(s_files) / sizeof(s_files[0]);
+	char name[64];
+
+	Bench_Header("wav (one op = one half transfer of 256 values + feed)");
+	if (!HostFat_Format(WAV_BENCH_IMAGE, 8)) return;
+	for (uint32_t cpt = 0; cpt < nb_files; cpt++) {
+		if (!_AddFile(&s_files[cpt])) return;
+	}
+	for (uint32_t cpt = 0; cpt < sizeof(s_open_files) / sizeof(s_open_files[0]); cpt++) {
+		if (!_AddFile(&s_open_files[cpt])) return;
+	}
+	if (SDIO_Interface_MountSD() != FR_OK) return;
+
+	WavDecoder_Init();
+	for (uint32_t cpt = 0; cpt < nb_files; cpt++) {
+		const WavFile_Format* format = &s_files[cpt].format;
+		uint32_t bytes = (uint32_t)((uint64_t) WAV_BENCH_HALF * format->sample_rate / WAV_OUTPUT_RATE) * format->nb_channels * format->bits_per_sample / 8;
+
+		if (WavDecoder_OpenFile((char*) s_files[cpt].name) != WAV_OK) {
+			printf("%s: cannot open\n", s_files[cpt].name);
+			continue;
+		}
+		WavDecoder_StartOutput(s_dac_buf, 2 * WAV_BENCH_HALF);
+		snprintf(name, sizeof(name), "render %s", s_files[cpt].name);
+		SDIO_Interface_ResetStats();
+		HostFat_ResetStats();
+		Bench_Print(name, Bench_Run(_Play, (void*) s_files[cpt].name, Bench_Scale(200000)), bytes);
+		_PrintReads();
+	}
+	for (uint32_t cpt = 0; cpt < sizeof(s_open_files) / sizeof(s_open_files[0]); cpt++) {
+		_OpenTime(s_open_files[cpt].name);
+	}
+	SDIO_Interface_UnmountSD();
+	HostFat_Release();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool _AddFile(const BENCH_WavFile* file) {
+	const WavFile_Format* format = &file->format;
+	uint32_t length = WAV_BENCH_SECONDS * format->sample_rate * format->nb_channels * format->bits_per_sample / 8;
+	uint8_t* data = malloc(length);
+	uint8_t* wav = malloc(WavFile_Size(format, length));
+	bool result = false;
+
+	if (data != NULL && wav != NULL) {
+		for (uint32_t cpt = 0; cpt < length; cpt++) {
+			data[cpt] = (uint8_t)(cpt * 37 + (cpt >> 8));
+		}
+		result = HostFat_AddFile(file->name, wav, WavFile_Build(wav, format, data, length), false);
+	}
+	free(data);
+	free(wav);
+	return result;
+}
+
+void _Play(void* context, uint32_t nb_ops) {
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		if (cpt & 1) WavDecoder_TransferCompleteCallback();
+		else 				 WavDecoder_HalfTransferCallback();
+		WavDecoder_FeedDacBuffer();
+
+		if (!WavDecoder_IsNextQueued()) {
+			WavDecoder_QueueFile((char*) context);		// loop on the same file, without gap
+		}
+	}
+}
+
+void _Open(void* context, uint32_t nb_ops) {
+	for (uint32_t cpt = 0; cpt < nb_ops; cpt++) {
+		WavDecoder_OpenFile((char*) context);
+	}
+}
+
+/*
+ * Host time of an open, then simulated time with the card latency
+ */
+void _OpenTime(const char* name) {
+	uint64_t worst_us = 0, total_us = 0;
+	HostFat_Stats disk;
+	char label[64];
+
+	if (WavDecoder_OpenFile((char*) name) != WAV_OK) {
+		printf("%s: cannot open\n", name);
+		return;
+	}
+	snprintf(label, sizeof(label), "open %s", name);
+	Bench_Print(label, Bench_Run(_Open, (void*) name, Bench_Scale(2000)), 0);
+
+	HostFat_SetLatency(&s_card);
+	HostFat_ResetStats();
+	for (uint32_t cpt = 0; cpt < WAV_BENCH_OPENS; cpt++) {
+		uint64_t start = Host_GetTimeUs();
+		WavDecoder_OpenFile((char*) name);
+		uint64_t elapsed = Host_GetTimeUs() - start;
+
+		total_us += elapsed;
+		if (elapsed > worst_us) worst_us = elapsed;
+	}
+	HostFat_SetLatency(NULL);
+	HostFat_GetStats(&disk);
+	printf("    class 10 card: worst %.2f ms, mean %.2f ms, %.1f disk commands per open\n",
+		worst_us / 1000.0, total_us / 1000.0 / WAV_BENCH_OPENS, (double) disk.commands / WAV_BENCH_OPENS);
+}
+
+/*
+ * How the card was read: f_read calls, multi-sector ones, bytes copied from
+ * the read-ahead buffer and the block device commands behind them
+ */
+void _PrintReads(void) {
+	SDIO_Stats sdio;
+	HostFat_Stats disk;
+
+	SDIO_Interface_GetStats(&sdio);
+	HostFat_GetStats(&disk);
+	printf("    f_read %u (multi-sector %u%%, %u B avg), copied %u%%, disk commands %u (%.1f sectors avg)\n",
+		(unsigned) sdio.sd_reads, (unsigned)(sdio.sd_reads ? 100ULL * sdio.multi_sector_reads / sdio.sd_reads : 0),
+		(unsigned)(sdio.sd_reads ? sdio.sd_bytes / sdio.sd_reads : 0),
+		(unsigned)(sdio.bytes_delivered ? 100ULL * sdio.bytes_copied / sdio.bytes_delivered : 0),
+		(unsigned) disk.commands, disk.commands ? (double) disk.sectors / disk.commands : 0.0);
+}
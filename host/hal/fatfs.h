@@ -0,0 +1,20 @@
+/**
+ ******************************************************************************
+ * @file fatfs.h
+ * @brief Host FatFs header
+ *        Stand-in for the CubeMX fatfs.h
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#ifndef __FATFS_H__
+#define __FATFS_H__
+
+#include "main.h"
+#include "ff.h"
+
+#endif /* __FATFS_H__ */
@@ -0,0 +1,129 @@
+/**
+ ******************************************************************************
+ * @file ff.h
+ * @brief Host FatFs implementation file
+ *        Read-only stand-in for the FatFs API, on a FAT image in memory
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * same names, types and results as FatFs R0.12 for the functions the
+ * libraries call. The volume is set up with the host_fat.h functions before
+ * f_mount(): built from a Linux directory, loaded from an image file or
+ * formatted and filled by a test.
+ ******************************************************************************
+ */
+#ifndef __FF_H__
+#define __FF_H__
+
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define FF_SECTOR_SIZE (512)
+
+#define FA_READ 	(0x01)
+
+#define AM_RDO 	(0x01)
+#define AM_HID 	(0x02)
+#define AM_SYS 	(0x04)
+#define AM_VOL 	(0x08)
+#define AM_LFN 	(0x0F)
+#define AM_DIR 	(0x10)
+#define AM_ARC 	(0x20)
+
+#define FS_FAT12 (1)
+#define FS_FAT16 (2)
+#define FS_FAT32 (3)
+
+#define f_size(fp) ((fp)->objsize)
+#define f_tell(fp) ((fp)->fptr)
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef unsigned int 	UINT;
+typedef unsigned char BYTE;
+typedef uint16_t 			WORD;
+typedef uint32_t 			DWORD;
+typedef DWORD 				FSIZE_t;
+typedef char 					TCHAR;
+
+typedef enum {
+	FR_OK = 0,
+	FR_DISK_ERR,
+	FR_INT_ERR,
+	FR_NOT_READY,
+	FR_NO_FILE,
+	FR_NO_PATH,
+	FR_INVALID_NAME,
+	FR_DENIED,
+	FR_EXIST,
+	FR_INVALID_OBJECT,
+	FR_WRITE_PROTECTED,
+	FR_INVALID_DRIVE,
+	FR_NOT_ENABLED,
+	FR_NO_FILESYSTEM,
+	FR_MKFS_ABORTED,
+	FR_TIMEOUT,
+	FR_LOCKED,
+	FR_NOT_ENOUGH_CORE,
+	FR_TOO_MANY_OPEN_FILES,
+	FR_INVALID_PARAMETER,
+} FRESULT;
+
+typedef struct {
+	BYTE 	fs_type;		// FS_FAT12/16/32, 0 when not mounted
+	WORD 	csize;			// sectors per cluster
+	DWORD n_fatent;		// clusters + 2
+	DWORD fatbase;		// sectors
+	DWORD dirbase;		// root directory sector (FAT12/16) or cluster (FAT32)
+	DWORD database;
+	WORD 	n_rootdir;	// root directory entries (FAT12/16)
+} FATFS;
+
+typedef struct {
+	FATFS* 	fs;
+	DWORD 	sclust;		// first cluster
+	FSIZE_t objsize;
+	FSIZE_t fptr;
+	DWORD 	clust;		// cluster of fptr
+	DWORD 	cindex;		// index of clust in the file
+	DWORD 	sect;			// sector in the window, 0 if none
+	BYTE 		buf[FF_SECTOR_SIZE];		// sector window of the partial reads
+} FIL;
+
+typedef struct {
+	FATFS* fs;
+	DWORD sclust;		// 0 for the FAT12/16 root directory
+	UINT 	index;		// next entry
+} DIR;
+
+typedef struct {
+	FSIZE_t fsize;
+	WORD 	fdate;
+	WORD 	ftime;
+	BYTE 	fattrib;
+	TCHAR fname[13];
+} FILINFO;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+FRESULT f_mount(FATFS* fs, const TCHAR* path, BYTE opt);
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode);
+FRESULT f_close(FIL* fp);
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br);
+FRESULT f_lseek(FIL* fp, FSIZE_t ofs);
+FRESULT f_stat(const TCHAR* path, FILINFO* fno);
+FRESULT f_opendir(DIR* dp, const TCHAR* path);
+FRESULT f_readdir(DIR* dp, FILINFO* fno);
+FRESULT f_closedir(DIR* dp);
+FRESULT f_getfree(const TCHAR* path, DWORD* nclst, FATFS** fatfs);
+
+#endif /* __FF_H__ */
@@ -0,0 +1,600 @@
+/**
+ ******************************************************************************
+ * @file ff_host.c
+ * @brief Host FatFs implementation file
+ *        Read-only stand-in for the FatFs API, on a FAT image in memory
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note reads
+ * f_read() does what FatFs does with the card: whole sectors at a sector
+ * aligned position are read straight into the caller buffer, several at once
+ * up to the end of the cluster, the rest goes through the one sector window
+ * of the file. Only those data reads go through the block device, FAT and
+ * directory sectors are read from the image as if FatFs had them cached.
+ * Only the data reads take simulated time (HostFat_SetLatency).
+ ******************************************************************************
+ */
+#include "ff.h"
+#include "host_fat.h"
+#include "stm32_host.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _SS 				(FF_SECTOR_SIZE)
+#define _DIR_SIZE 	(32)
+#define _ROOT_ENTRIES (512)
+#define _DATE 			((46 << 9) | (10 << 5) | 17)		// 2026/10/17
+#define _TIME 			((12 << 11) | (0 << 5))
+
+#define _FREE_ENTRY 	(0xE5)
+#define _EOC 					(0x0FFFFFFF)		// end of chain, any FAT type
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint8_t* s_image;
+static uint32_t s_image_size;
+static FATFS* 	s_fs;					// mounted volume
+static FATFS 		s_volume;			// layout of the image, copied by f_mount()
+static uint32_t s_next_cluster;		// allocation of HostFat_AddFile()
+static HostFat_Stats s_stats;
+static HostFat_Latency s_latency;		// zero: instant reads
+static uint32_t s_latency_commands;
+static uint32_t s_latency_seed = 1;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static bool 		_ReadLayout(FATFS* fs);
+static void 		_DiskRead(uint8_t* buff, uint32_t sector, uint32_t count);
+static uint32_t _GetEntry(const FATFS* fs, uint32_t cluster);
+static void 		_SetEntry(const FATFS* fs, uint32_t cluster, uint32_t value);
+static bool 		_IsEOC(const FATFS* fs, uint32_t value);
+static uint32_t _ClusterSector(const FATFS* fs, uint32_t cluster);
+static uint8_t* _DirEntry(const FATFS* fs, uint32_t sclust, uint32_t index);
+static uint8_t* _Find(const FATFS* fs, const char* path);
+static bool 		_ToShortName(const char* name, uint32_t length, uint8_t* short_name);
+static void 		_FillInfo(const uint8_t* entry, FILINFO* fno);
+static uint32_t _EntryCluster(const FATFS* fs, const uint8_t* entry);
+static bool 		_SeekCluster(FIL* fp, uint32_t cluster_index);
+static uint16_t _Read16(const uint8_t* data);
+static uint32_t _Read32(const uint8_t* data);
+static void 		_Write16(uint8_t* data, uint16_t value);
+static void 		_Write32(uint8_t* data, uint32_t value);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Empty volume of size bytes, FAT12 or FAT16 depending on the cluster count
+ */
+bool HostFat_Format(uint32_t size, uint8_t sectors_per_cluster) {
+	uint32_t nb_sectors = size / _SS;
+	uint32_t root_sectors = _ROOT_ENTRIES * _DIR_SIZE / _SS;
+	uint32_t fat_sectors = 1;
+	uint32_t nb_clusters = 0;
+	uint8_t  fs_type = FS_FAT16;
+
+	if (sectors_per_cluster == 0 || (sectors_per_cluster & (sectors_per_cluster - 1)) || nb_sectors > 0xFFFF * 64) return false;
+	for (int cpt = 0; cpt < 8; cpt++) {		// the FAT size and the cluster count depend on each other
+		if (1 + root_sectors + 2 * fat_sectors >= nb_sectors) return false;
+		nb_clusters = (nb_sectors - 1 - root_sectors - 2 * fat_sectors) / sectors_per_cluster;
+		fs_type = (nb_clusters < 4085) ? FS_FAT12 : FS_FAT16;
+		uint32_t fat_bytes = (fs_type == FS_FAT12) ? (nb_clusters + 2) * 3 / 2 + 1 : (nb_clusters + 2) * 2;
+		fat_sectors = (fat_bytes + _SS - 1) / _SS;
+	}
+	if (nb_clusters > 65524) return false;
+
+	HostFat_Release();
+	s_image = calloc(1, nb_sectors * _SS);
+	if (s_image == NULL) return false;
+	s_image_size = nb_sectors * _SS;
+
+	uint8_t* boot = s_image;
+	memcpy(boot, "\xEB\x3C\x90" "HOSTFAT ", 11);
+	_Write16(&boot[11], _SS);
+	boot[13] = sectors_per_cluster;
+	_Write16(&boot[14], 1);							// reserved sectors
+	boot[16] = 2;												// FATs
+	_Write16(&boot[17], _ROOT_ENTRIES);
+	if (nb_sectors < 0x10000) _Write16(&boot[19], nb_sectors);
+	else _Write32(&boot[32], nb_sectors);
+	boot[21] = 0xF8;										// fixed disk
+	_Write16(&boot[22], fat_sectors);
+	boot[38] = 0x29;
+	memcpy(&boot[43], "HOST       ", 11);
+	memcpy(&boot[54], (fs_type == FS_FAT12) ? "FAT12   " : "FAT16   ", 8);
+	boot[510] = 0x55;
+	boot[511] = 0xAA;
+
+	if (!_ReadLayout(&s_volume)) return false;
+	_SetEntry(&s_volume, 0, 0xFFFFFFF8);
+	_SetEntry(&s_volume, 1, _EOC);
+	s_next_cluster = 2;
+	return true;
+}
+
+/*
+ * name is a 8.3 name of the root directory. A fragmented file leaves a free
+ * cluster after each of its clusters
+ */
+bool HostFat_AddFile(const char* name, const void* data, uint32_t length, bool fragmented) {
+	uint8_t short_name[11];
+	uint32_t cluster_size = s_volume.csize * _SS;
+	uint32_t nb_clusters = (length + cluster_size - 1) / cluster_size;
+	uint32_t step = fragmented ? 2 : 1;
+	uint8_t* entry = NULL;
+
+	if (s_image == NULL || !_ToShortName(name, strlen(name), short_name)) return false;
+	if (s_next_cluster + nb_clusters * step > s_volume.n_fatent) return false;
+
+	for (uint32_t index = 0; index < s_volume.n_rootdir; index++) {
+		uint8_t* candidate = _DirEntry(&s_volume, 0, index);
+		if (memcmp(candidate, short_name, 11) == 0) return false;		// exists
+		if (candidate[0] == 0 || candidate[0] == _FREE_ENTRY) {
+			entry = candidate;
+			break;
+		}
+	}
+	if (entry == NULL) return false;
+
+	uint32_t first = nb_clusters ? s_next_cluster : 0;
+	for (uint32_t cpt = 0; cpt < nb_clusters; cpt++) {
+		uint32_t cluster = s_next_cluster;
+		uint32_t chunk = (length - cpt * cluster_size > cluster_size) ? cluster_size : length - cpt * cluster_size;
+
+		memcpy(&s_image[_ClusterSector(&s_volume, cluster) * _SS], (const uint8_t*) data + cpt * cluster_size, chunk);
+		s_next_cluster += step;
+		_SetEntry(&s_volume, cluster, (cpt + 1 < nb_clusters) ? s_next_cluster : _EOC);
+	}
+
+	memset(entry, 0, _DIR_SIZE);
+	memcpy(entry, short_name, 11);
+	entry[11] = AM_ARC;
+	_Write16(&entry[22], _TIME);
+	_Write16(&entry[24], _DATE);
+	_Write16(&entry[26], first);
+	_Write32(&entry[28], length);
+	return true;
+}
+
+bool HostFat_LoadImage(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) return false;
+
+	HostFat_Release();
+	fseek(file, 0, SEEK_END);
+	s_image_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	s_image = malloc(s_image_size);
+	bool result = s_image && fread(s_image, 1, s_image_size, file) == s_image_size && _ReadLayout(&s_volume);
+	fclose(file);
+	s_next_cluster = s_volume.n_fatent;		// no room known, files are not added to a loaded image
+	return result;
+}
+
+bool HostFat_SaveImage(const char* path) {
+	FILE* file = fopen(path, "wb");
+	if (file == NULL || s_image == NULL) return false;
+
+	bool result = fwrite(s_image, 1, s_image_size, file) == s_image_size;
+	fclose(file);
+	return result;
+}
+
+void HostFat_Release(void) {
+	free(s_image);
+	s_image = NULL;
+	s_image_size = 0;
+	memset(&s_volume, 0, sizeof(s_volume));
+	if (s_fs) s_fs->fs_type = 0;
+	s_fs = NULL;
+}
+
+void HostFat_GetStats(HostFat_Stats* stats) {
+	*stats = s_stats;
+}
+
+void HostFat_ResetStats(void) {
+	memset(&s_stats, 0, sizeof(s_stats));
+}
+
+/*
+ * NULL for instant reads, the stall count and the jitter sequence restart
+ */
+void HostFat_SetLatency(const HostFat_Latency* latency) {
+	if (latency) s_latency = *latency;
+	else memset(&s_latency, 0, sizeof(s_latency));
+	s_latency_commands = 0;
+	s_latency_seed = 1;
+}
+
+FRESULT f_mount(FATFS* fs, const TCHAR* path, BYTE opt) {
+	(void) path;
+	(void) opt;
+	if (fs == NULL) {		// unmount
+		if (s_fs) s_fs->fs_type = 0;
+		s_fs = NULL;
+		return FR_OK;
+	}
+	if (s_image == NULL || s_volume.fs_type == 0) return FR_NOT_READY;
+
+	*fs = s_volume;
+	s_fs = fs;
+	return FR_OK;
+}
+
+FRESULT f_open(FIL* fp, const TCHAR* path, BYTE mode) {
+	if (s_fs == NULL) return FR_NOT_ENABLED;
+	if (mode != FA_READ) return FR_WRITE_PROTECTED;
+
+	uint8_t* entry = _Find(s_fs, path);
+	if (entry == NULL) return FR_NO_FILE;
+	if (entry[11] & AM_DIR) return FR_NO_FILE;
+
+	memset(fp, 0, sizeof(FIL));
+	fp->fs = s_fs;
+	fp->sclust = _EntryCluster(s_fs, entry);
+	fp->objsize = _Read32(&entry[28]);
+	fp->clust = fp->sclust;
+	return FR_OK;
+}
+
+FRESULT f_close(FIL* fp) {
+	if (fp->fs == NULL) return FR_INVALID_OBJECT;
+	fp->fs = NULL;
+	return FR_OK;
+}
+
+FRESULT f_read(FIL* fp, void* buff, UINT btr, UINT* br) {
+	uint8_t* dst = buff;
+	FATFS* fs = fp->fs;
+	uint32_t cluster_size = fs ? fs->csize * _SS : 0;
+
+	*br = 0;
+	if (fs == NULL || fs != s_fs) return FR_INVALID_OBJECT;
+	if (btr > fp->objsize - fp->fptr) btr = fp->objsize - fp->fptr;
+
+	while (btr) {
+		if (!_SeekCluster(fp, fp->fptr / cluster_size)) return FR_INT_ERR;
+		uint32_t csect = (fp->fptr % cluster_size) / _SS;
+		uint32_t sector = _ClusterSector(fs, fp->clust) + csect;
+		uint32_t read;
+
+		if (fp->fptr % _SS == 0 && btr >= _SS) {		// whole sectors, straight into the buffer
+			uint32_t count = btr / _SS;
+			if (csect + count > fs->csize) count = fs->csize - csect;
+			_DiskRead(dst, sector, count);
+			read = count * _SS;
+		}
+		else {
+			if (fp->sect != sector) {
+				_DiskRead(fp->buf, sector, 1);
+				fp->sect = sector;
+			}
+			uint32_t offset = fp->fptr % _SS;
+			read = _SS - offset;
+			if (read > btr) read = btr;
+			memcpy(dst, &fp->buf[offset], read);
+		}
+		dst += read;
+		fp->fptr += read;
+		*br += read;
+		btr -= read;
+	}
+	return FR_OK;
+}
+
+FRESULT f_lseek(FIL* fp, FSIZE_t ofs) {
+	if (fp->fs == NULL || fp->fs != s_fs) return FR_INVALID_OBJECT;
+
+	fp->fptr = (ofs > fp->objsize) ? fp->objsize : ofs;		// read-only, no extension
+	return FR_OK;
+}
+
+FRESULT f_stat(const TCHAR* path, FILINFO* fno) {
+	if (s_fs == NULL) return FR_NOT_ENABLED;
+
+	uint8_t* entry = _Find(s_fs, path);
+	if (entry == NULL) return FR_NO_FILE;
+	_FillInfo(entry, fno);
+	return FR_OK;
+}
+
+FRESULT f_opendir(DIR* dp, const TCHAR* path) {
+	if (s_fs == NULL) return FR_NOT_ENABLED;
+
+	memset(dp, 0, sizeof(DIR));
+	dp->fs = s_fs;
+	while (*path == '/') path++;
+	if (*path) {
+		uint8_t* entry = _Find(s_fs, path);
+		if (entry == NULL || !(entry[11] & AM_DIR)) return FR_NO_PATH;
+		dp->sclust = _EntryCluster(s_fs, entry);
+	}
+	else if (s_fs->fs_type == FS_FAT32) {
+		dp->sclust = s_fs->dirbase;
+	}
+	return FR_OK;
+}
+
+/*
+ * fname[0] is 0 at the end of the directory, dot entries are skipped
+ */
+FRESULT f_readdir(DIR* dp, FILINFO* fno) {
+	for (;;) {
+		uint8_t* entry = _DirEntry(dp->fs, dp->sclust, dp->index);
+		if (entry == NULL || entry[0] == 0) {
+			fno->fname[0] = 0;
+			return FR_OK;
+		}
+		dp->index++;
+		if (entry[0] == _FREE_ENTRY || entry[0] == '.' || (entry[11] & AM_LFN) == AM_LFN || (entry[11] & AM_VOL)) continue;
+		_FillInfo(entry, fno);
+		return FR_OK;
+	}
+}
+
+FRESULT f_closedir(DIR* dp) {
+	dp->fs = NULL;
+	return FR_OK;
+}
+
+FRESULT f_getfree(const TCHAR* path, DWORD* nclst, FATFS** fatfs) {
+	(void) path;
+	if (s_fs == NULL) return FR_NOT_ENABLED;
+
+	uint32_t nb_free = 0;
+	for (uint32_t cluster = 2; cluster < s_fs->n_fatent; cluster++) {
+		nb_free += _GetEntry(s_fs, cluster) == 0;
+	}
+	*nclst = nb_free;
+	*fatfs = s_fs;
+	return FR_OK;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Volume layout from the boot sector, the FAT type from the cluster count
+ */
+bool _ReadLayout(FATFS* fs) {
+	const uint8_t* boot = s_image;
+
+	memset(fs, 0, sizeof(FATFS));
+	if (s_image_size < _SS || boot[510] != 0x55 || boot[511] != 0xAA || _Read16(&boot[11]) != _SS) return false;
+
+	uint32_t fat_sectors = _Read16(&boot[22]) ? _Read16(&boot[22]) : _Read32(&boot[36]);
+	uint32_t nb_sectors = _Read16(&boot[19]) ? _Read16(&boot[19]) : _Read32(&boot[32]);
+	fs->csize = boot[13];
+	fs->n_rootdir = _Read16(&boot[17]);
+	fs->fatbase = _Read16(&boot[14]);
+	uint32_t root_sectors = fs->n_rootdir * _DIR_SIZE / _SS;
+	fs->database = fs->fatbase + boot[16] * fat_sectors + root_sectors;
+	if (fs->csize == 0 || nb_sectors * _SS > s_image_size || fs->database >= nb_sectors) return false;
+
+	uint32_t nb_clusters = (nb_sectors - fs->database) / fs->csize;
+	fs->n_fatent = nb_clusters + 2;
+	fs->fs_type = (nb_clusters < 4085) ? FS_FAT12 : (nb_clusters < 65525) ? FS_FAT16 : FS_FAT32;
+	fs->dirbase = (fs->fs_type == FS_FAT32) ? _Read32(&boot[44]) : fs->fatbase + boot[16] * fat_sectors;
+	return true;
+}
+
+/*
+ * Data sectors of the files
+ */
+void _DiskRead(uint8_t* buff, uint32_t sector, uint32_t count) {
+	uint64_t delay = s_latency.fixed_us + (uint64_t) s_latency.sector_us * count;
+
+	if (s_latency.jitter_us) {
+		s_latency_seed = s_latency_seed * 1664525 + 1013904223;		// LCG, the high bits are the most random
+		delay += (s_latency_seed >> 8) % (s_latency.jitter_us + 1);
+	}
+	if (s_latency.stall_period && ++s_latency_commands >= s_latency.stall_period) {
+		s_latency_commands = 0;
+		delay += s_latency.stall_us;
+	}
+	if (delay) Host_Advance(delay);		// the interrupts due meanwhile run first, the data arrives at the end
+
+	memcpy(buff, &s_image[sector * _SS], count * _SS);
+	s_stats.commands++;
+	s_stats.sectors += count;
+	s_stats.busy_us += delay;
+	if (count >= 2) s_stats.multi_sector++;
+}
+
+uint32_t _GetEntry(const FATFS* fs, uint32_t cluster) {
+	const uint8_t* fat = &s_image[fs->fatbase * _SS];
+
+	switch (fs->fs_type) {
+	case FS_FAT12: {
+		uint16_t value = _Read16(&fat[cluster + cluster / 2]);
+		return (cluster & 1) ? value >> 4 : value & 0x0FFF;
+	}
+	case FS_FAT16:
+		return _Read16(&fat[cluster * 2]);
+	default:
+		return _Read32(&fat[cluster * 4]) & 0x0FFFFFFF;
+	}
+}
+
+/*
+ * In both FATs of a FAT12/16 volume
+ */
+void _SetEntry(const FATFS* fs, uint32_t cluster, uint32_t value) {
+	uint32_t fat_sectors = (fs->dirbase - fs->fatbase) / 2;
+
+	for (uint32_t copy = 0; copy < 2; copy++) {
+		uint8_t* fat = &s_image[(fs->fatbase + copy * fat_sectors) * _SS];
+
+		if (fs->fs_type == FS_FAT12) {
+			uint8_t* entry = &fat[cluster + cluster / 2];
+			uint16_t current = _Read16(entry);
+			value &= 0x0FFF;
+			_Write16(entry, (cluster & 1) ? (current & 0x000F) | (value << 4) : (current & 0xF000) | value);
+		}
+		else {
+			_Write16(&fat[cluster * 2], value);
+		}
+	}
+}
+
+bool _IsEOC(const FATFS* fs, uint32_t value) {
+	switch (fs->fs_type) {
+	case FS_FAT12: return value >= 0xFF8;
+	case FS_FAT16: return value >= 0xFFF8;
+	default: 			 return value >= 0x0FFFFFF8;
+	}
+}
+
+uint32_t _ClusterSector(const FATFS* fs, uint32_t cluster) {
+	return fs->database + (cluster - 2) * fs->csize;
+}
+
+/*
+ * Entry index of the directory starting at sclust (0: FAT12/16 root),
+ * NULL past its end
+ */
+uint8_t* _DirEntry(const FATFS* fs, uint32_t sclust, uint32_t index) {
+	if (sclust == 0) {
+		if (index >= fs->n_rootdir) return NULL;
+		return &s_image[fs->dirbase * _SS + index * _DIR_SIZE];
+	}
+
+	uint32_t per_cluster = fs->csize * _SS / _DIR_SIZE;
+	uint32_t cluster = sclust;
+	for (uint32_t cpt = index / per_cluster; cpt; cpt--) {
+		cluster = _GetEntry(fs, cluster);
+		if (cluster < 2 || _IsEOC(fs, cluster)) return NULL;
+	}
+	return &s_image[_ClusterSector(fs, cluster) * _SS + (index % per_cluster) * _DIR_SIZE];
+}
+
+/*
+ * Entry of a path such as "/MUSIC/SONG.WAV", "0:/SONG.WAV" or "song.wav"
+ */
+uint8_t* _Find(const FATFS* fs, const char* path) {
+	uint32_t sclust = (fs->fs_type == FS_FAT32) ? fs->dirbase : 0;
+	uint8_t* entry = NULL;
+
+	if (path[0] >= '0' && path[0] <= '9' && path[1] == ':') path += 2;
+	while (*path) {
+		uint8_t short_name[11];
+
+		while (*path == '/') path++;
+		if (*path == 0) break;
+		uint32_t length = strcspn(path, "/");
+		if (!_ToShortName(path, length, short_name)) return NULL;
+		if (entry && !(entry[11] & AM_DIR)) return NULL;
+		if (entry) sclust = _EntryCluster(fs, entry);
+
+		entry = NULL;
+		for (uint32_t index = 0;; index++) {
+			uint8_t* candidate = _DirEntry(fs, sclust, index);
+			if (candidate == NULL || candidate[0] == 0) return NULL;
+			if ((candidate[11] & AM_LFN) == AM_LFN || (candidate[11] & AM_VOL)) continue;
+			if (memcmp(candidate, short_name, 11) == 0) {
+				entry = candidate;
+				break;
+			}
+		}
+		path += length;
+	}
+	return entry;
+}
+
+/*
+ * "song.wav" to "SONG    WAV", longer parts are cut, invalid characters replaced by '_'
+ */
+bool _ToShortName(const char* name, uint32_t length, uint8_t* short_name) {
+	uint32_t dot = length;
+	uint32_t index = 0;
+
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		if (name[cpt] == '.') dot = cpt;
+	}
+	if (dot == 0) return false;
+
+	memset(short_name, ' ', 11);
+	for (uint32_t cpt = 0; cpt < dot && index < 8; cpt++) {
+		char c = toupper((unsigned char) name[cpt]);
+		short_name[index++] = (isalnum((unsigned char) c) || strchr("$%'-_@~`!(){}^#&", c)) ? c : '_';
+	}
+	index = 8;
+	for (uint32_t cpt = dot + 1; cpt < length && index < 11; cpt++) {
+		char c = toupper((unsigned char) name[cpt]);
+		short_name[index++] = (isalnum((unsigned char) c) || strchr("$%'-_@~`!(){}^#&", c)) ? c : '_';
+	}
+	return true;
+}
+
+void _FillInfo(const uint8_t* entry, FILINFO* fno) {
+	uint32_t index = 0;
+
+	for (uint32_t cpt = 0; cpt < 8 && entry[cpt] != ' '; cpt++) fno->fname[index++] = entry[cpt];
+	if (entry[8] != ' ') {
+		fno->fname[index++] = '.';
+		for (uint32_t cpt = 8; cpt < 11 && entry[cpt] != ' '; cpt++) fno->fname[index++] = entry[cpt];
+	}
+	fno->fname[index] = 0;
+	fno->fattrib = entry[11];
+	fno->ftime = _Read16(&entry[22]);
+	fno->fdate = _Read16(&entry[24]);
+	fno->fsize = _Read32(&entry[28]);
+}
+
+uint32_t _EntryCluster(const FATFS* fs, const uint8_t* entry) {
+	uint32_t cluster = _Read16(&entry[26]);
+
+	if (fs->fs_type == FS_FAT32) cluster |= (uint32_t) _Read16(&entry[20]) << 16;
+	return cluster;
+}
+
+/*
+ * Makes fp->clust the cluster_index-th cluster of the file, from the current
+ * one when going forward (as FatFs does), from the start otherwise
+ */
+bool _SeekCluster(FIL* fp, uint32_t cluster_index) {
+	if (cluster_index < fp->cindex || fp->clust < 2) {
+		fp->clust = fp->sclust;
+		fp->cindex = 0;
+	}
+	while (fp->cindex < cluster_index) {
+		fp->clust = _GetEntry(fp->fs, fp->clust);
+		fp->cindex++;
+		if (fp->clust < 2 || _IsEOC(fp->fs, fp->clust)) return false;
+	}
+	return fp->clust >= 2;
+}
+
+uint16_t _Read16(const uint8_t* data) {
+	return data[0] | (data[1] << 8);
+}
+
+uint32_t _Read32(const uint8_t* data) {
+	return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t) data[3] << 24);
+}
+
+void _Write16(uint8_t* data, uint16_t value) {
+	data[0] = value;
+	data[1] = value >> 8;
+}
+
+void _Write32(uint8_t* data, uint32_t value) {
+	data[0] = value;
+	data[1] = value >> 8;
+	data[2] = value >> 16;
+	data[3] = value >> 24;
+}
@@ -0,0 +1,68 @@
+/**
+ ******************************************************************************
+ * @file host_fat.h
+ * @brief Host FAT volume implementation file
+ *        FAT image block device with a latency model, behind ff.h
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note block device
+ * the image is kept in memory and read by sectors, as an SD card. The
+ * commands and sectors read are counted.
+ *
+ * @note latency
+ * every read command moves the simulated clock forward (Host_Advance) by
+ * the time HostFat_SetLatency() gives it: fixed and per sector costs, a
+ * random jitter and a long stall every stall_period commands (garbage
+ * collection of the card). The periodic interrupts, e.g. the DAC output,
+ * run during that time as they would during a slow f_read.
+ *
+ * @note images
+ * HostFat_Format() builds a FAT12/16 volume (by cluster count) with 8.3 names
+ * in the root directory. Files are written on consecutive clusters, or
+ * interleaved with free clusters with HostFat_AddFile(..., fragmented).
+ * Loaded images may be FAT12/16/32, long names are ignored.
+ ******************************************************************************
+ */
+#ifndef __HOST_FAT_H__
+#define __HOST_FAT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint32_t commands;			// disk reads
+	uint32_t sectors;
+	uint32_t multi_sector;	// commands of two sectors or more
+	uint64_t busy_us;				// simulated time spent reading
+} HostFat_Stats;
+
+typedef struct {
+	uint32_t fixed_us;			// every command
+	uint32_t sector_us;			// every sector of the command
+	uint32_t jitter_us;			// random 0..jitter_us added to every command
+	uint32_t stall_period;	// one command out of stall_period stalls, 0 for never
+	uint32_t stall_us;			// stall length
+} HostFat_Latency;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool HostFat_Format(uint32_t size, uint8_t sectors_per_cluster);
+bool HostFat_AddFile(const char* name, const void* data, uint32_t length, bool fragmented);
+bool HostFat_ImportDir(const char* path);
+bool HostFat_LoadImage(const char* path);
+bool HostFat_SaveImage(const char* path);
+void HostFat_Release(void);
+void HostFat_GetStats(HostFat_Stats* stats);
+void HostFat_ResetStats(void);
+void HostFat_SetLatency(const HostFat_Latency* latency);
+
+#endif /* __HOST_FAT_H__ */
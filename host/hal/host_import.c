@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ * @file host_import.c
+ * @brief Host FAT volume implementation file
+ *        Fill the FAT image from a Linux directory
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * apart from ff_host.c, whose DIR type is the FatFs one and not dirent's
+ ******************************************************************************
+ */
+#include "host_fat.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Adds the regular files of a Linux directory to the root directory, their
+ * names shortened to 8.3 (upper case, at most 8 + 3 characters)
+ */
+bool HostFat_ImportDir(const char* path) {
+	DIR* dir = opendir(path);
+	struct dirent* entry;
+	bool result = true;
+
+	if (dir == NULL) return false;
+	while ((entry = readdir(dir)) != NULL) {
+		char file_path[1024];
+		struct stat info;
+
+		snprintf(file_path, sizeof(file_path), "%s/%s", path, entry->d_name);
+		if (stat(file_path, &info) != 0 || !S_ISREG(info.st_mode)) continue;
+
+		FILE* file = fopen(file_path, "rb");
+		uint8_t* data = malloc(info.st_size ? info.st_size : 1);
+		if (file == NULL || data == NULL || fread(data, 1, info.st_size, file) != (size_t) info.st_size
+				|| !HostFat_AddFile(entry->d_name, data, info.st_size, false)) {
+			result = false;
+		}
+		free(data);
+		if (file) fclose(file);
+	}
+	closedir(dir);
+	return result;
+}
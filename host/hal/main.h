@@ -0,0 +1,19 @@
+/**
+ ******************************************************************************
+ * @file main.h
+ * @brief Host main header
+ *        Stand-in for the CubeMX main.h, pulls in the host HAL
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#ifndef __MAIN_H__
+#define __MAIN_H__
+
+#include "stm32_host.h"
+
+#endif /* __MAIN_H__ */
@@ -0,0 +1,356 @@
+/**
+ ******************************************************************************
+ * @file stm32_host.c
+ * @brief Host HAL implementation file
+ *        Stand-in for the STM32F4 HAL and CMSIS on a Linux host
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * single threaded: an "interrupt" is a callback run from Host_Advance() or
+ * Host_RunIRQ(), with IPSR non zero while it runs. Tests with real threads
+ * must not call the HAL.
+ ******************************************************************************
+ */
+#include "stm32_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint64_t period_us;		// 0 when the slot is free
+	uint64_t next_us;
+	Host_Callback callback;
+	void* context;
+} HOST_Timer;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint64_t s_time_us;
+static uint32_t s_primask;
+static uint32_t s_ipsr;
+static uint8_t 	s_pending;		// timers fell due while masked
+static HOST_Timer s_timers[HOST_NB_TIMERS];
+static HAL_StatusTypeDef s_dma_start_result = HAL_OK;
+static uint32_t s_timer_starts[HOST_NB_TIMERS * 4];
+static const TIM_HandleTypeDef* s_timer_handles[HOST_NB_TIMERS * 4];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _RunTimers(void);
+static void _UartRxHalf(DMA_HandleTypeDef* hdma);
+static void _UartRxComplete(DMA_HandleTypeDef* hdma);
+static uint32_t* _TimerStarts(const TIM_HandleTypeDef* htim);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Maps the peripheral registers at their F4 addresses, zeroed. Called
+ * before main(), tests can call it again to reset every peripheral and the clock
+ */
+__attribute__((constructor)) void Host_Init(void) {
+	static void* s_periph = NULL;
+
+	if (s_periph == NULL) {
+		s_periph = mmap((void*) PERIPH_BASE, HOST_PERIPH_SIZE, PROT_READ | PROT_WRITE,
+										MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+		if (s_periph != (void*) PERIPH_BASE) {
+			fprintf(stderr, "cannot map the peripherals at 0x%08lx\n", PERIPH_BASE);
+			exit(1);
+		}
+	}
+	memset(s_periph, 0, HOST_PERIPH_SIZE);
+	memset(s_timers, 0, sizeof(s_timers));
+	memset(s_timer_starts, 0, sizeof(s_timer_starts));
+	memset(s_timer_handles, 0, sizeof(s_timer_handles));
+	s_time_us = 0;
+	s_primask = 0;
+	s_ipsr = 0;
+	s_pending = 0;
+	s_dma_start_result = HAL_OK;
+	USART1->SR = USART2->SR = USART3->SR = USART6->SR = USART_SR_TXE | USART_SR_TC;
+}
+
+uint64_t Host_GetTimeUs(void) {
+	return s_time_us;
+}
+
+/*
+ * Moves the clock forward, the timers falling due run in order of their date
+ */
+void Host_Advance(uint64_t us) {
+	uint64_t end = s_time_us + us;
+
+	for (;;) {
+		HOST_Timer* next = NULL;
+		for (int cpt = 0; cpt < HOST_NB_TIMERS; cpt++) {
+			HOST_Timer* timer = &s_timers[cpt];
+			if (timer->period_us && timer->next_us <= end && (next == NULL || timer->next_us < next->next_us)) next = timer;
+		}
+		if (next == NULL) break;
+
+		if (next->next_us > s_time_us) s_time_us = next->next_us;
+		if (s_primask) {		// run when unmasked
+			s_pending = 1;
+			break;
+		}
+		next->next_us += next->period_us;
+		Host_RunIRQ(next->callback, next->context);
+	}
+	if (end > s_time_us) s_time_us = end;
+}
+
+/*
+ * Returns the timer number, -1 if all are used
+ */
+int Host_SetTimer(uint64_t period_us, Host_Callback callback, void* context) {
+	for (int cpt = 0; cpt < HOST_NB_TIMERS; cpt++) {
+		if (s_timers[cpt].period_us) continue;
+		s_timers[cpt].period_us = period_us;
+		s_timers[cpt].next_us = s_time_us + period_us;
+		s_timers[cpt].callback = callback;
+		s_timers[cpt].context = context;
+		return cpt;
+	}
+	return -1;
+}
+
+void Host_StopTimer(int timer) {
+	if (timer >= 0 && timer < HOST_NB_TIMERS) s_timers[timer].period_us = 0;
+}
+
+/*
+ * Runs callback as an interrupt handler
+ */
+void Host_RunIRQ(Host_Callback callback, void* context) {
+	uint32_t ipsr = s_ipsr;
+
+	s_ipsr = 16;		// first external interrupt
+	callback(context);
+	s_ipsr = ipsr;
+}
+
+void Host_InitDma(DMA_HandleTypeDef* hdma) {
+	memset(hdma, 0, sizeof(DMA_HandleTypeDef));
+	hdma->Instance = &hdma->Stream;
+}
+
+/*
+ * Peripheral to memory: writes up to nb_items items at the stream position,
+ * wrapping if circular, and calls the half / complete callbacks on the way.
+ * Returns the number of items written
+ */
+uint32_t Host_DmaReceive(DMA_HandleTypeDef* hdma, const void* items, uint32_t nb_items) {
+	const uint8_t* src = items;
+	uint32_t done = 0;
+
+	while (done < nb_items && hdma->busy) {
+		uint32_t position = hdma->length - hdma->Instance->NDTR;
+
+		memcpy((uint8_t*) hdma->Instance->M0AR + position * hdma->item_size, &src[done * hdma->item_size], hdma->item_size);
+		hdma->Instance->NDTR--;
+		done++;
+
+		if (hdma->Instance->NDTR == hdma->length / 2) {
+			hdma->Instance->ISR |= DMA_FLAG_HTIF0_4;
+			if (hdma->XferHalfCpltCallback) Host_RunIRQ((Host_Callback) hdma->XferHalfCpltCallback, hdma);
+		}
+		if (hdma->Instance->NDTR == 0) {
+			hdma->Instance->ISR |= DMA_FLAG_TCIF0_4;
+			if (hdma->circular) hdma->Instance->NDTR = hdma->length;
+			else hdma->busy = 0;
+			if (hdma->XferCpltCallback) Host_RunIRQ((Host_Callback) hdma->XferCpltCallback, hdma);
+		}
+	}
+	return done;
+}
+
+/*
+ * Memory to peripheral: the running transfer is done, its bytes are copied
+ * to sent (up to max_length) and the complete callback is called.
+ * Returns the length of the transfer, 0 if none was running
+ */
+uint32_t Host_DmaComplete(DMA_HandleTypeDef* hdma, uint8_t* sent, uint32_t max_length) {
+	if (!hdma->busy) return 0;
+
+	uint32_t length = hdma->length;
+	if (sent) memcpy(sent, (const uint8_t*) hdma->Instance->M0AR, (length > max_length) ? max_length : length);
+	hdma->Instance->NDTR = 0;
+	hdma->busy = 0;
+	if (hdma->XferCpltCallback) Host_RunIRQ((Host_Callback) hdma->XferCpltCallback, hdma);
+	return length;
+}
+
+/*
+ * Result of the next HAL_DMA_Start_IT() calls
+ */
+void Host_SetDmaStartResult(HAL_StatusTypeDef result) {
+	s_dma_start_result = result;
+}
+
+uint32_t Host_GetTimerStarts(const TIM_HandleTypeDef* htim) {
+	uint32_t* starts = _TimerStarts(htim);
+	return starts ? *starts : 0;
+}
+
+uint32_t HAL_GetTick(void) {
+	return (uint32_t)(s_time_us / 1000);
+}
+
+void HAL_Delay(uint32_t delay) {
+	Host_Advance((uint64_t) delay * 1000);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state) {
+	if (state) port->ODR |= pin;
+	else port->ODR &= ~(uint32_t) pin;
+}
+
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef* hdma, uintptr_t src, uintptr_t dst, uint32_t length) {
+	if (s_dma_start_result != HAL_OK) return s_dma_start_result;
+	if (hdma->busy) return HAL_BUSY;
+
+	hdma->Instance->M0AR = src;
+	hdma->Instance->PAR = dst;
+	hdma->Instance->NDTR = length;
+	hdma->Instance->ISR = 0;
+	hdma->length = length;
+	hdma->item_size = 1;
+	hdma->circular = 0;
+	hdma->busy = 1;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+	DMA_HandleTypeDef* hdma = huart->hdmarx;
+
+	if (hdma == NULL || hdma->busy) return HAL_BUSY;
+	hdma->Instance->M0AR = (uintptr_t) data;
+	hdma->Instance->PAR = (uintptr_t) &huart->Instance->DR;
+	hdma->Instance->NDTR = size;
+	hdma->Instance->ISR = 0;
+	hdma->length = size;
+	hdma->item_size = 1;
+	hdma->circular = 1;
+	hdma->busy = 1;
+	hdma->Parent = huart;
+	hdma->XferHalfCpltCallback = _UartRxHalf;
+	hdma->XferCpltCallback = _UartRxComplete;
+	SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_IC_Start_DMA(TIM_HandleTypeDef* htim, uint32_t channel, uint32_t* data, uint16_t length) {
+	DMA_HandleTypeDef* hdma = htim->hdma[TIM_DMA_ID_CC1 + (channel >> 2)];
+
+	if (hdma == NULL || hdma->busy) return HAL_BUSY;
+	hdma->Instance->M0AR = (uintptr_t) data;
+	hdma->Instance->PAR = (uintptr_t) &htim->Instance->CCR[channel >> 2];
+	hdma->Instance->NDTR = length;
+	hdma->Instance->ISR = 0;
+	hdma->length = length;
+	hdma->item_size = sizeof(uint32_t);
+	hdma->circular = 1;
+	hdma->busy = 1;
+	htim->Instance->CR1 |= TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef* htim, uint32_t channel) {
+	(void) channel;
+	htim->Instance->CR1 |= TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim) {
+	uint32_t* starts = _TimerStarts(htim);
+
+	htim->Instance->DIER |= TIM_IT_UPDATE;
+	htim->Instance->CR1 |= TIM_CR1_CEN;
+	if (starts) (*starts)++;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim) {
+	htim->Instance->DIER &= ~TIM_IT_UPDATE;
+	htim->Instance->CR1 &= ~TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart) {
+	(void) huart;
+}
+
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+	(void) huart;
+}
+
+uint32_t __get_PRIMASK(void) {
+	return s_primask;
+}
+
+void __set_PRIMASK(uint32_t primask) {
+	s_primask = primask;
+	if (!s_primask && s_pending) {
+		s_pending = 0;
+		_RunTimers();
+	}
+}
+
+void __disable_irq(void) {
+	s_primask = 1;
+}
+
+void __enable_irq(void) {
+	__set_PRIMASK(0);
+}
+
+uint32_t __get_IPSR(void) {
+	return s_ipsr;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Timers which fell due while interrupts were masked
+ */
+void _RunTimers(void) {
+	Host_Advance(0);
+}
+
+void _UartRxHalf(DMA_HandleTypeDef* hdma) {
+	HAL_UART_RxHalfCpltCallback(hdma->Parent);
+}
+
+void _UartRxComplete(DMA_HandleTypeDef* hdma) {
+	HAL_UART_RxCpltCallback(hdma->Parent);
+}
+
+/*
+ * Start counter of the timer, by handle
+ */
+uint32_t* _TimerStarts(const TIM_HandleTypeDef* htim) {
+	int count = sizeof(s_timer_handles) / sizeof(s_timer_handles[0]);
+
+	for (int cpt = 0; cpt < count; cpt++) {
+		if (s_timer_handles[cpt] == htim) return &s_timer_starts[cpt];
+		if (s_timer_handles[cpt] == NULL) {
+			s_timer_handles[cpt] = htim;
+			return &s_timer_starts[cpt];
+		}
+	}
+	return NULL;
+}
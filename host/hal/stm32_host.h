@@ -0,0 +1,270 @@
+/**
+ ******************************************************************************
+ * @file stm32_host.h
+ * @brief Host HAL implementation file
+ *        Stand-in for the STM32F4 HAL and CMSIS on a Linux host
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note registers
+ * peripherals are the plain register structs of the F4, mapped at their real
+ * addresses by Host_Init() so that the USARTx_BASE switches of the modules
+ * work unchanged. Only the fields and macros the libraries use are defined.
+ *
+ * @note time
+ * the clock is simulated, in us. HAL_Delay() and Host_Advance() move it
+ * forward and run the periodic interrupts registered with Host_SetTimer()
+ * which fall due, unless interrupts are masked (PRIMASK): they are then run
+ * by the next __enable_irq() / __set_PRIMASK(0).
+ *
+ * @note DMA
+ * a stream only records its addresses, counter and half / complete flags.
+ * Host_DmaReceive() plays a peripheral to memory circular transfer (UART Rx,
+ * timer captures) and Host_DmaComplete() ends a memory to peripheral one
+ * (UART Tx), calling the same callbacks as HAL_DMA_IRQHandler() would. The
+ * flags are left set, as with the stream interrupt disabled in the NVIC.
+ ******************************************************************************
+ */
+#ifndef __STM32_HOST_H__
+#define __STM32_HOST_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define __IO volatile
+
+#define SET_BIT(REG, BIT) 	((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))
+#define READ_REG(REG) 			((REG))
+
+#define PERIPH_BASE 			(0x40000000UL)
+#define APB1PERIPH_BASE 	PERIPH_BASE
+#define APB2PERIPH_BASE 	(PERIPH_BASE + 0x00010000UL)
+#define HOST_PERIPH_SIZE 	(0x00020000UL)		// APB1 and APB2, mapped by Host_Init()
+
+#define TIM2_BASE 	(APB1PERIPH_BASE + 0x0000UL)
+#define TIM3_BASE 	(APB1PERIPH_BASE + 0x0400UL)
+#define TIM4_BASE 	(APB1PERIPH_BASE + 0x0800UL)
+#define TIM6_BASE 	(APB1PERIPH_BASE + 0x1000UL)
+#define USART2_BASE (APB1PERIPH_BASE + 0x4400UL)
+#define USART3_BASE (APB1PERIPH_BASE + 0x4800UL)
+#define UART4_BASE 	(APB1PERIPH_BASE + 0x4C00UL)
+#define UART5_BASE 	(APB1PERIPH_BASE + 0x5000UL)
+#define TIM1_BASE 	(APB2PERIPH_BASE + 0x0000UL)
+#define USART1_BASE (APB2PERIPH_BASE + 0x1000UL)
+#define USART6_BASE (APB2PERIPH_BASE + 0x1400UL)
+#define TIM9_BASE 	(APB2PERIPH_BASE + 0x4000UL)
+
+#define TIM2 		((TIM_TypeDef*) TIM2_BASE)
+#define TIM3 		((TIM_TypeDef*) TIM3_BASE)
+#define TIM4 		((TIM_TypeDef*) TIM4_BASE)
+#define TIM6 		((TIM_TypeDef*) TIM6_BASE)
+#define TIM1 		((TIM_TypeDef*) TIM1_BASE)
+#define TIM9 		((TIM_TypeDef*) TIM9_BASE)
+#define USART1 	((USART_TypeDef*) USART1_BASE)
+#define USART2 	((USART_TypeDef*) USART2_BASE)
+#define USART3 	((USART_TypeDef*) USART3_BASE)
+#define UART4 	((USART_TypeDef*) UART4_BASE)
+#define UART5 	((USART_TypeDef*) UART5_BASE)
+#define USART6 	((USART_TypeDef*) USART6_BASE)
+
+#define USART_SR_PE 		(1U << 0)
+#define USART_SR_FE 		(1U << 1)
+#define USART_SR_NE 		(1U << 2)
+#define USART_SR_ORE 		(1U << 3)
+#define USART_SR_IDLE 	(1U << 4)
+#define USART_SR_RXNE 	(1U << 5)
+#define USART_SR_TC 		(1U << 6)
+#define USART_SR_TXE 		(1U << 7)
+#define USART_CR1_IDLEIE 	(1U << 4)
+#define USART_CR1_RXNEIE 	(1U << 5)
+#define USART_CR1_TCIE 		(1U << 6)
+#define USART_CR1_TXEIE 	(1U << 7)
+#define USART_CR3_EIE 		(1U << 0)
+#define USART_CR3_DMAR 		(1U << 6)
+#define USART_CR3_DMAT 		(1U << 7)
+
+#define UART_IT_IDLE 	USART_CR1_IDLEIE
+#define UART_IT_RXNE 	USART_CR1_RXNEIE
+#define UART_IT_TC 		USART_CR1_TCIE
+#define UART_IT_TXE 	USART_CR1_TXEIE
+#define UART_IT_ERR 	(0x10000000U | USART_CR3_EIE)		// CR3 bit, as the HAL encodes it
+
+#define __HAL_UART_ENABLE_IT(h, it) \
+	(((it) & 0x10000000U) ? SET_BIT((h)->Instance->CR3, (it) & 0xFFFFU) : SET_BIT((h)->Instance->CR1, (it)))
+#define __HAL_UART_DISABLE_IT(h, it) \
+	(((it) & 0x10000000U) ? CLEAR_BIT((h)->Instance->CR3, (it) & 0xFFFFU) : CLEAR_BIT((h)->Instance->CR1, (it)))
+
+#define DMA_FLAG_HTIF0_4 		(0x00000010U)
+#define DMA_FLAG_TCIF0_4 		(0x00000020U)
+
+#define __HAL_DMA_GET_COUNTER(h) 		((h)->Instance->NDTR)
+#define __HAL_DMA_GET_HT_FLAG_INDEX(h) 	(DMA_FLAG_HTIF0_4)		// shifted by stream on target
+#define __HAL_DMA_GET_TC_FLAG_INDEX(h) 	(DMA_FLAG_TCIF0_4)
+#define __HAL_DMA_GET_FLAG(h, f) 				((h)->Instance->ISR & (f))
+#define __HAL_DMA_CLEAR_FLAG(h, f) 			((h)->Instance->ISR &= ~(uint32_t)(f))
+#define __HAL_LINKDMA(h, field, dma) do { (h)->field = &(dma); (dma).Parent = (h); } while (0)
+
+#define TIM_CHANNEL_1 	(0x00000000U)
+#define TIM_CHANNEL_2 	(0x00000004U)
+#define TIM_CHANNEL_3 	(0x00000008U)
+#define TIM_CHANNEL_4 	(0x0000000CU)
+#define TIM_CHANNEL_ALL (0x0000003CU)
+
+#define TIM_DMA_ID_UPDATE (0)
+#define TIM_DMA_ID_CC1 		(1)
+#define TIM_DMA_ID_CC2 		(2)
+#define TIM_DMA_ID_CC3 		(3)
+#define TIM_DMA_ID_CC4 		(4)
+#define TIM_DMA_ID_NB 		(7)
+
+#define TIM_ICPSC_DIV1 	(0x00000000U)
+#define TIM_ICPSC_DIV2 	(0x00000004U)
+#define TIM_ICPSC_DIV4 	(0x00000008U)
+#define TIM_ICPSC_DIV8 	(0x0000000CU)
+
+#define TIM_FLAG_UPDATE (1U << 0)
+#define TIM_IT_UPDATE 	(1U << 0)
+#define TIM_CR1_CEN 		(1U << 0)
+
+#define __HAL_TIM_GET_AUTORELOAD(h) 		((h)->Instance->ARR)
+#define __HAL_TIM_SET_AUTORELOAD(h, v) 	((h)->Instance->ARR = (v))
+#define __HAL_TIM_GET_COUNTER(h) 				((h)->Instance->CNT)
+#define __HAL_TIM_SET_COUNTER(h, v) 		((h)->Instance->CNT = (v))
+#define __HAL_TIM_GET_FLAG(h, f) 				(((h)->Instance->SR & (f)) == (f))
+#define __HAL_TIM_CLEAR_FLAG(h, f) 			((h)->Instance->SR = ~(uint32_t)(f))
+#define __HAL_TIM_ENABLE_IT(h, it) 			((h)->Instance->DIER |= (it))
+#define __HAL_TIM_DISABLE_IT(h, it) 		((h)->Instance->DIER &= ~(it))
+#define __HAL_TIM_SET_ICPRESCALER(h, ch, psc) ((h)->Instance->ICPSC[(ch) >> 2] = (psc))		// CCMRx fields on target
+
+#define GPIO_PIN_0 	((uint16_t) 0x0001)
+#define GPIO_PIN_1 	((uint16_t) 0x0002)
+#define GPIO_PIN_2 	((uint16_t) 0x0004)
+#define GPIO_PIN_3 	((uint16_t) 0x0008)
+#define GPIO_PIN_4 	((uint16_t) 0x0010)
+#define GPIO_PIN_5 	((uint16_t) 0x0020)
+#define GPIO_PIN_6 	((uint16_t) 0x0040)
+#define GPIO_PIN_7 	((uint16_t) 0x0080)
+
+#define HOST_NB_TIMERS (8)		// periodic interrupts of the simulated clock
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef enum {
+	HAL_OK 			= 0x00,
+	HAL_ERROR 	= 0x01,
+	HAL_BUSY 		= 0x02,
+	HAL_TIMEOUT = 0x03,
+} HAL_StatusTypeDef;
+
+typedef enum {
+	RESET = 0,
+	SET = !RESET,
+} FlagStatus;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET,
+} GPIO_PinState;
+
+typedef struct {
+	__IO uint32_t MODER;
+	__IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct {
+	__IO uint32_t SR;
+	__IO uint32_t DR;
+	__IO uint32_t BRR;
+	__IO uint32_t CR1;
+	__IO uint32_t CR2;
+	__IO uint32_t CR3;
+	__IO uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR1;
+	__IO uint32_t DIER;
+	__IO uint32_t SR;
+	__IO uint32_t CNT;
+	__IO uint32_t PSC;
+	__IO uint32_t ARR;
+	__IO uint32_t CCR[4];
+	__IO uint32_t ICPSC[4];		// input capture prescaler of each channel
+} TIM_TypeDef;
+
+typedef struct {
+	__IO uint32_t CR;
+	__IO uint32_t NDTR;		// items left before the end (or the wrap) of the transfer
+	__IO uintptr_t PAR;
+	__IO uintptr_t M0AR;
+	__IO uint32_t ISR;		// flags of the stream, in LISR / HISR of the controller on target
+} DMA_Stream_TypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+	DMA_Stream_TypeDef* Instance;
+	DMA_Stream_TypeDef 	Stream;		// storage of Instance on the host
+	uint32_t 	length;		// of the transfer started
+	uint32_t 	item_size;	// bytes per item, 1 or 4
+	uint8_t 	circular;
+	uint8_t 	busy;
+	void* 		Parent;
+	void 			(*XferCpltCallback)(struct __DMA_HandleTypeDef* hdma);
+	void 			(*XferHalfCpltCallback)(struct __DMA_HandleTypeDef* hdma);
+} DMA_HandleTypeDef;
+
+typedef struct {
+	USART_TypeDef* 			Instance;
+	DMA_HandleTypeDef* 	hdmatx;
+	DMA_HandleTypeDef* 	hdmarx;
+} UART_HandleTypeDef;
+
+typedef struct {
+	TIM_TypeDef* 				Instance;
+	DMA_HandleTypeDef* 	hdma[TIM_DMA_ID_NB];
+} TIM_HandleTypeDef;
+
+typedef void (*Host_Callback)(void* context);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t HAL_GetTick(void);
+void 		 HAL_Delay(uint32_t delay);
+void 		 HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state);
+HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef* hdma, uintptr_t src, uintptr_t dst, uint32_t length);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+HAL_StatusTypeDef HAL_TIM_IC_Start_DMA(TIM_HandleTypeDef* htim, uint32_t channel, uint32_t* data, uint16_t length);
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef* htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim);
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+
+uint32_t __get_PRIMASK(void);
+void 		 __set_PRIMASK(uint32_t primask);
+void 		 __disable_irq(void);
+void 		 __enable_irq(void);
+uint32_t __get_IPSR(void);
+
+void 		 Host_Init(void);
+uint64_t Host_GetTimeUs(void);
+void 		 Host_Advance(uint64_t us);
+int 		 Host_SetTimer(uint64_t period_us, Host_Callback callback, void* context);
+void 		 Host_StopTimer(int timer);
+void 		 Host_RunIRQ(Host_Callback callback, void* context);
+void 		 Host_InitDma(DMA_HandleTypeDef* hdma);
+uint32_t Host_DmaReceive(DMA_HandleTypeDef* hdma, const void* items, uint32_t nb_items);
+uint32_t Host_DmaComplete(DMA_HandleTypeDef* hdma, uint8_t* sent, uint32_t max_length);
+void 		 Host_SetDmaStartResult(HAL_StatusTypeDef result);
+uint32_t Host_GetTimerStarts(const TIM_HandleTypeDef* htim);
+
+#endif /* __STM32_HOST_H__ */
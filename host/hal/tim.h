@@ -0,0 +1,19 @@
+/**
+ ******************************************************************************
+ * @file tim.h
+ * @brief Host TIM header
+ *        Stand-in for the CubeMX tim.h
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#ifndef __TIM_H__
+#define __TIM_H__
+
+#include "main.h"
+
+#endif /* __TIM_H__ */
@@ -0,0 +1,19 @@
+/**
+ ******************************************************************************
+ * @file usart.h
+ * @brief Host USART header
+ *        Stand-in for the CubeMX usart.h
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#ifndef __USART_H__
+#define __USART_H__
+
+#include "main.h"
+
+#endif /* __USART_H__ */
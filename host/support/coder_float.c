@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ * @file coder_float.c
+ * @brief Coder reference implementation file
+ *        Float version of the coder speed estimator, for the host checks
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#include "coder_float.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void CoderFloat_Init(CoderFloat* coder, float alpha, float beta) {
+	memset(coder, 0, sizeof(CoderFloat));
+	coder->alpha = alpha;
+	coder->beta = beta;
+}
+
+/*
+ * width in timer ticks, of edges edges (capture prescaler)
+ */
+void CoderFloat_Update(CoderFloat* coder, uint32_t width, uint32_t edges) {
+	coder->edges += edges;
+	coder->ticks += width;
+	if (coder->ticks < CODER_FLOAT_WINDOW) return;
+
+	float measure = (float) CODER_FLOAT_TICK_HZ * coder->edges / (CODER_FLOAT_NB_STEPS * (float) coder->ticks);
+	if (!coder->ready) {
+		coder->speed = measure;
+		coder->slope = 0;
+		coder->ready = true;
+	}
+	else {
+		float predicted = coder->speed + coder->slope * coder->ticks;
+		float residual = measure - predicted;
+
+		coder->speed = predicted + coder->alpha * residual;
+		coder->slope += coder->beta * residual / coder->ticks;
+	}
+	coder->edges = 0;
+	coder->ticks = 0;
+}
+
+/*
+ * Ratio as CoderInterface_GetSpeedRatio(), 0 when stopped
+ */
+float CoderFloat_GetRatio(const CoderFloat* coder) {
+	if (!coder->ready || coder->speed <= 0) return 0;
+	return 1 + (coder->speed - 1) * CODER_FLOAT_GAIN;
+}
@@ -0,0 +1,54 @@
+/**
+ ******************************************************************************
+ * @file coder_float.h
+ * @brief Coder reference implementation file
+ *        Float version of the coder speed estimator, for the host checks
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * same M/T window and alpha-beta filter as CoderInterface.c, in single
+ * precision float as the former capture interrupt computed the speed (the
+ * Cortex-M4 FPU has no double). Fed with the same widths and edge counts, the
+ * difference with the coder is the fixed-point error only.
+ ******************************************************************************
+ */
+#ifndef __CODER_FLOAT_H__
+#define __CODER_FLOAT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define CODER_FLOAT_TICK_HZ 	(168000000 / 42000)		// TIMCLOCK / PRESCALAR of CoderInterface.c
+#define CODER_FLOAT_NB_STEPS 	(30)
+#define CODER_FLOAT_WINDOW 		(CODER_FLOAT_TICK_HZ / 200)		// CODER_MT_WINDOW_TICKS
+#define CODER_FLOAT_GAIN 			(0.2f)
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	float 	 alpha;
+	float 	 beta;
+	float 	 speed;		// turns per second
+	float 	 slope;		// turns per second per tick
+	bool 		 ready;
+	uint32_t edges;		// window in progress
+	uint32_t ticks;
+} CoderFloat;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void  CoderFloat_Init(CoderFloat* coder, float alpha, float beta);
+void  CoderFloat_Update(CoderFloat* coder, uint32_t width, uint32_t edges);
+float CoderFloat_GetRatio(const CoderFloat* coder);
+
+#endif /* __CODER_FLOAT_H__ */
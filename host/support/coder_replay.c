@@ -0,0 +1,171 @@
+/**
+ ******************************************************************************
+ * @file coder_replay.c
+ * @brief Coder replay implementation file
+ *        Encoder edge traces played through the coder and the former average
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the coder is the input capture one (CODER_ENCODER_MODE not defined). It is
+ * initialized once, a replay starts and ends with the coder stopped: the
+ * simulated clock is moved past the timeout after each trace.
+ ******************************************************************************
+ */
+#include "coder_replay.h"
+#include "coder_float.h"
+
+#include <math.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _NB_CAPTURES 	(256)
+#define _COUNTER_MASK (0xFFFF)
+#define _LOOP_US 			(1000)
+#define _STOP_US 			(10000000)		// longer than half the counter period
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint32_t widths[CODER_REPLAY_OLD_LENGTH];		// ticks
+	uint32_t sum;
+	uint32_t count;
+	uint32_t index;
+} REPLAY_Average;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint32_t s_captures[_NB_CAPTURES];
+static DMA_HandleTypeDef s_hdma;
+static TIM_HandleTypeDef s_htim;
+static Coder s_coder;
+static uint32_t s_seed = 23;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void 	_AddWidth(REPLAY_Average* average, uint32_t width);
+static double _Random(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool CoderReplay_Init(void) {
+	Host_InitDma(&s_hdma);
+	s_htim.Instance = TIM3;
+	s_htim.Instance->ARR = _COUNTER_MASK;
+	s_htim.hdma[TIM_DMA_ID_CC1] = &s_hdma;
+	return CoderInterface_Init(&s_coder, &s_htim, TIM_CHANNEL_1, s_captures, _NB_CAPTURES);
+}
+
+/*
+ * Edges of a step from from to to turns/s at step_s, each period moved by a
+ * random part of jitter (0.05 for 5%). Returns the number of edges
+ */
+uint32_t CoderReplay_StepTrace(double* edges, uint32_t max_edges, double from, double to, double step_s, double duration_s, double jitter) {
+	double time = 0;
+	uint32_t nb_edges = 0;
+
+	while (nb_edges < max_edges) {
+		double period = 1 / (CODER_FLOAT_NB_STEPS * ((time < step_s) ? from : to));
+
+		time += period * (1 + jitter * (2 * _Random() - 1));
+		if (time >= duration_s) break;
+		edges[nb_edges++] = time;
+	}
+	return nb_edges;
+}
+
+/*
+ * Plays the edges, output holds one speed per ms of the trace
+ */
+void CoderReplay_Run(const double* edges, uint32_t nb_edges, CODER_RESPONSE response, CoderReplay_Output* output) {
+	double start = Host_GetTimeUs() * 1e-6;
+	REPLAY_Average average = {0};
+	uint32_t index = 0;
+	uint32_t edges_captured = 0;		// since the last capture, prescaler
+	uint32_t last_tick = 0;
+	bool first = true;
+
+	CoderInterface_SetResponse(&s_coder, response);
+	for (uint32_t sample = 0; sample < output->nb_samples; sample++) {
+		double loop_end = start + (sample + 1) * _LOOP_US * 1e-6;
+
+		for (; index < nb_edges && start + edges[index] < loop_end; index++) {
+			uint32_t tick = (uint32_t)((start + edges[index]) * CODER_FLOAT_TICK_HZ) & _COUNTER_MASK;
+			uint32_t divider = (s_htim.Instance->ICPSC[0] == TIM_ICPSC_DIV8) ? 8 : 1;
+
+			if (++edges_captured >= divider) {
+				Host_DmaReceive(&s_hdma, &tick, 1);
+				edges_captured = 0;
+			}
+			if (!first) _AddWidth(&average, (tick - last_tick) & _COUNTER_MASK);
+			first = false;
+			last_tick = tick;
+		}
+		Host_Advance(_LOOP_US);
+		CoderInterface_Run(&s_coder);
+
+		output->new_speed[sample] = s_coder.speed_q16 / 65536.0f;
+		output->old_speed[sample] = average.sum ? (float) CODER_FLOAT_TICK_HZ * average.count / (CODER_FLOAT_NB_STEPS * (float) average.sum) : 0;
+	}
+	Host_Advance(_STOP_US);
+	CoderInterface_Run(&s_coder);
+}
+
+/*
+ * Milliseconds from step_s to the first sample past 90% of the step, -1 if
+ * never reached
+ */
+float CoderReplay_Latency(const float* speed, uint32_t nb_samples, double from, double to, double step_s) {
+	double threshold = from + 0.9 * (to - from);
+	uint32_t step = (uint32_t)(step_s * 1000);
+
+	for (uint32_t cpt = step; cpt < nb_samples; cpt++) {
+		if ((to > from) ? speed[cpt] >= threshold : speed[cpt] <= threshold) {
+			return cpt + 1 - step;		// sample cpt is taken at the end of ms cpt
+		}
+	}
+	return -1;
+}
+
+/*
+ * Relative RMS error to the expected constant speed, from settle_s on
+ */
+float CoderReplay_Noise(const float* speed, uint32_t nb_samples, double expected, double settle_s) {
+	uint32_t first = (uint32_t)(settle_s * 1000);
+	double sum = 0;
+
+	if (first >= nb_samples) return -1;
+	for (uint32_t cpt = first; cpt < nb_samples; cpt++) {
+		sum += (speed[cpt] - expected) * (speed[cpt] - expected);
+	}
+	return sqrt(sum / (nb_samples - first)) / expected;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _AddWidth(REPLAY_Average* average, uint32_t width) {
+	if (average->count == CODER_REPLAY_OLD_LENGTH) average->sum -= average->widths[average->index];
+	else average->count++;
+	average->widths[average->index] = width;
+	average->sum += width;
+	average->index = (average->index + 1) % CODER_REPLAY_OLD_LENGTH;
+}
+
+/*
+ * 0 to 1, same sequence on every run
+ */
+double _Random(void) {
+	s_seed = s_seed * 1103515245 + 12345;
+	return (s_seed >> 8) / 16777216.0;
+}
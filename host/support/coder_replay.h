@@ -0,0 +1,54 @@
+/**
+ ******************************************************************************
+ * @file coder_replay.h
+ * @brief Coder replay implementation file
+ *        Encoder edge traces played through the coder and the former average
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * a trace is the list of edge times, in seconds. Each edge (each 8th with the
+ * capture prescaler) writes the timer counter in the DMA ring of the coder,
+ * CoderInterface_Run() runs every ms. The same edges, all captured, go
+ * through the former estimator: the mean of the last 30 periods. Both speeds
+ * are sampled every ms. The latency is measured on a step trace, the noise
+ * on a constant speed trace once the estimators settled: the transient of a
+ * step is not noise.
+ ******************************************************************************
+ */
+#ifndef __CODER_REPLAY_H__
+#define __CODER_REPLAY_H__
+
+#include "CoderInterface.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define CODER_REPLAY_OLD_LENGTH (30)		// periods averaged by the former estimator
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	float* old_speed;			// turns per second, one per ms
+	float* new_speed;
+	uint32_t nb_samples;
+} CoderReplay_Output;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool 		 CoderReplay_Init(void);
+uint32_t CoderReplay_StepTrace(double* edges, uint32_t max_edges, double from, double to, double step_s, double duration_s, double jitter);
+void 		 CoderReplay_Run(const double* edges, uint32_t nb_edges, CODER_RESPONSE response, CoderReplay_Output* output);
+float 	 CoderReplay_Latency(const float* speed, uint32_t nb_samples, double from, double to, double step_s);
+float 	 CoderReplay_Noise(const float* speed, uint32_t nb_samples, double expected, double settle_s);
+
+#endif /* __CODER_REPLAY_H__ */
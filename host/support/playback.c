@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * @file playback.c
+ * @brief Host playback implementation file
+ *        WAV decoder played by a simulated DAC timer and main loop
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#include "playback.h"
+#include "stm32_host.h"
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint16_t s_dac_buf[2 * PLAYBACK_HALF];
+static bool 		s_half;		// next interrupt is the half transfer one
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _DacIRQ(void* context);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Plays name for duration_ms of simulated time, the volume must be mounted.
+ * Returns false if the file cannot be opened
+ */
+bool Playback_Run(char* name, uint32_t duration_ms, WAV_Stats* stats) {
+	if (WavDecoder_OpenFile(name) != WAV_OK) return false;
+
+	WavDecoder_StartOutput(s_dac_buf, 2 * PLAYBACK_HALF);
+	WavDecoder_ResetStats();
+	s_half = true;
+	int timer = Host_SetTimer((uint64_t) PLAYBACK_HALF * 1000000 / WAV_OUTPUT_RATE, _DacIRQ, NULL);
+	uint64_t end = Host_GetTimeUs() + (uint64_t) duration_ms * 1000;
+
+	while (Host_GetTimeUs() < end) {
+		WavDecoder_FeedDacBuffer();
+		if (!WavDecoder_IsNextQueued()) WavDecoder_QueueFile(name);
+		Host_Advance(PLAYBACK_LOOP_US);
+	}
+	Host_StopTimer(timer);
+	WavDecoder_GetStats(stats);
+	return true;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _DacIRQ(void* context) {
+	(void) context;
+	if (s_half) WavDecoder_HalfTransferCallback();
+	else 				WavDecoder_TransferCompleteCallback();
+	s_half = !s_half;
+}
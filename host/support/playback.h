@@ -0,0 +1,40 @@
+/**
+ ******************************************************************************
+ * @file playback.h
+ * @brief Host playback implementation file
+ *        WAV decoder played by a simulated DAC timer and main loop
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * a periodic simulated interrupt plays the DAC buffer (half / complete
+ * callbacks) at WAV_OUTPUT_RATE, the main loop feeds the decoder every
+ * PLAYBACK_LOOP_US. Card reads take the simulated time of the latency model
+ * of host_fat.h, so the output may underrun as on the target. The file is
+ * kept queued after itself, it loops for the whole duration.
+ ******************************************************************************
+ */
+#ifndef __PLAYBACK_H__
+#define __PLAYBACK_H__
+
+#include "WAV_Decoder.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define PLAYBACK_HALF 		(256)		// DAC values per half transfer
+#define PLAYBACK_LOOP_US 	(500)		// main loop period
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool Playback_Run(char* name, uint32_t duration_ms, WAV_Stats* stats);
+
+#endif /* __PLAYBACK_H__ */
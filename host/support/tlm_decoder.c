@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * @file tlm_decoder.c
+ * @brief Telemetry decoder implementation file
+ *        Split, COBS decode and check the frames of a telemetry stream
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the CRC is computed bit by bit, independently of the nibble table of
+ * Telemetry.c, so that the tests check one against the other.
+ ******************************************************************************
+ */
+#include "tlm_decoder.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _HEADER_SIZE 	(6)		// type, source, timestamp
+#define _CRC_SIZE 		(2)
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static uint16_t _Crc16(const uint8_t* data, uint32_t length);
+static void 		_EndFrame(TlmDecoder* decoder);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void TlmDecoder_Init(TlmDecoder* decoder, TlmDecoder_Callback callback, void* context) {
+	memset(decoder, 0, sizeof(TlmDecoder));
+	decoder->callback = callback;
+	decoder->context = context;
+}
+
+void TlmDecoder_Push(TlmDecoder* decoder, const uint8_t* data, uint32_t length) {
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		if (data[cpt] == 0) {
+			_EndFrame(decoder);
+		}
+		else if (decoder->length < TLM_DECODER_MAX_FRAME) {
+			decoder->frame[decoder->length++] = data[cpt];
+		}
+		else {
+			decoder->overflow = true;
+		}
+	}
+}
+
+/*
+ * frame is COBS encoded, without its delimiter.
+ * Returns false if it does not decode to a record with a valid CRC
+ */
+bool TlmDecoder_DecodeFrame(const uint8_t* frame, uint32_t length, TlmDecoder_Record* record) {
+	uint8_t raw[TLM_DECODER_MAX_FRAME];
+	uint32_t raw_length = 0;
+	uint32_t index = 0;
+
+	while (index < length) {
+		uint8_t code = frame[index++];
+		if (code == 0 || index + code - 1 > length) return false;
+		for (uint32_t cpt = 1; cpt < code; cpt++) raw[raw_length++] = frame[index++];
+		if (code < 0xFF && index < length) raw[raw_length++] = 0;
+	}
+	if (raw_length < _HEADER_SIZE + _CRC_SIZE || raw_length > _HEADER_SIZE + TELEMETRY_MAX_PAYLOAD + _CRC_SIZE) return false;
+
+	raw_length -= _CRC_SIZE;
+	if (_Crc16(raw, raw_length) != (raw[raw_length] | raw[raw_length + 1] << 8)) return false;
+
+	record->type = raw[0];
+	record->source = raw[1];
+	record->timestamp = raw[2] | raw[3] << 8 | raw[4] << 16 | (uint32_t) raw[5] << 24;
+	record->length = raw_length - _HEADER_SIZE;
+	memcpy(record->payload, &raw[_HEADER_SIZE], record->length);
+	return true;
+}
+
+void TlmDecoder_PrintCsvHeader(FILE* file) {
+	fprintf(file, "time_ms,type,source,value0,value1\n");
+}
+
+/*
+ * Known types are printed as their values, the others as hexadecimal payload
+ */
+void TlmDecoder_PrintCsv(FILE* file, const TlmDecoder_Record* record) {
+	uint32_t values[2] = {0, 0};
+
+	if (record->length == sizeof(values)) memcpy(values, record->payload, sizeof(values));
+	fprintf(file, "%u,", record->timestamp);
+	if (record->type == TLM_CODER_WIDTH && record->length == sizeof(values)) {
+		fprintf(file, "coder_width,%u,%u,%.4f\n", record->source, values[0], values[1] / 65536.0);		// ticks, turns/s
+	}
+	else if (record->type == TLM_WAV_FILL && record->length == sizeof(values)) {
+		fprintf(file, "wav_fill,%u,%u,%u\n", record->source, values[0], values[1]);
+	}
+	else {
+		fprintf(file, "0x%02x,%u,", record->type, record->source);
+		for (uint32_t cpt = 0; cpt < record->length; cpt++) fprintf(file, "%02x", record->payload[cpt]);
+		fprintf(file, ",\n");
+	}
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint16_t _Crc16(const uint8_t* data, uint32_t length) {
+	uint16_t crc = 0xFFFF;
+
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		crc ^= (uint16_t) data[cpt] << 8;
+		for (uint8_t bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+	}
+	return crc;
+}
+
+/*
+ * Delimiter: decode the frame in progress
+ */
+void _EndFrame(TlmDecoder* decoder) {
+	TlmDecoder_Record record;
+
+	if (decoder->overflow) {
+		decoder->errors++;
+	}
+	else if (decoder->length) {
+		if (TlmDecoder_DecodeFrame(decoder->frame, decoder->length, &record)) {
+			decoder->records++;
+			if (decoder->callback) decoder->callback(&record, decoder->context);
+		}
+		else {
+			decoder->errors++;
+		}
+	}
+	decoder->length = 0;
+	decoder->overflow = false;
+}
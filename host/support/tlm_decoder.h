@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ * @file tlm_decoder.h
+ * @brief Telemetry decoder implementation file
+ *        Split, COBS decode and check the frames of a telemetry stream
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the stream may be pushed in pieces of any size. Frames which do not decode
+ * or whose CRC is wrong, e.g. the first one of a capture started in the
+ * middle of a frame, are counted as errors: the decoder resynchronizes on the
+ * next 0x00.
+ ******************************************************************************
+ */
+#ifndef __TLM_DECODER_H__
+#define __TLM_DECODER_H__
+
+#include "Telemetry.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define TLM_DECODER_MAX_FRAME (254)		// COBS frames of one code block
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint8_t  type;
+	uint8_t  source;
+	uint32_t timestamp;		// ms
+	uint8_t  length;
+	uint8_t  payload[TELEMETRY_MAX_PAYLOAD];
+} TlmDecoder_Record;
+
+typedef void (*TlmDecoder_Callback)(const TlmDecoder_Record* record, void* context);
+
+typedef struct {
+	uint8_t  frame[TLM_DECODER_MAX_FRAME];
+	uint32_t length;				// bytes of the frame in progress
+	bool 		 overflow;			// frame in progress too long, dropped at its end
+	uint32_t records;
+	uint32_t errors;
+	TlmDecoder_Callback callback;
+	void* 	 context;
+} TlmDecoder;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void TlmDecoder_Init(TlmDecoder* decoder, TlmDecoder_Callback callback, void* context);
+void TlmDecoder_Push(TlmDecoder* decoder, const uint8_t* data, uint32_t length);
+bool TlmDecoder_DecodeFrame(const uint8_t* frame, uint32_t length, TlmDecoder_Record* record);
+void TlmDecoder_PrintCsvHeader(FILE* file);
+void TlmDecoder_PrintCsv(FILE* file, const TlmDecoder_Record* record);
+
+#endif /* __TLM_DECODER_H__ */
@@ -0,0 +1,103 @@
+/**
+ ******************************************************************************
+ * @file wav_file.c
+ * @brief WAV file implementation file
+ *        Build WAV files in memory for the host tests and benchmarks
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#include "wav_file.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static uint8_t* _Put(uint8_t* dst, const char* id, uint32_t value);
+static uint8_t* _Put16(uint8_t* dst, uint16_t value);
+static uint8_t* _Put32(uint8_t* dst, uint32_t value);
+static uint32_t _NbLists(const WavFile_Format* format);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t WavFile_Size(const WavFile_Format* format, uint32_t data_length) {
+	uint32_t size = WAV_FILE_HEADER_SIZE + data_length + (data_length & 1);
+
+	if (format->extensible) size += 24;
+	if (format->list_size) size += _NbLists(format) * (8 + format->list_size + (format->list_size & 1));
+	return size;
+}
+
+/*
+ * file must hold WavFile_Size() bytes, returns that size
+ */
+uint32_t WavFile_Build(uint8_t* file, const WavFile_Format* format, const void* data, uint32_t data_length) {
+	uint32_t size = WavFile_Size(format, data_length);
+	uint16_t block = format->byte_per_block ? format->byte_per_block : format->nb_channels * format->bits_per_sample / 8;
+	uint8_t* dst = file;
+
+	dst = _Put(dst, "RIFF", size - 8);
+	memcpy(dst, "WAVE", 4);
+	dst += 4;
+
+	dst = _Put(dst, "fmt ", format->extensible ? 40 : 16);
+	dst = _Put16(dst, format->extensible ? 0xFFFE : format->audio_format);
+	dst = _Put16(dst, format->nb_channels);
+	dst = _Put32(dst, format->sample_rate);
+	dst = _Put32(dst, format->sample_rate * block);
+	dst = _Put16(dst, block);
+	dst = _Put16(dst, format->bits_per_sample);
+	if (format->extensible) {
+		dst = _Put16(dst, 22);											// cbSize
+		dst = _Put16(dst, format->bits_per_sample);	// valid bits
+		dst = _Put32(dst, 0);												// channel mask
+		dst = _Put16(dst, format->audio_format);		// SubFormat GUID, first bytes
+		memcpy(dst, "\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 14);
+		dst += 14;
+	}
+
+	for (uint32_t cpt = 0; format->list_size && cpt < _NbLists(format); cpt++) {
+		dst = _Put(dst, "LIST", format->list_size);
+		memset(dst, 'x', format->list_size);
+		dst += format->list_size;
+		if (format->list_size & 1) *dst++ = 0;		// pad byte
+	}
+
+	dst = _Put(dst, "data", data_length);
+	memcpy(dst, data, data_length);
+	dst += data_length;
+	if (data_length & 1) *dst++ = 0;
+	return dst - file;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint8_t* _Put(uint8_t* dst, const char* id, uint32_t value) {
+	memcpy(dst, id, 4);
+	return _Put32(dst + 4, value);
+}
+
+uint8_t* _Put16(uint8_t* dst, uint16_t value) {
+	dst[0] = value;
+	dst[1] = value >> 8;
+	return dst + 2;
+}
+
+uint8_t* _Put32(uint8_t* dst, uint32_t value) {
+	dst[0] = value;
+	dst[1] = value >> 8;
+	dst[2] = value >> 16;
+	dst[3] = value >> 24;
+	return dst + 4;
+}
+
+uint32_t _NbLists(const WavFile_Format* format) {
+	return format->nb_lists ? format->nb_lists : 1;
+}
@@ -0,0 +1,45 @@
+/**
+ ******************************************************************************
+ * @file wav_file.h
+ * @brief WAV file implementation file
+ *        Build WAV files in memory for the host tests and benchmarks
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#ifndef __WAV_FILE_H__
+#define __WAV_FILE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define WAV_FILE_HEADER_SIZE (44)		// RIFF, fmt of 16 bytes, data header
+
+// ------------------------------------------------------------------------
+// ----------------------------- PUBLIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint16_t audio_format;		// 1 PCM, 3 float
+	uint16_t nb_channels;
+	uint32_t sample_rate;
+	uint16_t bits_per_sample;
+	uint16_t byte_per_block;	// 0: nb_channels * bits_per_sample / 8
+	uint32_t list_size;				// LIST chunk before the data, 0 for none
+	uint16_t nb_lists;				// LIST chunks of list_size, 0 counts as 1
+	bool 		 extensible;			// WAVE_FORMAT_EXTENSIBLE fmt chunk
+} WavFile_Format;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t WavFile_Size(const WavFile_Format* format, uint32_t data_length);
+uint32_t WavFile_Build(uint8_t* file, const WavFile_Format* format, const void* data, uint32_t data_length);
+
+#endif /* __WAV_FILE_H__ */
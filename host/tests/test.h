@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * @file test.h
+ * @brief Host test header
+ *        Minimal checks shared by the host tests, one executable per test
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * 		int main(void) {
+ * 			TEST_RUN(Test_Something);
+ * 			return TEST_RESULT();
+ * 		}
+ * a failed check prints its location and the test goes on, the executable
+ * returns non zero if any check failed (ctest).
+ ******************************************************************************
+ */
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define TEST_CHECK(condition) \
+	do { \
+		s_test_checks++; \
+		if (!(condition)) { \
+			s_test_failures++; \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+		} \
+	} while (0)
+
+#define TEST_EQUAL(actual, expected) \
+	do { \
+		long long _actual = (long long)(actual), _expected = (long long)(expected); \
+		s_test_checks++; \
+		if (_actual != _expected) { \
+			s_test_failures++; \
+			printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, _actual, _expected); \
+		} \
+	} while (0)
+
+#define TEST_RUN(test) \
+	do { \
+		unsigned _failures = s_test_failures; \
+		test(); \
+		printf("%s %s\n", (s_test_failures == _failures) ? "PASS" : "FAIL", #test); \
+	} while (0)
+
+#define TEST_RESULT() \
+	(printf("%u checks, %u failed\n", s_test_checks, s_test_failures), s_test_failures != 0)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static unsigned s_test_checks;
+static unsigned s_test_failures;
+
+#endif /* __TEST_H__ */
@@ -0,0 +1,155 @@
+/**
+ ******************************************************************************
+ * @file test_coder.c
+ * @brief Host test implementation file
+ *        Coder speed in fixed point against the float estimator
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * a wheel of CODER_FLOAT_NB_STEPS steps per turn turns at a given speed
+ * profile, each edge (or each 8th with the capture prescaler) writes the
+ * timer counter in the DMA ring. The main loop runs every ms. The same
+ * widths and edge counts go through the float estimator of coder_float.c:
+ * the speeds must match within the fixed-point resolution, and so must the
+ * ratios of CoderInterface_GetSpeedRatioQ16 / GetSpeedRatio and
+ * CoderFloat_GetRatio.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "coder_float.h"
+#include "CoderInterface.h"
+
+#include <math.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _NB_CAPTURES 	(256)
+#define _COUNTER_MASK (0xFFFF)
+#define _LOOP_US 			(1000)
+#define _MAX_ERROR 		(1e-3)		// relative, speed and ratio
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	const char* name;
+	double start;		// turns per second
+	double end;			// linear ramp over the duration, start for a constant speed
+} TEST_Profile;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const TEST_Profile s_profiles[] = {
+	{"0.5 turns/s", 0.5, 0.5},
+	{"3 turns/s", 3, 3},
+	{"20 turns/s", 20, 20},
+	{"60 turns/s", 60, 60},
+	{"200 turns/s (divided)", 200, 200},
+	{"ramp 2 to 150 turns/s", 2, 150},
+	{"ramp 150 to 10 turns/s", 150, 10},
+};
+
+static uint32_t s_captures[_NB_CAPTURES];
+static DMA_HandleTypeDef s_hdma;
+static TIM_HandleTypeDef s_htim;
+static Coder s_coder;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static double _Run(const TEST_Profile* profile, double duration, double* ratio_error);
+static void 	Test_FloatAccuracy(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	Host_InitDma(&s_hdma);
+	s_htim.Instance = TIM3;
+	s_htim.Instance->ARR = _COUNTER_MASK;
+	s_htim.hdma[TIM_DMA_ID_CC1] = &s_hdma;
+	if (!CoderInterface_Init(&s_coder, &s_htim, TIM_CHANNEL_1, s_captures, _NB_CAPTURES)) {
+		printf("cannot start the coder\n");
+		return 1;
+	}
+
+	TEST_RUN(Test_FloatAccuracy);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Plays profile for duration seconds from a stopped coder, returns the
+ * largest relative speed difference with the float estimator, and the
+ * largest relative ratio difference in ratio_error
+ */
+double _Run(const TEST_Profile* profile, double duration, double* ratio_error) {
+	double start = Host_GetTimeUs() * 1e-6;
+	double edge = start;
+	double max_error = 0;
+	uint32_t edges = 0;				// since the last capture
+	uint32_t last_capture = 0;
+	bool first = true;
+	CoderFloat reference;
+
+	*ratio_error = 0;
+	CoderFloat_Init(&reference, s_coder.filter.alpha / 65536.0f, s_coder.filter.beta / 65536.0f);
+	while (Host_GetTimeUs() * 1e-6 < start + duration) {
+		double loop_end = (Host_GetTimeUs() + _LOOP_US) * 1e-6;
+
+		while (edge < loop_end) {
+			uint32_t divider = (s_htim.Instance->ICPSC[0] == TIM_ICPSC_DIV8) ? 8 : 1;
+			double speed = profile->start + (profile->end - profile->start) * (edge - start) / duration;
+
+			if (++edges >= divider) {
+				uint32_t capture = (uint32_t)(edge * CODER_FLOAT_TICK_HZ) & _COUNTER_MASK;
+
+				Host_DmaReceive(&s_hdma, &capture, 1);
+				if (!first) CoderFloat_Update(&reference, (capture - last_capture) & _COUNTER_MASK, edges);
+				first = false;
+				last_capture = capture;
+				edges = 0;
+			}
+			edge += 1 / (CODER_FLOAT_NB_STEPS * speed);
+		}
+		Host_Advance(_LOOP_US);
+		CoderInterface_Run(&s_coder);
+
+		if (reference.ready && reference.speed > 0) {
+			double error = fabs(s_coder.speed_q16 / 65536.0 - reference.speed) / reference.speed;
+			if (error > max_error) max_error = error;
+
+			float ratio = CoderFloat_GetRatio(&reference);
+			uint32_t ratio_q16 = CoderInterface_GetSpeedRatioQ16(&s_coder);
+			error = fabs(ratio_q16 / 65536.0 - ratio) / ratio;
+			if (error > *ratio_error) *ratio_error = error;
+			TEST_CHECK(CoderInterface_GetSpeedRatio(&s_coder) == ratio_q16 / 65536.0f);
+		}
+	}
+	Host_Advance(10000000);		// stopped: longer than half the counter period
+	CoderInterface_Run(&s_coder);
+	TEST_EQUAL(CoderInterface_GetSpeedRatioQ16(&s_coder), 0);
+	TEST_CHECK(CoderInterface_GetSpeedRatio(&s_coder) == 0.0f);
+	return max_error;
+}
+
+void Test_FloatAccuracy(void) {
+	for (uint32_t cpt = 0; cpt < sizeof(s_profiles) / sizeof(s_profiles[0]); cpt++) {
+		double ratio_error;
+		double error = _Run(&s_profiles[cpt], 3.0, &ratio_error);
+
+		printf("  %-26s max speed error %.2e, ratio %.2e\n", s_profiles[cpt].name, error, ratio_error);
+		TEST_CHECK(error < _MAX_ERROR);
+		TEST_CHECK(ratio_error < _MAX_ERROR);
+		TEST_EQUAL(s_coder.speed_q16, 0);		// stopped
+	}
+}
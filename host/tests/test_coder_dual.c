@@ -0,0 +1,220 @@
+/**
+ ******************************************************************************
+ * @file test_coder_dual.c
+ * @brief Host test implementation file
+ *        Two input capture coders, DMA ring wraps, laps and stops
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * two wheels turn at their own speed, each on its timer, channel and DMA
+ * ring (TIM3 CH1 with 64 captures, TIM4 CH2 with 256). The main loop runs
+ * every ms, or stalls long enough for the DMA to go round the small ring:
+ * the lap must be counted and the speed must not jump. One wheel stopping
+ * or lapping must not change the speed of the other.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "coder_float.h"
+#include "CoderInterface.h"
+
+#include <math.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _COUNTER_MASK (0xFFFF)
+#define _LOOP_US 			(1000)
+#define _TIMEOUT_MS 	(8200)		// half the counter period, 65536 ticks of 250 us
+#define _MAX_ERROR 		(0.03)		// relative, 250 us ticks over a 5 ms window
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	TIM_HandleTypeDef htim;
+	DMA_HandleTypeDef hdma;
+	Coder coder;
+	double speed;						// turns per second, 0 stopped
+	double next_edge;				// s
+	uint32_t edges;					// since the last capture
+	double max_error;				// relative, since _ResetError()
+} TEST_Wheel;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint32_t s_small_ring[64];
+static uint32_t s_large_ring[256];
+static TEST_Wheel s_wheels[2];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static bool _Init(TEST_Wheel* wheel, TIM_TypeDef* instance, uint32_t channel, uint32_t* captures, uint16_t nb_captures);
+static void _SetSpeed(TEST_Wheel* wheel, double speed);
+static void _Edges(TEST_Wheel* wheel, double until);
+static void _Play(uint32_t duration_ms, bool run);
+static void _ResetError(void);
+static void Test_Independent(void);
+static void Test_Stop(void);
+static void Test_Lap(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	Host_Init();
+	if (!_Init(&s_wheels[0], TIM3, TIM_CHANNEL_1, s_small_ring, 64)
+	 || !_Init(&s_wheels[1], TIM4, TIM_CHANNEL_2, s_large_ring, 256)) {
+		printf("cannot start the coders\n");
+		return 1;
+	}
+
+	TEST_RUN(Test_Independent);
+	TEST_RUN(Test_Stop);
+	TEST_RUN(Test_Lap);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool _Init(TEST_Wheel* wheel, TIM_TypeDef* instance, uint32_t channel, uint32_t* captures, uint16_t nb_captures) {
+	Host_InitDma(&wheel->hdma);
+	wheel->htim.Instance = instance;
+	wheel->htim.Instance->ARR = _COUNTER_MASK;
+	wheel->htim.hdma[TIM_DMA_ID_CC1 + (channel >> 2)] = &wheel->hdma;
+	return CoderInterface_Init(&wheel->coder, &wheel->htim, channel, captures, nb_captures);
+}
+
+void _SetSpeed(TEST_Wheel* wheel, double speed) {
+	wheel->speed = speed;
+	wheel->next_edge = Host_GetTimeUs() * 1e-6;
+}
+
+/*
+ * Captures of the edges before until (s), through the DMA of the wheel
+ */
+void _Edges(TEST_Wheel* wheel, double until) {
+	if (wheel->speed <= 0) return;
+
+	while (wheel->next_edge < until) {
+		uint32_t channel = wheel->coder.channel;
+		uint32_t divider = (wheel->htim.Instance->ICPSC[channel >> 2] == TIM_ICPSC_DIV8) ? 8 : 1;
+
+		if (++wheel->edges >= divider) {
+			uint32_t capture = (uint32_t)(wheel->next_edge * CODER_FLOAT_TICK_HZ) & _COUNTER_MASK;
+
+			Host_DmaReceive(&wheel->hdma, &capture, 1);
+			wheel->edges = 0;
+		}
+		wheel->next_edge += 1 / (CODER_FLOAT_NB_STEPS * wheel->speed);
+	}
+}
+
+/*
+ * duration_ms of both wheels, with the main loop every ms (run) or once at
+ * the end (stall). The speed errors are taken after each main loop
+ */
+void _Play(uint32_t duration_ms, bool run) {
+	for (uint32_t ms = 0; ms < duration_ms; ms++) {
+		double loop_end = (Host_GetTimeUs() + _LOOP_US) * 1e-6;
+
+		for (uint8_t cpt = 0; cpt < 2; cpt++) _Edges(&s_wheels[cpt], loop_end);
+		Host_Advance(_LOOP_US);
+		if (!run && ms + 1 < duration_ms) continue;
+
+		for (uint8_t cpt = 0; cpt < 2; cpt++) {
+			TEST_Wheel* wheel = &s_wheels[cpt];
+			double error;
+
+			CoderInterface_Run(&wheel->coder);
+			if (wheel->speed > 0) error = fabs(wheel->coder.speed_q16 / 65536.0 - wheel->speed) / wheel->speed;
+			else error = (wheel->coder.speed_q16 != 0);
+			if (error > wheel->max_error) wheel->max_error = error;
+		}
+	}
+}
+
+void _ResetError(void) {
+	s_wheels[0].max_error = 0;
+	s_wheels[1].max_error = 0;
+}
+
+/*
+ * Both rings wrap many times, each coder follows its own wheel
+ */
+void Test_Independent(void) {
+	static const double s_speeds[][2] = {{20, 50}, {50, 20}, {3, 150}, {150, 150}};
+
+	for (uint32_t index = 0; index < sizeof(s_speeds) / sizeof(s_speeds[0]); index++) {
+		_SetSpeed(&s_wheels[0], s_speeds[index][0]);
+		_SetSpeed(&s_wheels[1], s_speeds[index][1]);
+		_Play(500, true);																		// settle
+		_ResetError();
+		_Play(1500, true);
+		printf("  %5.0f / %5.0f turns/s  max error %.2f%% / %.2f%%\n", s_speeds[index][0], s_speeds[index][1],
+				s_wheels[0].max_error * 100, s_wheels[1].max_error * 100);
+		TEST_CHECK(s_wheels[0].max_error < _MAX_ERROR);
+		TEST_CHECK(s_wheels[1].max_error < _MAX_ERROR);
+	}
+	TEST_EQUAL(s_wheels[0].coder.nb_laps, 0);
+	TEST_EQUAL(s_wheels[1].coder.nb_laps, 0);
+}
+
+/*
+ * One wheel stops past the timeout while the other keeps turning, then
+ * starts again
+ */
+void Test_Stop(void) {
+	_SetSpeed(&s_wheels[0], 40);
+	_SetSpeed(&s_wheels[1], 25);
+	_Play(500, true);
+	_SetSpeed(&s_wheels[0], 0);
+	_ResetError();
+	_Play(_TIMEOUT_MS + 100, true);
+	TEST_EQUAL(s_wheels[0].coder.speed_q16, 0);
+	TEST_CHECK(s_wheels[1].max_error < _MAX_ERROR);
+
+	_SetSpeed(&s_wheels[0], 60);
+	_Play(500, true);
+	_ResetError();
+	_Play(1000, true);
+	TEST_CHECK(s_wheels[0].max_error < _MAX_ERROR);
+	TEST_CHECK(s_wheels[1].max_error < _MAX_ERROR);
+	TEST_EQUAL(s_wheels[0].coder.nb_laps, 0);
+}
+
+/*
+ * Main loop stalls of 15 to 200 ms: 3000 edges per s write 45 to 600
+ * captures in the 64 of the small ring (less than 64 is not a lap), less
+ * than half of the large one
+ */
+void Test_Lap(void) {
+	static const uint32_t s_stalls_ms[] = {15, 22, 30, 43, 50, 100, 200};
+	uint32_t laps = s_wheels[0].coder.nb_laps;
+
+	_SetSpeed(&s_wheels[0], 100);
+	_SetSpeed(&s_wheels[1], 8);
+	_Play(500, true);
+	for (uint32_t index = 0; index < sizeof(s_stalls_ms) / sizeof(s_stalls_ms[0]); index++) {
+		uint32_t nb_captures = (uint32_t)(s_stalls_ms[index] * 100 * CODER_FLOAT_NB_STEPS / 1000);
+
+		_ResetError();
+		_Play(s_stalls_ms[index], false);
+		if (nb_captures >= 64) laps++;
+		TEST_EQUAL(s_wheels[0].coder.nb_laps, laps);
+		_Play(300, true);
+		printf("  stall %3u ms  %3u captures  max error %.2f%% / %.2f%%\n", s_stalls_ms[index], nb_captures,
+				s_wheels[0].max_error * 100, s_wheels[1].max_error * 100);
+		TEST_CHECK(s_wheels[0].max_error < _MAX_ERROR);
+		TEST_CHECK(s_wheels[1].max_error < _MAX_ERROR);
+	}
+	TEST_EQUAL(s_wheels[0].coder.nb_laps, laps);
+	TEST_EQUAL(s_wheels[1].coder.nb_laps, 0);
+}
@@ -0,0 +1,195 @@
+/**
+ ******************************************************************************
+ * @file test_coder_encoder.c
+ * @brief Host test implementation file
+ *        Coder encoder mode, 16 bits counter extended to 32 bits
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * built with CODER_ENCODER_MODE. The timer is faked: the test moves a 64 bits
+ * position, the counter is its low 16 bits and each wrap raises the update
+ * flag. The update interrupt runs after the move, or later to check the
+ * position read while it is pending. CoderInterface_GetPosition() must
+ * always give the fake position. The update flag of a timer without coder
+ * is cleared too, and only 16 bits counters are accepted.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "CoderInterface.h"
+
+#include <stdlib.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _COUNTER_RANGE 			(0x10000)
+#define _COUNTS_PER_TURN 		(120)		// CODER_COUNTS_PER_TURN, 4 * 30 steps
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static TIM_HandleTypeDef s_htim;
+static Coder s_coder;
+static int64_t s_position;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Move(int32_t delta, bool run_irq);
+static void _RunIRQ(void);
+static void Test_Forward(void);
+static void Test_Backward(void);
+static void Test_PendingIRQ(void);
+static void Test_Jitter(void);
+static void Test_Speed(void);
+static void Test_OtherTimer(void);
+static void Test_CounterRange(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	s_htim.Instance = TIM4;
+	s_htim.Instance->ARR = _COUNTER_RANGE - 1;
+	if (!CoderInterface_Init(&s_coder, &s_htim)) {
+		printf("cannot start the coder\n");
+		return 1;
+	}
+	srand(22);
+
+	TEST_RUN(Test_Forward);
+	TEST_RUN(Test_Backward);
+	TEST_RUN(Test_PendingIRQ);
+	TEST_RUN(Test_Jitter);
+	TEST_RUN(Test_Speed);
+	TEST_RUN(Test_OtherTimer);
+	TEST_RUN(Test_CounterRange);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Moves the fake encoder by delta counts (less than half the counter range),
+ * the counter wraps at most once
+ */
+void _Move(int32_t delta, bool run_irq) {
+	int64_t target = s_position + delta;
+
+	if ((target >> 16) != (s_position >> 16)) s_htim.Instance->SR |= TIM_FLAG_UPDATE;
+	s_htim.Instance->CNT = (uint32_t)(target & (_COUNTER_RANGE - 1));
+	s_position = target;
+	if (run_irq) _RunIRQ();
+}
+
+void _RunIRQ(void) {
+	Host_RunIRQ((Host_Callback) CoderInterface_UpdateIRQ, &s_htim);
+}
+
+void Test_Forward(void) {
+	for (uint32_t cpt = 0; cpt < 2000; cpt++) {
+		_Move(rand() % 30000, true);
+		TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+	}
+	TEST_CHECK(s_position > 10 * _COUNTER_RANGE);
+}
+
+/*
+ * Back through zero to negative positions
+ */
+void Test_Backward(void) {
+	while (s_position > -20 * _COUNTER_RANGE) {
+		_Move(-(rand() % 30000), true);
+		TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+	}
+}
+
+/*
+ * Counter wrapped but the update interrupt not run yet (masked or of lower
+ * priority), in both directions
+ */
+void Test_PendingIRQ(void) {
+	for (int32_t direction = 1; direction >= -1; direction -= 2) {
+		for (uint32_t cpt = 0; cpt < 200; cpt++) {
+			int32_t to_wrap = (direction > 0) ? _COUNTER_RANGE - (int32_t)(s_position & (_COUNTER_RANGE - 1))
+																				: -(int32_t)(s_position & (_COUNTER_RANGE - 1)) - 1;
+
+			_Move(to_wrap + direction * (rand() % 20000), false);
+			TEST_CHECK(__HAL_TIM_GET_FLAG(&s_htim, TIM_FLAG_UPDATE));
+			TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+			_RunIRQ();
+			TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+			_Move(direction * (rand() % 10000), true);
+			TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+		}
+	}
+}
+
+/*
+ * Shaft resting on the wrap point: the counter goes back and forth between
+ * 0xFFFF and 0, one update per crossing
+ */
+void Test_Jitter(void) {
+	_Move(-(int32_t)(s_position & (_COUNTER_RANGE - 1)), true);		// counter at 0
+	for (uint32_t cpt = 0; cpt < 1000; cpt++) {
+		_Move((cpt & 1) ? 2 : -2, true);
+		TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+	}
+}
+
+/*
+ * Constant speed across many wraps, forward then backward
+ */
+void Test_Speed(void) {
+	static const int32_t s_counts_per_ms[] = {3000, -3000, 12};
+
+	for (uint32_t index = 0; index < sizeof(s_counts_per_ms) / sizeof(s_counts_per_ms[0]); index++) {
+		int32_t velocity = s_counts_per_ms[index];
+		double expected = abs(velocity) * 1000.0 / _COUNTS_PER_TURN;
+
+		for (uint32_t ms = 0; ms < 2000; ms++) {
+			_Move(velocity, true);
+			Host_Advance(1000);
+			CoderInterface_Run(&s_coder);
+		}
+		printf("  %6d counts/ms: %.3f turns/s (%.3f expected)\n", velocity, s_coder.speed_q16 / 65536.0, expected);
+		TEST_CHECK(s_coder.speed_q16 / 65536.0 > 0.99 * expected && s_coder.speed_q16 / 65536.0 < 1.01 * expected);
+		TEST_EQUAL(CoderInterface_GetDirection(&s_coder), (velocity > 0) ? 1 : -1);
+		TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+	}
+}
+
+/*
+ * An update of a timer without coder must not fire again forever, nor move
+ * the coder
+ */
+void Test_OtherTimer(void) {
+	TIM_HandleTypeDef htim = {.Instance = TIM3};
+
+	htim.Instance->SR |= TIM_FLAG_UPDATE;
+	Host_RunIRQ((Host_Callback) CoderInterface_UpdateIRQ, &htim);
+	TEST_CHECK(!__HAL_TIM_GET_FLAG(&htim, TIM_FLAG_UPDATE));
+	TEST_EQUAL(CoderInterface_GetPosition(&s_coder), s_position);
+}
+
+/*
+ * The position is extended by 0x10000 per update
+ */
+void Test_CounterRange(void) {
+	static const uint32_t s_reloads[] = {0xFFFFFFFF, 0x7FFF, 999};
+	Coder coder;
+	TIM_HandleTypeDef htim = {.Instance = TIM2};
+
+	for (uint32_t index = 0; index < sizeof(s_reloads) / sizeof(s_reloads[0]); index++) {
+		htim.Instance->ARR = s_reloads[index];
+		TEST_CHECK(!CoderInterface_Init(&coder, &htim));
+	}
+	htim.Instance->ARR = _COUNTER_RANGE - 1;
+	TEST_CHECK(CoderInterface_Init(&coder, &htim));
+}
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file test_coder_replay.c
+ * @brief Host test implementation file
+ *        Coder step response against the former 30 periods average
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the default response must follow a 20 to 40 turns/s step, and back, at
+ * least as fast as the average of the last 30 periods it replaced. The noise
+ * is measured at the final speed, on a constant speed trace after 1 s to
+ * settle: near the one of the average at 40 turns/s (0.7% with 5% period
+ * jitter), 0.9% at 20 turns/s where a window holds 3 edges.
+ * esw_coder_replay prints the whole table.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "coder_replay.h"
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _MAX_EDGES 		(8192)
+#define _STEP_SAMPLES 	(2000)		// ms
+#define _STEP_S 				(1.0)
+#define _NOISE_SAMPLES 	(3000)		// ms
+#define _SETTLE_S 			(1.0)
+#define _JITTER 				(0.05)
+#define _MAX_NOISE 			(0.012)		// relative RMS, 250 us ticks over a 5 ms window
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static double s_edges[_MAX_EDGES];
+static float 	s_old[_NOISE_SAMPLES];
+static float 	s_new[_NOISE_SAMPLES];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Step(double from, double to);
+static void Test_StepUp(void);
+static void Test_StepDown(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_CHECK(CoderReplay_Init());
+	TEST_RUN(Test_StepUp);
+	TEST_RUN(Test_StepDown);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Latency on the step trace, noise on a constant trace at the final speed
+ */
+void _Step(double from, double to) {
+	uint32_t nb_edges = CoderReplay_StepTrace(s_edges, _MAX_EDGES, from, to, _STEP_S, _STEP_SAMPLES / 1000.0, _JITTER);
+	CoderReplay_Output output = {s_old, s_new, _STEP_SAMPLES};
+	float latency_old, latency_new, noise_old, noise_new;
+
+	CoderReplay_Run(s_edges, nb_edges, CODER_RESPONSE_MEDIUM, &output);
+	latency_old = CoderReplay_Latency(s_old, output.nb_samples, from, to, _STEP_S);
+	latency_new = CoderReplay_Latency(s_new, output.nb_samples, from, to, _STEP_S);
+
+	output.nb_samples = _NOISE_SAMPLES;
+	nb_edges = CoderReplay_StepTrace(s_edges, _MAX_EDGES, to, to, 0, _NOISE_SAMPLES / 1000.0, _JITTER);
+	CoderReplay_Run(s_edges, nb_edges, CODER_RESPONSE_MEDIUM, &output);
+	noise_old = CoderReplay_Noise(s_old, output.nb_samples, to, _SETTLE_S);
+	noise_new = CoderReplay_Noise(s_new, output.nb_samples, to, _SETTLE_S);
+	printf("  %g -> %g turns/s  average %.0f ms %.2f%%, coder %.0f ms %.2f%%\n",
+			from, to, latency_old, noise_old * 100, latency_new, noise_new * 100);
+
+	TEST_CHECK(latency_new > 0);
+	TEST_CHECK(latency_new <= latency_old);
+	TEST_CHECK(noise_new > 0 && noise_new < _MAX_NOISE);
+}
+
+void Test_StepUp(void) {
+	_Step(20, 40);
+}
+
+void Test_StepDown(void) {
+	_Step(40, 20);
+}
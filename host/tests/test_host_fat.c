@@ -0,0 +1,113 @@
+/**
+ ******************************************************************************
+ * @file test_host_fat.c
+ * @brief Host test implementation file
+ *        SDIO_Interface reads on the FAT image stand-in
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ */
+#include "test.h"
+#include "host_fat.h"
+#include "SDIO_Interface.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _FILE_SIZE (100000)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint8_t s_data[_FILE_SIZE];
+static uint8_t s_read[_FILE_SIZE];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _ReadAll(char* name, uint32_t step);
+static void Test_Layout(void);
+static void Test_Contiguous(void);
+static void Test_Fragmented(void);
+static void Test_Seek(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	for (uint32_t cpt = 0; cpt < _FILE_SIZE; cpt++) {
+		s_data[cpt] = (uint8_t)(cpt ^ (cpt >> 9));
+	}
+	if (!HostFat_Format(4 * 1024 * 1024, 4)
+		|| !HostFat_AddFile("CONT.BIN", s_data, _FILE_SIZE, false)
+		|| !HostFat_AddFile("FRAG.BIN", s_data, _FILE_SIZE, true)
+		|| SDIO_Interface_MountSD() != FR_OK) {
+		printf("cannot build the volume\n");
+		return 1;
+	}
+
+	TEST_RUN(Test_Layout);
+	TEST_RUN(Test_Contiguous);
+	TEST_RUN(Test_Fragmented);
+	TEST_RUN(Test_Seek);
+	HostFat_Release();
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * Reads name by step bytes and compares with s_data
+ */
+void _ReadAll(char* name, uint32_t step) {
+	TEST_EQUAL(SDIO_Interface_OpenFile(SDIO_FILE_0, name), FR_OK);
+	TEST_EQUAL(SDIO_Interface_GetFileSize(SDIO_FILE_0), _FILE_SIZE);
+
+	for (uint32_t offset = 0; offset < _FILE_SIZE; offset += step) {
+		uint32_t length = (_FILE_SIZE - offset < step) ? _FILE_SIZE - offset : step;
+		TEST_EQUAL(SDIO_Interface_ReadFile(SDIO_FILE_0, &s_read[offset], length), FR_OK);
+	}
+	TEST_CHECK(memcmp(s_read, s_data, _FILE_SIZE) == 0);
+	SDIO_Interface_CloseFile(SDIO_FILE_0);
+}
+
+void Test_Layout(void) {
+	uint32_t total, free_space;
+
+	TEST_EQUAL(SDIO_Interface_CheckFile("CONT.BIN"), FR_OK);
+	TEST_EQUAL(SDIO_Interface_CheckFile("frag.bin"), FR_OK);		// 8.3 names are upper case
+	TEST_CHECK(SDIO_Interface_CheckFile("NONE.BIN") != FR_OK);
+	TEST_EQUAL(SDIO_Interface_CheckSD(&total, &free_space), FR_OK);
+	TEST_CHECK(total > 0 && free_space < total);
+}
+
+void Test_Contiguous(void) {
+	_ReadAll("CONT.BIN", 4096);
+	_ReadAll("CONT.BIN", 777);
+	_ReadAll("CONT.BIN", 1);
+}
+
+void Test_Fragmented(void) {
+	_ReadAll("FRAG.BIN", 4096);
+	_ReadAll("FRAG.BIN", 1000);
+}
+
+void Test_Seek(void) {
+	uint8_t data[16];
+
+	TEST_EQUAL(SDIO_Interface_OpenFile(SDIO_FILE_1, "FRAG.BIN"), FR_OK);
+	TEST_EQUAL(SDIO_Interface_SeekFile(SDIO_FILE_1, 70001), FR_OK);
+	TEST_EQUAL(SDIO_Interface_ReadFile(SDIO_FILE_1, data, sizeof(data)), FR_OK);
+	TEST_CHECK(memcmp(data, &s_data[70001], sizeof(data)) == 0);
+	TEST_EQUAL(SDIO_Interface_SeekFile(SDIO_FILE_1, 10), FR_OK);
+	TEST_EQUAL(SDIO_Interface_ReadFile(SDIO_FILE_1, data, sizeof(data)), FR_OK);
+	TEST_CHECK(memcmp(data, &s_data[10], sizeof(data)) == 0);
+	SDIO_Interface_CloseFile(SDIO_FILE_1);
+}
@@ -0,0 +1,253 @@
+/**
+ ******************************************************************************
+ * @file test_lcd.c
+ * @brief Host test implementation file
+ *        LCD asynchronous mode, timer started and stopped with the queue
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the update interrupt of TIM6 is played while its counter is enabled, one
+ * LCD_Interface_Run() per LCD_TICK_US. The nibbles are read on the GPIO at
+ * each falling edge of EN. Every queued command must reach the LCD, and the
+ * timer must stop once the queue is drained, until the next command. The
+ * time between falling edges must cover the HD44780 execution times.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "LCD_Interface.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _MAX_TICKS 		(10000)
+#define _MAX_NIBBLES 	(512)
+
+#define _POWER_UP_US 	(40000)
+#define _RESET_US 		(4100)		// after each nibble of the reset sequence
+#define _CLEAR_US 		(1520)		// clear display and return home
+#define _COMMAND_US 	(37)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static GPIO_TypeDef s_gpio;
+static TIM_HandleTypeDef s_htim;
+static LCD_data s_LCD;
+
+static uint8_t s_nibbles[_MAX_NIBBLES];		// RS << 4 | nibble
+static uint64_t s_falls_us[_MAX_NIBBLES];		// time of each EN falling edge
+static uint32_t s_nb_nibbles;
+static uint64_t s_stop_us;									// time the timer stopped
+static bool s_enable;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void 		_Setup(void);
+static void 		_Tick(void* context);
+static uint32_t _Drain(void);
+static bool 		_Running(void);
+static void 		_CheckDelays(uint32_t nb_single);
+static void 		Test_InitStops(void);
+static void 		Test_Restart(void);
+static void 		Test_QueueWhileRunning(void);
+static void 		Test_FullQueue(void);
+static void 		Test_NoTimer(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_InitStops);
+	TEST_RUN(Test_Restart);
+	TEST_RUN(Test_QueueWhileRunning);
+	TEST_RUN(Test_FullQueue);
+	TEST_RUN(Test_NoTimer);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Setup(void) {
+	Host_Init();
+	memset(&s_gpio, 0, sizeof(s_gpio));
+	memset(&s_htim, 0, sizeof(s_htim));
+	s_htim.Instance = TIM6;
+
+	s_LCD = (LCD_data) {
+		.rows = 2, .display_cols = 16, .memory_cols = 40,
+		.RS = {&s_gpio, GPIO_PIN_0}, .RW = {&s_gpio, GPIO_PIN_1}, .EN = {&s_gpio, GPIO_PIN_2},
+		.D4 = {&s_gpio, GPIO_PIN_3}, .D5 = {&s_gpio, GPIO_PIN_4},
+		.D6 = {&s_gpio, GPIO_PIN_5}, .D7 = {&s_gpio, GPIO_PIN_6},
+		.htim = &s_htim,
+	};
+	s_nb_nibbles = 0;
+	s_enable = false;
+}
+
+/*
+ * Update interrupt: one step, then the nibble latched on the EN falling edge
+ */
+void _Tick(void* context) {
+	(void) context;
+	LCD_Interface_Run();
+
+	bool enable = s_gpio.ODR & GPIO_PIN_2;
+	if (s_enable && !enable && s_nb_nibbles < _MAX_NIBBLES) {
+		s_falls_us[s_nb_nibbles] = Host_GetTimeUs();
+		s_nibbles[s_nb_nibbles++] = ((s_gpio.ODR & GPIO_PIN_0) << 4) | ((s_gpio.ODR >> 3) & 0x0F);
+	}
+	s_enable = enable;
+}
+
+/*
+ * Ticks until the timer stops itself, _MAX_TICKS if it never does
+ */
+uint32_t _Drain(void) {
+	uint32_t ticks = 0;
+
+	while (_Running() && ticks < _MAX_TICKS) {
+		Host_Advance(LCD_TICK_US);
+		Host_RunIRQ(_Tick, NULL);
+		ticks++;
+	}
+	s_stop_us = Host_GetTimeUs();
+	return ticks;
+}
+
+bool _Running(void) {
+	return (s_htim.Instance->CR1 & TIM_CR1_CEN) && (s_htim.Instance->DIER & TIM_IT_UPDATE);
+}
+
+/*
+ * The recorded nibbles are nb_single reset nibbles then whole commands: each
+ * command must be done before the next falling edge, or the timer stop
+ */
+void _CheckDelays(uint32_t nb_single) {
+	uint32_t cpt = 0;
+
+	while (cpt < s_nb_nibbles) {
+		uint32_t last = (cpt < nb_single) ? cpt : cpt + 1;
+		uint64_t next_us = (last + 1 < s_nb_nibbles) ? s_falls_us[last + 1] : s_stop_us;
+		uint32_t min_us = _COMMAND_US;
+
+		if (last >= s_nb_nibbles) break;
+		if (cpt < nb_single) min_us = _RESET_US;
+		else if (!(s_nibbles[cpt] & 0x10) && ((s_nibbles[cpt] & 0x0F) << 4 | (s_nibbles[last] & 0x0F)) <= 0x03) min_us = _CLEAR_US;
+
+		if (next_us - s_falls_us[last] < min_us) {
+			printf("nibble %u: %u us after it, %u us min\n", last, (unsigned)(next_us - s_falls_us[last]), min_us);
+		}
+		TEST_CHECK(next_us - s_falls_us[last] >= min_us);
+		cpt = last + 1;
+	}
+	TEST_EQUAL(cpt, s_nb_nibbles);		// no half command
+}
+
+void Test_InitStops(void) {
+	static const uint8_t expected[] = {
+		0x3, 0x3, 0x3, 0x2,				// reset, 4 bits bus
+		0x2, 0x8, 0x0, 0x1, 0x0, 0x2, 0x0, 0xC, 0x0, 0x6,
+	};
+
+	_Setup();
+	TEST_CHECK(!_Running());
+	uint64_t init_us = Host_GetTimeUs();
+	TEST_CHECK(LCD_Interface_Init(&s_LCD));
+	TEST_CHECK(_Running());
+	TEST_EQUAL(Host_GetTimerStarts(&s_htim), 1);
+
+	uint32_t ticks = _Drain();
+	TEST_CHECK(ticks < _MAX_TICKS);
+	TEST_CHECK(ticks >= 50000 / LCD_TICK_US);		// power up wait
+	TEST_CHECK(!_Running());
+	TEST_EQUAL(s_nb_nibbles, sizeof(expected));
+	TEST_CHECK(memcmp(s_nibbles, expected, sizeof(expected)) == 0);
+	TEST_CHECK(s_falls_us[0] - init_us >= _POWER_UP_US);
+	_CheckDelays(4);
+}
+
+void Test_Restart(void) {
+	_Setup();
+	LCD_Interface_Init(&s_LCD);
+	_Drain();
+	s_nb_nibbles = 0;
+
+	Host_Advance(1000000);		// idle, no tick
+	LCD_Interface_PrintString((uint8_t*) "Hi", 2);
+	TEST_CHECK(_Running());
+	TEST_EQUAL(Host_GetTimerStarts(&s_htim), 2);
+	TEST_CHECK(_Drain() < 20);
+	TEST_CHECK(!_Running());
+	TEST_EQUAL(s_nb_nibbles, 4);
+	TEST_EQUAL(s_nibbles[0], 0x10 | ('H' >> 4));
+	TEST_EQUAL(s_nibbles[1], 0x10 | ('H' & 0x0F));
+	TEST_EQUAL(s_nibbles[2], 0x10 | ('i' >> 4));
+	TEST_EQUAL(s_nibbles[3], 0x10 | ('i' & 0x0F));
+	TEST_EQUAL(LCD_Interface_GetDropped(), 0);
+	_CheckDelays(0);
+}
+
+void Test_QueueWhileRunning(void) {
+	_Setup();
+	LCD_Interface_Init(&s_LCD);
+	_Drain();
+	s_nb_nibbles = 0;
+
+	LCD_Interface_PrintChar('a');
+	Host_Advance(LCD_TICK_US);
+	Host_RunIRQ(_Tick, NULL);
+	LCD_Interface_PrintChar('b');		// timer already running
+	TEST_EQUAL(Host_GetTimerStarts(&s_htim), 2);
+	_Drain();
+	TEST_CHECK(!_Running());
+	TEST_EQUAL(s_nb_nibbles, 4);
+	TEST_EQUAL(s_nibbles[3], 0x10 | ('b' & 0x0F));
+}
+
+/*
+ * More commands than the queue holds before the first tick: the extra ones
+ * are dropped and counted, the next ones go through
+ */
+void Test_FullQueue(void) {
+	const uint32_t nb_commands = LCD_QUEUE_SIZE / 2;
+
+	_Setup();
+	LCD_Interface_Init(&s_LCD);
+	_Drain();
+	s_nb_nibbles = 0;
+
+	for (uint32_t cpt = 0; cpt < nb_commands + 3; cpt++) LCD_Interface_SendData((uint8_t) cpt);
+	TEST_EQUAL(LCD_Interface_GetDropped(), 3);
+	_Drain();
+	TEST_EQUAL(s_nb_nibbles, 2 * nb_commands);
+	TEST_EQUAL(s_nibbles[2 * nb_commands - 1], 0x10 | ((nb_commands - 1) & 0x0F));
+
+	s_nb_nibbles = 0;
+	LCD_Interface_Home();
+	LCD_Interface_SendData('z');
+	_Drain();
+	TEST_CHECK(!_Running());
+	TEST_EQUAL(LCD_Interface_GetDropped(), 3);
+	TEST_EQUAL(s_nb_nibbles, 4);
+	TEST_EQUAL(s_nibbles[1], 0x02);
+	TEST_EQUAL(s_nibbles[3], 0x10 | ('z' & 0x0F));
+	_CheckDelays(0);
+}
+
+void Test_NoTimer(void) {
+	_Setup();
+	s_LCD.htim = NULL;
+	TEST_CHECK(!LCD_Interface_Init(&s_LCD));
+	TEST_CHECK(!_Running());
+	TEST_EQUAL(Host_GetTimerStarts(&s_htim), 0);
+}
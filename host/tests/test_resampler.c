@@ -0,0 +1,206 @@
+/**
+ ******************************************************************************
+ * @file test_resampler.c
+ * @brief Host test implementation file
+ *        Resampler against a double precision linear interpolator
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * output k sits at k * step / 65536 input samples, between the input before
+ * that position and the one at it (the first interpolation starts from the
+ * initial value). The reference interpolates there in double: every output
+ * is within 1 LSB of truncation plus the phase LSB dropped by
+ * Resampler_Process() times the sample difference. Streams split in blocks of any size must give the
+ * same output as one block, and the phase accumulator must not drift from
+ * the exact count of input samples consumed.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "Resampler.h"
+
+#include <math.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _OUTPUT_RATE 	(44100)
+#define _NB_OUTPUT 		(20000)
+#define _MAX_INPUT 		(_NB_OUTPUT * 48000 / _OUTPUT_RATE + 2)
+#define _INITIAL 			(2048)
+#define _AMPLITUDE 		(30000)
+#define _LONG_SECONDS (600)
+#define _MAX_ERROR 		(1.0 + 2.0 * _AMPLITUDE / RESAMPLER_ONE)		// truncation, phase LSB dropped for the 32 bits product
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const uint32_t s_rates[] = {8000, 11025, 22050, 44100, 48000};
+
+static uint16_t s_input[_MAX_INPUT];
+static uint16_t s_output[_NB_OUTPUT];
+static uint16_t s_blocks[_NB_OUTPUT];
+static uint32_t s_seed = 7;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static uint32_t _Random(void);
+static void 		_Sine(uint32_t rate, double frequency);
+static double 	_X(int64_t index);
+static double 	_MaxError(const Resampler* rs, uint32_t nb_output);
+static void 		Test_Dc(void);
+static void 		Test_Sine(void);
+static void 		Test_Blocks(void);
+static void 		Test_Drift(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Dc);
+	TEST_RUN(Test_Sine);
+	TEST_RUN(Test_Blocks);
+	TEST_RUN(Test_Drift);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t _Random(void) {
+	s_seed = s_seed * 1103515245 + 12345;
+	return s_seed >> 8;
+}
+
+void _Sine(uint32_t rate, double frequency) {
+	for (uint32_t cpt = 0; cpt < _MAX_INPUT; cpt++) {
+		s_input[cpt] = (uint16_t)(32768 + lround(_AMPLITUDE * sin(2 * M_PI * frequency * cpt / rate)));
+	}
+}
+
+/*
+ * Input j, the initial value before the first one
+ */
+double _X(int64_t index) {
+	return (index < 0) ? _INITIAL : s_input[index];
+}
+
+/*
+ * Largest difference between s_output and the double interpolation at the
+ * positions of rs->step, from the initial state
+ */
+double _MaxError(const Resampler* rs, uint32_t nb_output) {
+	double max_error = 0;
+
+	for (uint32_t cpt = 0; cpt < nb_output; cpt++) {
+		double position = (double) cpt * rs->step / RESAMPLER_ONE;
+		int64_t index = (int64_t) position;
+		double expected = _X(index - 2) + (_X(index - 1) - _X(index - 2)) * (position - index);
+		double error = fabs(s_output[cpt] - expected);
+
+		if (error > max_error) max_error = error;
+	}
+	return max_error;
+}
+
+/*
+ * Constant input: constant output, at every rate
+ */
+void Test_Dc(void) {
+	for (uint32_t rate = 0; rate < sizeof(s_rates) / sizeof(s_rates[0]); rate++) {
+		Resampler rs;
+		uint32_t nb_input;
+
+		for (uint32_t cpt = 0; cpt < _MAX_INPUT; cpt++) s_input[cpt] = _INITIAL;
+		Resampler_Init(&rs, s_rates[rate], _OUTPUT_RATE, _INITIAL);
+		nb_input = Resampler_GetInputCount(&rs, _NB_OUTPUT);
+		TEST_CHECK(nb_input <= _MAX_INPUT);
+		Resampler_Process(&rs, s_input, s_output, _NB_OUTPUT);
+
+		uint32_t wrong = 0;
+		for (uint32_t cpt = 0; cpt < _NB_OUTPUT; cpt++) wrong += s_output[cpt] != _INITIAL;
+		TEST_EQUAL(wrong, 0);
+	}
+}
+
+void Test_Sine(void) {
+	static const double frequencies[] = {50, 1000, 3500};
+
+	for (uint32_t rate = 0; rate < sizeof(s_rates) / sizeof(s_rates[0]); rate++) {
+		for (uint32_t frequency = 0; frequency < sizeof(frequencies) / sizeof(frequencies[0]); frequency++) {
+			Resampler rs;
+
+			_Sine(s_rates[rate], frequencies[frequency]);
+			Resampler_Init(&rs, s_rates[rate], _OUTPUT_RATE, _INITIAL);
+			Resampler_Process(&rs, s_input, s_output, _NB_OUTPUT);
+			double error = _MaxError(&rs, _NB_OUTPUT);
+
+			if (frequency == 1) printf("  %5u Hz -> %u Hz  max error %.3f LSB\n", s_rates[rate], _OUTPUT_RATE, error);
+			TEST_CHECK(error < _MAX_ERROR);
+		}
+	}
+}
+
+/*
+ * Random block sizes, each fed with the input count it asks for
+ */
+void Test_Blocks(void) {
+	for (uint32_t rate = 0; rate < sizeof(s_rates) / sizeof(s_rates[0]); rate++) {
+		Resampler whole, split;
+		uint32_t nb_output = 0, nb_input = 0;
+
+		_Sine(s_rates[rate], 440);
+		Resampler_Init(&whole, s_rates[rate], _OUTPUT_RATE, _INITIAL);
+		Resampler_Process(&whole, s_input, s_output, _NB_OUTPUT);
+
+		Resampler_Init(&split, s_rates[rate], _OUTPUT_RATE, _INITIAL);
+		while (nb_output < _NB_OUTPUT) {
+			uint32_t block = 1 + _Random() % 300;
+			if (block > _NB_OUTPUT - nb_output) block = _NB_OUTPUT - nb_output;
+
+			uint32_t needed = Resampler_GetInputCount(&split, block);
+			TEST_CHECK(Resampler_GetOutputCount(&split, needed) >= block);
+			Resampler_Process(&split, &s_input[nb_input], &s_blocks[nb_output], block);
+			nb_input += needed;
+			nb_output += block;
+		}
+		TEST_CHECK(memcmp(s_output, s_blocks, sizeof(s_output)) == 0);
+		TEST_EQUAL(split.phase, whole.phase);
+		TEST_EQUAL(nb_input, (uint32_t)(((uint64_t) _NB_OUTPUT * whole.step) >> 16));
+	}
+}
+
+/*
+ * _LONG_SECONDS of output: the input consumed is exactly the sum of the
+ * steps, whose rate error stays within the Q16 rounding
+ */
+void Test_Drift(void) {
+	for (uint32_t rate = 0; rate < sizeof(s_rates) / sizeof(s_rates[0]); rate++) {
+		uint64_t nb_output = (uint64_t) _LONG_SECONDS * _OUTPUT_RATE;
+		uint64_t nb_input = 0;
+		Resampler rs;
+
+		for (uint32_t cpt = 0; cpt < _MAX_INPUT; cpt++) s_input[cpt] = _Random();
+		Resampler_Init(&rs, s_rates[rate], _OUTPUT_RATE, _INITIAL);
+		for (uint64_t done = 0; done < nb_output; done += _NB_OUTPUT) {
+			uint32_t needed = Resampler_GetInputCount(&rs, _NB_OUTPUT);
+			Resampler_Process(&rs, s_input, s_output, _NB_OUTPUT);
+			nb_input += needed;
+		}
+
+		uint64_t steps = nb_output * rs.step;
+		double exact = (double) nb_output * s_rates[rate] / _OUTPUT_RATE;
+		double ppm = (nb_input - exact) / exact * 1e6;
+
+		printf("  %5u Hz, %u s: %llu input samples, %+.1f ppm\n", s_rates[rate], _LONG_SECONDS, (unsigned long long) nb_input, ppm);
+		TEST_EQUAL(nb_input, steps >> 16);
+		TEST_EQUAL(rs.phase, steps & 0xFFFF);
+		TEST_CHECK(fabs(ppm) <= 1e6 * _OUTPUT_RATE / (131072.0 * s_rates[rate]));
+	}
+}
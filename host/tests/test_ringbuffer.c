@@ -0,0 +1,147 @@
+/**
+ ******************************************************************************
+ * @file test_ringbuffer.c
+ * @brief Host test implementation file
+ *        RingBuffer zero-copy spans: Reserve/Commit and Peek/Consume
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * a span never crosses the end of the storage: at the wrap two spans are
+ * needed, the second one at the start. A Commit or Consume longer than the
+ * span or the data must be refused and leave the buffer untouched.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "RingBuffer.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _SIZE (16)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static RingBuffer s_buf;
+static uint8_t s_storage[_SIZE];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Fill(uint32_t length, uint8_t first);
+static void Test_WrapSpans(void);
+static void Test_Full(void);
+static void Test_TooLong(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_WrapSpans);
+	TEST_RUN(Test_Full);
+	TEST_RUN(Test_TooLong);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * length bytes first, first + 1... through Reserve/Commit
+ */
+void _Fill(uint32_t length, uint8_t first) {
+	while (length) {
+		uint8_t* span;
+		uint32_t available = RingBuffer_Reserve(&s_buf, &span);
+		uint32_t count = (available < length) ? available : length;
+
+		for (uint32_t cpt = 0; cpt < count; cpt++) span[cpt] = first++;
+		TEST_EQUAL(RingBuffer_Commit(&s_buf, count), RB_OK);
+		length -= count;
+		if (!count) break;
+	}
+}
+
+void Test_WrapSpans(void) {
+	const uint8_t* data;
+	uint8_t* span;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	_Fill(12, 0);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 10), RB_OK);		// read and write near the end
+
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 4);			// up to the end only
+	TEST_CHECK(span == &s_storage[12]);
+	_Fill(10, 12);																				// 4 at the end, 6 at the start
+	TEST_EQUAL(RingBuffer_GetSize(&s_buf), 12);
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 4);
+	TEST_CHECK(span == &s_storage[6]);
+
+	TEST_EQUAL(RingBuffer_Peek(&s_buf, &data), 6);				// 10..15, up to the end
+	TEST_CHECK(data == &s_storage[10]);
+	TEST_EQUAL(data[0], 10);
+	TEST_EQUAL(data[5], 15);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 6), RB_OK);
+
+	TEST_EQUAL(RingBuffer_Peek(&s_buf, &data), 6);				// 16..21, after the wrap
+	TEST_CHECK(data == &s_storage[0]);
+	TEST_EQUAL(data[0], 16);
+	TEST_EQUAL(data[5], 21);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 6), RB_OK);
+	TEST_EQUAL(RingBuffer_Peek(&s_buf, &data), 0);
+	TEST_CHECK(RingBuffer_IsEmpty(&s_buf));
+}
+
+void Test_Full(void) {
+	const uint8_t* data;
+	uint8_t* span;
+	uint8_t byte;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	_Fill(5, 0);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 5), RB_OK);
+	_Fill(_SIZE, 100);																		// full, wrapped
+	TEST_EQUAL(RingBuffer_GetRemainingSize(&s_buf), 0);
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 0);
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 0), RB_OK);
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 1), RB_NOT_ENOUGH_SPACE);
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_BUFFER_FULL);
+
+	TEST_EQUAL(RingBuffer_Peek(&s_buf, &data), _SIZE - 5);
+	TEST_EQUAL(data[0], 100);
+	for (uint32_t cpt = 0; cpt < _SIZE; cpt++) {						// the same bytes through Get
+		TEST_EQUAL(RingBuffer_Get(&s_buf, &byte), RB_OK);
+		TEST_EQUAL(byte, (uint8_t)(100 + cpt));
+	}
+	TEST_EQUAL(RingBuffer_Peek(&s_buf, &data), 0);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 0), RB_OK);
+}
+
+void Test_TooLong(void) {
+	const uint8_t* data;
+	uint8_t* span;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	_Fill(14, 0);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 10), RB_OK);		// 4 bytes, write at 14
+
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 2);
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 3), RB_NOT_ENOUGH_SPACE);		// space, but past the span
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 13), RB_NOT_ENOUGH_SPACE);		// past the space
+	TEST_EQUAL(RingBuffer_GetSize(&s_buf), 4);
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 2);
+	TEST_CHECK(span == &s_storage[14]);
+
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 5), RB_NOT_ENOUGH_DATA);
+	TEST_EQUAL(RingBuffer_GetSize(&s_buf), 4);
+	TEST_EQUAL(RingBuffer_Peek(&s_buf, &data), 4);
+	TEST_EQUAL(data[0], 10);
+	TEST_EQUAL(data[3], 13);
+}
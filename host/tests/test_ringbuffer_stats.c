@@ -0,0 +1,344 @@
+/**
+ ******************************************************************************
+ * @file test_ringbuffer_stats.c
+ * @brief Host test implementation file
+ *        Fill statistics and threshold callback of RingBuffer and
+ *        SPSC_RingBuffer, built with RINGBUFFER_STATS
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the callback must fire once each time the fill crosses a threshold, in
+ * both directions, whatever the access: byte, block or zero-copy span.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "RingBuffer.h"
+#include "SPSC_RingBuffer.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _SIZE 					(16)
+#define _LOW_THRESHOLD 	(4)
+#define _HIGH_THRESHOLD (12)
+#define _MAX_EVENTS 		(16)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static RingBuffer s_buf;
+static SPSC_RingBuffer s_spsc;
+static uint8_t s_storage[_SIZE];
+static uint8_t s_data[_SIZE];
+
+static RB_EVENT s_events[_MAX_EVENTS];
+static uint32_t s_nb_events;
+static void* s_context;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _OnThreshold(RB_EVENT event, void* context);
+static void _CheckEvents(uint32_t nb_events, RB_EVENT last);
+static uint32_t _SpscWrite(uint32_t length);
+static uint32_t _SpscRead(uint32_t length);
+static void Test_Watermarks(void);
+static void Test_Rejected(void);
+static void Test_Thresholds(void);
+static void Test_SpscWatermarks(void);
+static void Test_SpscRejected(void);
+static void Test_SpscThresholds(void);
+static void Test_Reset(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Watermarks);
+	TEST_RUN(Test_Rejected);
+	TEST_RUN(Test_Thresholds);
+	TEST_RUN(Test_SpscWatermarks);
+	TEST_RUN(Test_SpscRejected);
+	TEST_RUN(Test_SpscThresholds);
+	TEST_RUN(Test_Reset);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _OnThreshold(RB_EVENT event, void* context) {
+	s_context = context;
+	if (s_nb_events < _MAX_EVENTS) s_events[s_nb_events] = event;
+	s_nb_events++;
+}
+
+/*
+ * nb_events callbacks so far, the last one being last
+ */
+void _CheckEvents(uint32_t nb_events, RB_EVENT last) {
+	TEST_EQUAL(s_nb_events, nb_events);
+	if (s_nb_events && s_nb_events <= _MAX_EVENTS) TEST_EQUAL(s_events[s_nb_events - 1], last);
+}
+
+/*
+ * Producer side through Reserve/Commit, returns the bytes written
+ */
+uint32_t _SpscWrite(uint32_t length) {
+	uint32_t written = 0;
+
+	while (written < length) {
+		uint8_t* span;
+		uint32_t count = SPSC_RingBuffer_Reserve(&s_spsc, &span);
+
+		if (count > length - written) count = length - written;
+		if (!count) break;
+		memset(span, (uint8_t) written, count);
+		TEST_EQUAL(SPSC_RingBuffer_Commit(&s_spsc, count), RB_OK);
+		written += count;
+	}
+	return written;
+}
+
+/*
+ * Consumer side through Peek/Consume, returns the bytes read
+ */
+uint32_t _SpscRead(uint32_t length) {
+	uint32_t read = 0;
+
+	while (read < length) {
+		const uint8_t* span;
+		uint32_t count = SPSC_RingBuffer_Peek(&s_spsc, &span);
+
+		if (count > length - read) count = length - read;
+		if (!count) break;
+		TEST_EQUAL(SPSC_RingBuffer_Consume(&s_spsc, count), RB_OK);
+		read += count;
+	}
+	return read;
+}
+
+void Test_Watermarks(void) {
+	RingBuffer_Stats stats;
+	uint8_t* span;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	RingBuffer_GetStats(&s_buf, &stats);
+	TEST_EQUAL(stats.high_watermark, 0);
+	TEST_EQUAL(stats.low_watermark, _SIZE);
+
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, 10), RB_OK);
+	TEST_EQUAL(RingBuffer_GetSeveral(&s_buf, s_data, 7), RB_OK);		// 3 left
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_OK);
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 5);								// write at 11, up to the end
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 5), RB_OK);								// 9
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 7);
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 3), RB_OK);								// 12
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 4), RB_OK);								// 8
+	TEST_EQUAL(RingBuffer_Get(&s_buf, s_data), RB_OK);							// 7
+
+	RingBuffer_GetStats(&s_buf, &stats);
+	TEST_EQUAL(stats.high_watermark, 12);
+	TEST_EQUAL(stats.low_watermark, 3);
+	TEST_EQUAL(stats.bytes_in, 19);
+	TEST_EQUAL(stats.bytes_out, 12);
+	TEST_EQUAL(stats.overflows, 0);
+	TEST_EQUAL(stats.underflows, 0);
+}
+
+/*
+ * Every rejected access counts once and moves no byte
+ */
+void Test_Rejected(void) {
+	RingBuffer_Stats stats;
+	uint8_t* span;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	TEST_EQUAL(RingBuffer_Get(&s_buf, s_data), RB_BUFFER_EMPTY);
+	TEST_EQUAL(RingBuffer_GetSeveral(&s_buf, s_data, 1), RB_NOT_ENOUGH_DATA);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, 1), RB_NOT_ENOUGH_DATA);
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, _SIZE - 2), RB_OK);
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, 3), RB_NOT_ENOUGH_SPACE);
+	TEST_EQUAL(RingBuffer_Reserve(&s_buf, &span), 2);
+	TEST_EQUAL(RingBuffer_Commit(&s_buf, 3), RB_NOT_ENOUGH_SPACE);
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, 2), RB_OK);
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_BUFFER_FULL);
+	TEST_EQUAL(RingBuffer_IgnoreSeveral(&s_buf, _SIZE + 1), RB_NOT_ENOUGH_DATA);
+
+	RingBuffer_GetStats(&s_buf, &stats);
+	TEST_EQUAL(stats.overflows, 3);
+	TEST_EQUAL(stats.underflows, 4);
+	TEST_EQUAL(stats.bytes_in, _SIZE);
+	TEST_EQUAL(stats.bytes_out, 0);
+	TEST_EQUAL(stats.high_watermark, _SIZE);
+	TEST_EQUAL(stats.low_watermark, _SIZE);		// no read yet
+}
+
+void Test_Thresholds(void) {
+	int marker;
+	uint8_t byte;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	s_nb_events = 0;
+	RingBuffer_SetThresholds(&s_buf, _LOW_THRESHOLD, _HIGH_THRESHOLD, _OnThreshold, &marker);
+
+	for (uint32_t cpt = 0; cpt < _SIZE; cpt++) {						// up to full byte by byte
+		TEST_EQUAL(RingBuffer_Put(&s_buf, (uint8_t) cpt), RB_OK);
+		_CheckEvents(cpt + 1 >= _HIGH_THRESHOLD, RB_EVENT_HIGH);
+	}
+	TEST_CHECK(s_context == &marker);
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_BUFFER_FULL);
+	_CheckEvents(1, RB_EVENT_HIGH);
+
+	for (uint32_t cpt = 0; cpt < _SIZE; cpt++) {						// down to empty byte by byte
+		TEST_EQUAL(RingBuffer_Get(&s_buf, &byte), RB_OK);
+		_CheckEvents(1 + (_SIZE - cpt - 1 <= _LOW_THRESHOLD), (_SIZE - cpt - 1 <= _LOW_THRESHOLD) ? RB_EVENT_LOW : RB_EVENT_HIGH);
+	}
+
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, _HIGH_THRESHOLD - 1), RB_OK);
+	_CheckEvents(2, RB_EVENT_LOW);
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, 3), RB_OK);		// block across the threshold
+	_CheckEvents(3, RB_EVENT_HIGH);
+	TEST_EQUAL(RingBuffer_GetSeveral(&s_buf, s_data, 3), RB_OK);		// 11, back under
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_OK);										// 12, crossed again
+	_CheckEvents(4, RB_EVENT_HIGH);
+	TEST_EQUAL(RingBuffer_Consume(&s_buf, _SIZE - 5), RB_OK);				// 1, from above the high
+	_CheckEvents(5, RB_EVENT_LOW);
+	TEST_EQUAL(RingBuffer_IgnoreSeveral(&s_buf, 1), RB_OK);					// still under the low
+	_CheckEvents(5, RB_EVENT_LOW);
+
+	RingBuffer_SetThresholds(&s_buf, 0, 0, NULL, NULL);
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, _SIZE), RB_OK);
+	TEST_EQUAL(RingBuffer_GetAll(&s_buf, s_data), RB_OK);
+	_CheckEvents(5, RB_EVENT_LOW);
+}
+
+void Test_SpscWatermarks(void) {
+	RingBuffer_Stats stats;
+	uint8_t byte;
+
+	TEST_EQUAL(SPSC_RingBuffer_Init(&s_spsc, s_storage, _SIZE), RB_OK);
+	SPSC_RingBuffer_GetStats(&s_spsc, &stats);
+	TEST_EQUAL(stats.high_watermark, 0);
+	TEST_EQUAL(stats.low_watermark, _SIZE);
+
+	TEST_EQUAL(_SpscWrite(10), 10);
+	TEST_EQUAL(_SpscRead(7), 7);															// 3
+	TEST_EQUAL(SPSC_RingBuffer_Put(&s_spsc, 0), RB_OK);
+	TEST_EQUAL(_SpscWrite(8), 8);															// 12, across the wrap
+	TEST_EQUAL(_SpscRead(9), 9);															// 3, up to the wrap
+	TEST_EQUAL(SPSC_RingBuffer_PutSeveral(&s_spsc, s_data, 5), RB_OK);
+	TEST_EQUAL(SPSC_RingBuffer_Get(&s_spsc, &byte), RB_OK);		// 7
+	TEST_EQUAL(SPSC_RingBuffer_GetSeveral(&s_spsc, s_data, 2), RB_OK);
+
+	SPSC_RingBuffer_GetStats(&s_spsc, &stats);
+	TEST_EQUAL(stats.high_watermark, 12);
+	TEST_EQUAL(stats.low_watermark, 3);
+	TEST_EQUAL(stats.bytes_in, 24);
+	TEST_EQUAL(stats.bytes_out, 19);
+	TEST_EQUAL(stats.overflows, 0);
+	TEST_EQUAL(stats.underflows, 0);
+}
+
+/*
+ * A Commit past the free space publishes what fits and counts one overflow
+ */
+void Test_SpscRejected(void) {
+	RingBuffer_Stats stats;
+	uint8_t byte;
+
+	TEST_EQUAL(SPSC_RingBuffer_Init(&s_spsc, s_storage, _SIZE), RB_OK);
+	TEST_EQUAL(SPSC_RingBuffer_Get(&s_spsc, &byte), RB_BUFFER_EMPTY);
+	TEST_EQUAL(SPSC_RingBuffer_GetSeveral(&s_spsc, s_data, 1), RB_NOT_ENOUGH_DATA);
+	TEST_EQUAL(SPSC_RingBuffer_Consume(&s_spsc, 1), RB_NOT_ENOUGH_DATA);
+	TEST_EQUAL(SPSC_RingBuffer_IgnoreSeveral(&s_spsc, 1), RB_NOT_ENOUGH_DATA);
+	TEST_EQUAL(_SpscWrite(_SIZE - 2), _SIZE - 2);
+	TEST_EQUAL(SPSC_RingBuffer_PutSeveral(&s_spsc, s_data, 3), RB_NOT_ENOUGH_SPACE);
+	TEST_EQUAL(SPSC_RingBuffer_Commit(&s_spsc, 3), RB_NOT_ENOUGH_SPACE);		// 2 published
+	TEST_EQUAL(SPSC_RingBuffer_GetSize(&s_spsc), _SIZE);
+	TEST_EQUAL(SPSC_RingBuffer_Put(&s_spsc, 0), RB_BUFFER_FULL);
+
+	SPSC_RingBuffer_GetStats(&s_spsc, &stats);
+	TEST_EQUAL(stats.overflows, 3);
+	TEST_EQUAL(stats.underflows, 4);
+	TEST_EQUAL(stats.bytes_in, _SIZE);
+	TEST_EQUAL(stats.bytes_out, 0);
+	TEST_EQUAL(stats.high_watermark, _SIZE);
+	TEST_EQUAL(stats.low_watermark, _SIZE);
+}
+
+void Test_SpscThresholds(void) {
+	int marker;
+
+	TEST_EQUAL(SPSC_RingBuffer_Init(&s_spsc, s_storage, _SIZE), RB_OK);
+	s_nb_events = 0;
+	SPSC_RingBuffer_SetThresholds(&s_spsc, _LOW_THRESHOLD, _HIGH_THRESHOLD, _OnThreshold, &marker);
+
+	TEST_EQUAL(_SpscWrite(5), 5);
+	_CheckEvents(0, RB_EVENT_LOW);
+	TEST_EQUAL(_SpscRead(5), 5);															// from above the low, write at 5
+	_CheckEvents(1, RB_EVENT_LOW);
+	TEST_CHECK(s_context == &marker);
+	TEST_EQUAL(_SpscWrite(_SIZE), _SIZE);											// two spans, 11 then 5
+	_CheckEvents(2, RB_EVENT_HIGH);
+	TEST_EQUAL(_SpscWrite(1), 0);
+	_CheckEvents(2, RB_EVENT_HIGH);
+
+	TEST_EQUAL(_SpscRead(_SIZE), _SIZE);											// two spans, 11 then 5
+	_CheckEvents(3, RB_EVENT_LOW);
+	TEST_EQUAL(_SpscWrite(_HIGH_THRESHOLD - 1), _HIGH_THRESHOLD - 1);
+	_CheckEvents(3, RB_EVENT_LOW);
+
+	for (uint32_t cpt = 0; cpt < 3; cpt++) {									// around the high threshold
+		TEST_EQUAL(SPSC_RingBuffer_Put(&s_spsc, 0), RB_OK);
+		_CheckEvents(4 + cpt, RB_EVENT_HIGH);
+		TEST_EQUAL(_SpscRead(1), 1);
+	}
+	TEST_EQUAL(_SpscRead(_HIGH_THRESHOLD - 1 - _LOW_THRESHOLD), _HIGH_THRESHOLD - 1 - _LOW_THRESHOLD);
+	_CheckEvents(7, RB_EVENT_LOW);
+	for (uint32_t cpt = 0; cpt < 3; cpt++) {									// around the low threshold
+		TEST_EQUAL(SPSC_RingBuffer_PutSeveral(&s_spsc, s_data, 1), RB_OK);
+		TEST_EQUAL(SPSC_RingBuffer_IgnoreSeveral(&s_spsc, 1), RB_OK);
+		_CheckEvents(8 + cpt, RB_EVENT_LOW);
+	}
+}
+
+/*
+ * The watermarks restart from the current fill
+ */
+void Test_Reset(void) {
+	RingBuffer_Stats stats;
+
+	RingBuffer_Init(&s_buf, s_storage, _SIZE);
+	TEST_EQUAL(RingBuffer_PutSeveral(&s_buf, s_data, 9), RB_OK);
+	TEST_EQUAL(RingBuffer_GetSeveral(&s_buf, s_data, 1), RB_OK);
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_OK);
+	TEST_EQUAL(RingBuffer_Put(&s_buf, 0), RB_OK);
+	RingBuffer_ResetStats(&s_buf);																	// 10
+	TEST_EQUAL(RingBuffer_GetSeveral(&s_buf, s_data, 5), RB_OK);
+	RingBuffer_GetStats(&s_buf, &stats);
+	TEST_EQUAL(stats.high_watermark, 10);
+	TEST_EQUAL(stats.low_watermark, 5);
+	TEST_EQUAL(stats.bytes_in, 0);
+	TEST_EQUAL(stats.bytes_out, 5);
+
+	TEST_EQUAL(SPSC_RingBuffer_Init(&s_spsc, s_storage, _SIZE), RB_OK);
+	TEST_EQUAL(_SpscWrite(9), 9);
+	TEST_EQUAL(_SpscRead(3), 3);
+	SPSC_RingBuffer_ResetStats(&s_spsc);														// 6
+	TEST_EQUAL(_SpscWrite(1), 1);
+	SPSC_RingBuffer_GetStats(&s_spsc, &stats);
+	TEST_EQUAL(stats.high_watermark, 7);
+	TEST_EQUAL(stats.low_watermark, 6);
+	TEST_EQUAL(stats.bytes_in, 1);
+	TEST_EQUAL(stats.bytes_out, 0);
+	TEST_EQUAL(stats.overflows, 0);
+	TEST_EQUAL(stats.underflows, 0);
+}
@@ -0,0 +1,103 @@
+/**
+ ******************************************************************************
+ * @file test_sd_latency.c
+ * @brief Host test implementation file
+ *        WAV playback underruns against the SD card latency model
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the track buffer holds WAV_BUFFER_SIZE bytes, about 46 ms of a 16 bits
+ * stereo 44.1 kHz file: stalls shorter than that must not be heard, longer
+ * ones must be counted as underruns with the buffer size they needed.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "host_fat.h"
+#include "playback.h"
+#include "wav_file.h"
+#include "SDIO_Interface.h"
+
+#include <stdlib.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _SECONDS 			(2)
+#define _DURATION_MS 	(5000)
+#define _BUFFER_SIZE 	(8192)		// WAV_BUFFER_SIZE
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void Test_NoLatency(void);
+static void Test_ShortStall(void);
+static void Test_LongStall(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	const WavFile_Format format = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16};
+	uint32_t length = _SECONDS * WAV_OUTPUT_RATE * 4;
+	uint8_t* data = calloc(1, length);
+	uint8_t* wav = malloc(WavFile_Size(&format, length));
+	bool volume = data != NULL && wav != NULL && HostFat_Format(8 * 1024 * 1024, 8)
+							&& HostFat_AddFile("TEST.WAV", wav, WavFile_Build(wav, &format, data, length), false);
+
+	free(data);
+	free(wav);
+	if (!volume || SDIO_Interface_MountSD() != FR_OK) {
+		printf("cannot build the volume\n");
+		return 1;
+	}
+	WavDecoder_Init();
+
+	TEST_RUN(Test_NoLatency);
+	TEST_RUN(Test_ShortStall);
+	TEST_RUN(Test_LongStall);
+	HostFat_SetLatency(NULL);
+	HostFat_Release();
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void Test_NoLatency(void) {
+	WAV_Stats stats;
+
+	HostFat_SetLatency(NULL);
+	TEST_CHECK(Playback_Run("TEST.WAV", _DURATION_MS, &stats));
+	TEST_EQUAL(stats.underruns, 0);
+	TEST_EQUAL(stats.underrun_values, 0);
+	TEST_CHECK(stats.min_buffer_size <= _BUFFER_SIZE);
+}
+
+void Test_ShortStall(void) {
+	const HostFat_Latency latency = {.fixed_us = 300, .sector_us = 20, .stall_period = 50, .stall_us = 20000};
+	WAV_Stats reference, stats;
+
+	HostFat_SetLatency(NULL);
+	TEST_CHECK(Playback_Run("TEST.WAV", _DURATION_MS, &reference));
+	HostFat_SetLatency(&latency);
+	TEST_CHECK(Playback_Run("TEST.WAV", _DURATION_MS, &stats));
+	TEST_EQUAL(stats.underruns, 0);
+	TEST_CHECK(stats.min_fill < reference.min_fill);
+	TEST_CHECK(stats.min_buffer_size <= _BUFFER_SIZE);
+}
+
+void Test_LongStall(void) {
+	const HostFat_Latency latency = {.fixed_us = 300, .sector_us = 20, .stall_period = 50, .stall_us = 150000};
+	WAV_Stats stats;
+
+	HostFat_SetLatency(&latency);
+	TEST_CHECK(Playback_Run("TEST.WAV", _DURATION_MS, &stats));
+	TEST_CHECK(stats.underruns > 0);
+	TEST_CHECK(stats.underrun_values > 0);
+	TEST_CHECK(stats.min_buffer_size > _BUFFER_SIZE);
+}
@@ -0,0 +1,182 @@
+/**
+ ******************************************************************************
+ * @file test_shell.c
+ * @brief Host test implementation file
+ *        Shell line reception, on a simulated USART
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * bytes are received one RXNE interrupt each, the main loop (Shell_Run and
+ * the TXE interrupts sending the echo) runs between them or after a whole
+ * burst. Commands must keep running after a line longer than the Rx buffer.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "Shell.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _RX_SIZE (64)
+#define _TX_SIZE (256)
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Go(Shell* shell, int argc, char** argv);
+static void _Setup(uint32_t rx_size);
+static void _Receive(const char* data, uint32_t length, bool run_each);
+static void _Run(void);
+static void Test_Commands(void);
+static void Test_JunkByteByByte(void);
+static void Test_JunkBurst(void);
+static void Test_LongLineLargeBuffer(void);
+static void Test_InitSizes(void);
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const Shell_Command s_commands[] = {
+	{"go", _Go},
+};
+
+static Shell s_shell;
+static UART_HandleTypeDef s_huart;
+static uint8_t s_rx[SHELL_RX_STORAGE_SIZE(512)];
+static uint8_t s_tx[_TX_SIZE];
+static uint32_t s_nb_go;
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Commands);
+	TEST_RUN(Test_JunkByteByByte);
+	TEST_RUN(Test_JunkBurst);
+	TEST_RUN(Test_LongLineLargeBuffer);
+	TEST_RUN(Test_InitSizes);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Go(Shell* shell, int argc, char** argv) {
+	(void) shell;
+	(void) argc;
+	(void) argv;
+	s_nb_go++;
+}
+
+void _Setup(uint32_t rx_size) {
+	Host_Init();
+	memset(&s_huart, 0, sizeof(s_huart));
+	s_huart.Instance = USART2;
+	TEST_CHECK(Shell_Init(&s_shell, &s_huart, s_rx, rx_size, s_tx, _TX_SIZE, UART_MODE_IT));
+	TEST_CHECK(Shell_SetCommands(&s_shell, s_commands, sizeof(s_commands) / sizeof(s_commands[0])));
+	s_nb_go = 0;
+}
+
+/*
+ * One RXNE interrupt per byte, with the main loop after each one or not
+ */
+void _Receive(const char* data, uint32_t length, bool run_each) {
+	for (uint32_t cpt = 0; cpt < length; cpt++) {
+		USART2->DR = (uint8_t) data[cpt];
+		USART2->SR |= USART_SR_RXNE;
+		Host_RunIRQ((Host_Callback) UART_Interface_IRQHandler, USART2);
+		USART2->SR &= ~USART_SR_RXNE;
+		if (run_each) _Run();
+	}
+}
+
+/*
+ * Main loop pass, then the echo is sent by the TXE interrupts
+ */
+void _Run(void) {
+	Shell_Run(&s_shell);
+	while (SPSC_RingBuffer_IsNotEmpty(&s_shell.tx_buffer)) {
+		Host_RunIRQ((Host_Callback) UART_Interface_IRQHandler, USART2);
+	}
+}
+
+void Test_Commands(void) {
+	const char input[] = "go\r\n  go  \r\ngone\r\n\r\ngo\n";
+
+	_Setup(_RX_SIZE);
+	_Receive(input, sizeof(input) - 1, true);
+	TEST_EQUAL(s_nb_go, 3);
+}
+
+/*
+ * The junk fills the Rx buffer with no line end: it is dropped with the
+ * first "go" (the end of that line), the next four commands run
+ */
+void Test_JunkByteByByte(void) {
+	char junk[100];
+	UART_Stats stats;
+
+	_Setup(_RX_SIZE);
+	memset(junk, 'x', sizeof(junk));
+	_Receive(junk, sizeof(junk), true);
+	for (uint32_t cpt = 0; cpt < 5; cpt++) _Receive("go\r\n", 4, true);
+	UART_Interface_GetStats(&s_shell.port, &stats);
+	TEST_EQUAL(s_nb_go, 4);
+	TEST_EQUAL(stats.rx_overflows, 0);
+	TEST_CHECK(SPSC_RingBuffer_IsEmpty(&s_shell.rx_buffer));
+}
+
+/*
+ * The junk arrives while the main loop is busy: what does not fit is lost,
+ * the main loop then releases the buffer
+ */
+void Test_JunkBurst(void) {
+	char junk[100];
+	UART_Stats stats;
+
+	_Setup(_RX_SIZE);
+	memset(junk, 'x', sizeof(junk));
+	_Receive(junk, sizeof(junk), false);
+	_Run();
+	for (uint32_t cpt = 0; cpt < 5; cpt++) _Receive("go\r\n", 4, false), _Run();
+	UART_Interface_GetStats(&s_shell.port, &stats);
+	TEST_EQUAL(stats.rx_overflows, sizeof(junk) - _RX_SIZE);
+	TEST_EQUAL(s_nb_go, 4);
+}
+
+/*
+ * A buffer larger than a line: the line is dropped as soon as it is too
+ * long, not when the buffer is full
+ */
+void Test_LongLineLargeBuffer(void) {
+	char junk[300];
+
+	_Setup(512);
+	memset(junk, 'x', sizeof(junk));
+	_Receive(junk, sizeof(junk), true);
+	TEST_CHECK(SPSC_RingBuffer_GetSize(&s_shell.rx_buffer) <= SHELL_LINE_MAX_LENGTH);
+	_Receive("go\r\ngo\r\n", 8, true);
+	TEST_EQUAL(s_nb_go, 1);
+}
+
+/*
+ * A buffer size which is not a power of two fails before the UART starts
+ */
+void Test_InitSizes(void) {
+	Shell shell;
+
+	Host_Init();
+	USART1->CR1 = 0;
+	s_huart.Instance = USART1;
+	TEST_CHECK(!Shell_Init(&shell, &s_huart, s_rx, 100, s_tx, _TX_SIZE, UART_MODE_IT));
+	TEST_CHECK(!Shell_Init(&shell, &s_huart, s_rx, _RX_SIZE, s_tx, 0, UART_MODE_IT));
+	TEST_CHECK(UART_Interface_GetPort(USART1) == NULL);
+	TEST_EQUAL(USART1->CR1 & USART_CR1_RXNEIE, 0);
+}
@@ -0,0 +1,186 @@
+/**
+ ******************************************************************************
+ * @file test_spsc_stress.c
+ * @brief Host test implementation file
+ *        SPSC_RingBuffer with a producer and a consumer thread
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the producer writes a known byte sequence with every Put function, in
+ * random lengths, the consumer reads it back with every Get function and
+ * checks each byte. Small rings wrap all the time, the indexes start close
+ * to 2^32 to go through the counter wrap too.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "SPSC_RingBuffer.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _NB_BYTES 		(4 * 1024 * 1024)
+#define _MAX_STORAGE 	(4096)
+#define _SEQUENCE(n) 	((uint8_t)((n) * 131 + ((n) >> 8)))
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	SPSC_RingBuffer ring;
+	uint32_t size;
+	uint32_t seed;
+	uint32_t errors;		// consumer side
+	uint32_t first_error;
+} STRESS_Context;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static uint8_t s_storage[_MAX_STORAGE];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static uint32_t _Random(uint32_t* seed);
+static void* 	_Producer(void* context);
+static void* 	_Consumer(void* context);
+static void 	_Stress(uint32_t size, uint32_t start_index);
+static void 	Test_Stress64(void);
+static void 	Test_Stress4096(void);
+static void 	Test_StressIndexWrap(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Stress64);
+	TEST_RUN(Test_Stress4096);
+	TEST_RUN(Test_StressIndexWrap);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t _Random(uint32_t* seed) {
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+void* _Producer(void* context) {
+	STRESS_Context* stress = context;
+	uint32_t seed = stress->seed;
+	uint32_t sent = 0;
+	uint8_t data[_MAX_STORAGE];
+
+	while (sent < _NB_BYTES) {
+		uint32_t length = 1 + _Random(&seed) % stress->size;
+		uint8_t* span;
+
+		if (length > _NB_BYTES - sent) length = _NB_BYTES - sent;
+		switch (_Random(&seed) % 3) {
+		case 0:
+			if (SPSC_RingBuffer_Put(&stress->ring, _SEQUENCE(sent)) == RB_OK) sent++;
+			else sched_yield();
+			break;
+
+		case 1:
+			for (uint32_t cpt = 0; cpt < length; cpt++) data[cpt] = _SEQUENCE(sent + cpt);
+			if (SPSC_RingBuffer_PutSeveral(&stress->ring, data, length) == RB_OK) sent += length;
+			else sched_yield();
+			break;
+
+		default: {
+			uint32_t span_length = SPSC_RingBuffer_Reserve(&stress->ring, &span);
+			if (span_length > length) span_length = length;
+			if (span_length == 0) {
+				sched_yield();
+				break;
+			}
+			for (uint32_t cpt = 0; cpt < span_length; cpt++) span[cpt] = _SEQUENCE(sent + cpt);
+			SPSC_RingBuffer_Commit(&stress->ring, span_length);
+			sent += span_length;
+			break;
+		}
+		}
+	}
+	return NULL;
+}
+
+void* _Consumer(void* context) {
+	STRESS_Context* stress = context;
+	uint32_t seed = stress->seed ^ 0x5A5A5A5A;
+	uint32_t received = 0;
+	uint8_t data[_MAX_STORAGE];
+
+	while (received < _NB_BYTES) {
+		uint32_t length = 1 + _Random(&seed) % stress->size;
+		uint32_t nb_read = 0;
+		const uint8_t* span = data;
+
+		switch (_Random(&seed) % 3) {
+		case 0:
+			if (SPSC_RingBuffer_Get(&stress->ring, data) == RB_OK) nb_read = 1;
+			break;
+
+		case 1:
+			if (length > _NB_BYTES - received) length = _NB_BYTES - received;
+			if (SPSC_RingBuffer_GetSeveral(&stress->ring, data, length) == RB_OK) nb_read = length;
+			break;
+
+		default:
+			nb_read = SPSC_RingBuffer_Peek(&stress->ring, &span);
+			if (nb_read > length) nb_read = length;
+			break;
+		}
+		if (nb_read == 0) {
+			sched_yield();
+			continue;
+		}
+
+		for (uint32_t cpt = 0; cpt < nb_read; cpt++) {
+			if (span[cpt] != _SEQUENCE(received + cpt) && stress->errors++ == 0) stress->first_error = received + cpt;
+		}
+		if (span != data) SPSC_RingBuffer_Consume(&stress->ring, nb_read);		// released once checked
+		received += nb_read;
+	}
+	return NULL;
+}
+
+void _Stress(uint32_t size, uint32_t start_index) {
+	STRESS_Context stress = {.size = size, .seed = size + start_index};
+	pthread_t producer, consumer;
+
+	TEST_EQUAL(SPSC_RingBuffer_Init(&stress.ring, s_storage, size), RB_OK);
+	stress.ring.head = start_index;
+	stress.ring.tail = start_index;
+
+	TEST_EQUAL(pthread_create(&consumer, NULL, _Consumer, &stress), 0);
+	TEST_EQUAL(pthread_create(&producer, NULL, _Producer, &stress), 0);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+
+	if (stress.errors) printf("first error at byte %u\n", stress.first_error);
+	TEST_EQUAL(stress.errors, 0);
+	TEST_CHECK(SPSC_RingBuffer_IsEmpty(&stress.ring));
+}
+
+void Test_Stress64(void) {
+	_Stress(64, 0);
+}
+
+void Test_Stress4096(void) {
+	_Stress(4096, 0);
+}
+
+void Test_StressIndexWrap(void) {
+	_Stress(64, 0xFFFFFFFF - 2 * 1024 * 1024);		// wraps halfway
+}
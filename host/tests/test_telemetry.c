@@ -0,0 +1,250 @@
+/**
+ ******************************************************************************
+ * @file test_telemetry.c
+ * @brief Host test implementation file
+ *        Telemetry frames, decoder, line throughput and record rates
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * records are queued on a Tx DMA port and the transfers ended by
+ * Host_DmaComplete(), the bytes sent go through the host decoder. For the
+ * throughput the producer keeps the Tx buffer full and each transfer takes
+ * its line time (10 bits per byte): the records decoded per second of line
+ * must be the baud rate over 10 times the frame size.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "tlm_decoder.h"
+#include "host_fat.h"
+#include "playback.h"
+#include "wav_file.h"
+#include "SDIO_Interface.h"
+#include "Telemetry.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _TX_SIZE 		(4096)
+#define _FRAME_SIZE (18)		// two 32 bits values
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	uint32_t nb_records;
+	uint32_t next_value;		// first payload value expected
+	uint32_t gaps;
+	uint32_t wav_fill;			// TLM_WAV_FILL records
+	TlmDecoder_Record last;
+} TLM_Capture;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static UART_HandleTypeDef s_huart;
+static DMA_HandleTypeDef 	s_dma_tx;
+static UART_Port 					s_port;
+static SPSC_RingBuffer 		s_rx;
+static SPSC_RingBuffer 		s_tx;
+static uint8_t 						s_rx_buf[16];
+static uint8_t 						s_tx_buf[_TX_SIZE];
+static uint8_t 						s_sent[_TX_SIZE];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void 		_Setup(void);
+static void 		_OnRecord(const TlmDecoder_Record* record, void* context);
+static uint32_t _Drain(TlmDecoder* decoder);
+static void 		_DrainIRQ(void* context);
+static double 	_Throughput(uint32_t baud);
+static void 		Test_Records(void);
+static void 		Test_Corruption(void);
+static void 		Test_Throughput(void);
+static void 		Test_WavFillRate(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Records);
+	TEST_RUN(Test_Corruption);
+	TEST_RUN(Test_Throughput);
+	TEST_RUN(Test_WavFillRate);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Setup(void) {
+	Host_Init();
+	Host_InitDma(&s_dma_tx);
+	memset(&s_huart, 0, sizeof(s_huart));
+	s_huart.Instance = USART3;
+	__HAL_LINKDMA(&s_huart, hdmatx, s_dma_tx);
+	SPSC_RingBuffer_Init(&s_rx, s_rx_buf, sizeof(s_rx_buf));
+	SPSC_RingBuffer_Init(&s_tx, s_tx_buf, _TX_SIZE);
+	TEST_CHECK(UART_Interface_Init(&s_port, &s_huart, &s_rx, &s_tx, UART_MODE_TX_DMA));
+	Telemetry_Init(&s_port);
+}
+
+void _OnRecord(const TlmDecoder_Record* record, void* context) {
+	TLM_Capture* capture = context;
+	uint32_t value;
+
+	if (record->type == TLM_WAV_FILL) capture->wav_fill++;
+	if (record->type == TLM_USER && record->length >= sizeof(value)) {
+		memcpy(&value, record->payload, sizeof(value));
+		capture->gaps += value != capture->next_value;
+		capture->next_value = value + 1;
+	}
+	capture->nb_records++;
+	capture->last = *record;
+}
+
+/*
+ * Ends the running transfer, which starts the next one, and decodes it.
+ * Returns the bytes sent
+ */
+uint32_t _Drain(TlmDecoder* decoder) {
+	uint32_t length = Host_DmaComplete(&s_dma_tx, s_sent, sizeof(s_sent));
+
+	TlmDecoder_Push(decoder, s_sent, length);
+	return length;
+}
+
+/*
+ * Periodic interrupt of the simulated clock
+ */
+void _DrainIRQ(void* context) {
+	_Drain(context);
+}
+
+/*
+ * Records per second of line at baud, with the Tx buffer kept full
+ */
+double _Throughput(uint32_t baud) {
+	TLM_Capture capture = {0};
+	TlmDecoder decoder;
+	uint64_t line_ns = 0;
+	uint32_t value = 0;
+	Telemetry_Stats stats;
+
+	_Setup();
+	TlmDecoder_Init(&decoder, _OnRecord, &capture);
+	while (line_ns < 1000000000ULL) {
+		uint32_t payload[2] = {value, 0};
+
+		while (Telemetry_Send(TLM_USER, 1, payload, sizeof(payload))) payload[0] = ++value;
+		line_ns += (uint64_t) _Drain(&decoder) * 10 * 1000000000ULL / baud;
+	}
+	Telemetry_GetStats(&stats);
+	TEST_EQUAL(decoder.errors, 0);
+	TEST_EQUAL(capture.gaps, 0);
+	TEST_CHECK(stats.dropped > 0);		// the producer was faster than the line
+	return capture.nb_records * 1e9 / line_ns;
+}
+
+/*
+ * Payloads of every length, with zeros and 0xFF, and timestamps
+ */
+void Test_Records(void) {
+	TLM_Capture capture = {0};
+	TlmDecoder decoder;
+	uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+
+	_Setup();
+	TlmDecoder_Init(&decoder, _OnRecord, &capture);
+	for (uint32_t length = 0; length <= TELEMETRY_MAX_PAYLOAD; length++) {
+		for (uint32_t cpt = 0; cpt < length; cpt++) payload[cpt] = (cpt % 3 == 0) ? 0 : (uint8_t)(0xFF - cpt * length);
+		HAL_Delay(length * 1000);
+		TEST_CHECK(Telemetry_Send(0x90 + length, length & 3, payload, length));
+		_Drain(&decoder);
+		TEST_EQUAL(capture.nb_records, length + 1);
+		TEST_EQUAL(capture.last.type, 0x90 + length);
+		TEST_EQUAL(capture.last.source, length & 3);
+		TEST_EQUAL(capture.last.timestamp, HAL_GetTick());
+		TEST_EQUAL(capture.last.length, length);
+		TEST_CHECK(memcmp(capture.last.payload, payload, length) == 0);
+	}
+	TEST_CHECK(!Telemetry_Send(TLM_USER, 0, payload, TELEMETRY_MAX_PAYLOAD + 1));
+	TEST_EQUAL(decoder.errors, 0);
+}
+
+/*
+ * A damaged frame is rejected, the next one decodes
+ */
+void Test_Corruption(void) {
+	TLM_Capture capture = {0};
+	TlmDecoder decoder;
+	uint32_t payload[2] = {0x12345678, 0};
+	uint32_t length;
+
+	_Setup();
+	TlmDecoder_Init(&decoder, _OnRecord, &capture);
+	Telemetry_Send(TLM_USER, 0, payload, sizeof(payload));
+	length = Host_DmaComplete(&s_dma_tx, s_sent, sizeof(s_sent));
+	TEST_EQUAL(length, _FRAME_SIZE);
+	s_sent[5] ^= 0x10;
+	TlmDecoder_Push(&decoder, s_sent, length);
+	TEST_EQUAL(decoder.errors, 1);
+	TEST_EQUAL(capture.nb_records, 0);
+
+	TlmDecoder_Push(&decoder, s_sent + 9, length - 9);		// capture started in a frame
+	TEST_EQUAL(decoder.errors, 2);
+
+	Telemetry_Send(TLM_USER, 0, payload, sizeof(payload));
+	_Drain(&decoder);
+	TEST_EQUAL(capture.nb_records, 1);
+}
+
+void Test_Throughput(void) {
+	static const uint32_t s_bauds[] = {115200, 921600, 2000000};
+
+	for (uint32_t cpt = 0; cpt < sizeof(s_bauds) / sizeof(s_bauds[0]); cpt++) {
+		double expected = s_bauds[cpt] / (10.0 * _FRAME_SIZE);
+		double rate = _Throughput(s_bauds[cpt]);
+
+		printf("  %7u bauds: %6.0f records/s (%.0f expected)\n", s_bauds[cpt], rate, expected);
+		TEST_CHECK(rate > 0.99 * expected && rate < 1.01 * expected);
+	}
+}
+
+/*
+ * The decoder sends one TLM_WAV_FILL record per period, not per render
+ */
+void Test_WavFillRate(void) {
+	const WavFile_Format format = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16};
+	uint32_t length = WAV_OUTPUT_RATE * 4;		// 1 s
+	uint8_t* data = calloc(1, length);
+	uint8_t* wav = malloc(WavFile_Size(&format, length));
+	TLM_Capture capture = {0};
+	TlmDecoder decoder;
+	WAV_Stats stats;
+
+	_Setup();
+	TEST_CHECK(data != NULL && wav != NULL && HostFat_Format(4 * 1024 * 1024, 8));
+	TEST_CHECK(HostFat_AddFile("TEST.WAV", wav, WavFile_Build(wav, &format, data, length), false));
+	TEST_EQUAL(SDIO_Interface_MountSD(), FR_OK);
+	free(data);
+	free(wav);
+
+	WavDecoder_Init();
+	TlmDecoder_Init(&decoder, _OnRecord, &capture);
+	Host_SetTimer(1000, _DrainIRQ, &decoder);		// line drained every ms
+	TEST_CHECK(Playback_Run("TEST.WAV", 2000, &stats));
+	_Drain(&decoder);
+	printf("  %u TLM_WAV_FILL records in 2 s\n", capture.wav_fill);
+	TEST_CHECK(capture.wav_fill >= 35 && capture.wav_fill <= 41);		// 50 ms period
+	TEST_EQUAL(decoder.errors, 0);
+	HostFat_Release();
+}
@@ -0,0 +1,205 @@
+/**
+ ******************************************************************************
+ * @file test_trace.c
+ * @brief Host test implementation file
+ *        Trace summary of nested sources, on a controlled clock
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the test defines clock_gettime, the host timestamp of Trace.c, so every
+ * event is recorded at a known time. The summary is read back from the
+ * shell Tx buffer before the TXE interrupt sends it.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "Trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _RX_SIZE (64)
+#define _TX_SIZE (1024)
+
+#define _NS_PER_US (1000)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static Shell s_shell;
+static UART_HandleTypeDef s_huart;
+static uint8_t s_rx[SHELL_RX_STORAGE_SIZE(_RX_SIZE)];
+static uint8_t s_tx[_TX_SIZE];
+static char s_output[_TX_SIZE + 1];
+static uint64_t s_now_ns;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Setup(uint64_t now_ns);
+static void _Record(TRACE_SOURCE source, uint16_t exit, uint64_t at_ns);
+static const char* _Summary(void);
+static void _CheckLine(const char* output, const char* name, uint32_t calls, uint32_t permille, uint32_t max_us);
+static void Test_Nested(void);
+static void Test_ClockWrap(void);
+static void Test_WrappedBuffer(void);
+static void Test_Clear(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Nested);
+	TEST_RUN(Test_ClockWrap);
+	TEST_RUN(Test_WrappedBuffer);
+	TEST_RUN(Test_Clear);
+	return TEST_RESULT();
+}
+
+/*
+ * Replaces the libc clock for Trace.c
+ */
+int clock_gettime(clockid_t clock, struct timespec* now) {
+	(void) clock;
+	now->tv_sec = (time_t)(s_now_ns / 1000000000ULL);
+	now->tv_nsec = (long)(s_now_ns % 1000000000ULL);
+	return 0;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Setup(uint64_t now_ns) {
+	Host_Init();
+	memset(&s_huart, 0, sizeof(s_huart));
+	s_huart.Instance = USART2;
+	TEST_CHECK(Shell_Init(&s_shell, &s_huart, s_rx, _RX_SIZE, s_tx, _TX_SIZE, UART_MODE_IT));
+	s_now_ns = now_ns;
+	Trace_Init();
+}
+
+void _Record(TRACE_SOURCE source, uint16_t exit, uint64_t at_ns) {
+	s_now_ns = at_ns;
+	Trace_Record(source, exit);
+}
+
+/*
+ * Runs "trace" and returns what it printed
+ */
+const char* _Summary(void) {
+	char name[] = "trace";
+	char* argv[] = {name};
+	uint32_t length;
+
+	Trace_Command(&s_shell, 1, argv);
+	length = SPSC_RingBuffer_GetSize(&s_shell.tx_buffer);
+	TEST_CHECK(SPSC_RingBuffer_GetSeveral(&s_shell.tx_buffer, (uint8_t*) s_output, length) == RB_OK);
+	s_output[length] = '\0';
+	return s_output;
+}
+
+/*
+ * Same format as the summary line of a source
+ */
+void _CheckLine(const char* output, const char* name, uint32_t calls, uint32_t permille, uint32_t max_us) {
+	char line[64];
+
+	snprintf(line, sizeof(line), "%-8s %6u %3u.%u%% %6u\r\n", name, calls, permille / 10, permille % 10, max_us);
+	TEST_CHECK(strstr(output, line) != NULL);
+	if (strstr(output, line) == NULL) printf("expected: %s%s", line, output);
+}
+
+/*
+ * feed runs 10 us and is preempted 2 us by dac, then dac 5 us and feed 4 us
+ * alone: own times feed 8 + 4 us, dac 2 + 5 us over a 44 us window
+ */
+void Test_Nested(void) {
+	const char* output;
+
+	_Setup(1000000000ULL);
+	const uint64_t origin = s_now_ns;
+	_Record(TRACE_FEED, 0, origin);
+	_Record(TRACE_DAC, 0, origin + 1 * _NS_PER_US);
+	_Record(TRACE_DAC, 1, origin + 3 * _NS_PER_US);
+	_Record(TRACE_FEED, 1, origin + 10 * _NS_PER_US);
+	_Record(TRACE_DAC, 0, origin + 20 * _NS_PER_US);
+	_Record(TRACE_DAC, 1, origin + 25 * _NS_PER_US);
+	_Record(TRACE_FEED, 0, origin + 40 * _NS_PER_US);
+	_Record(TRACE_FEED, 1, origin + 44 * _NS_PER_US);
+
+	output = _Summary();
+	TEST_CHECK(strstr(output, "8 events over 44 us\r\n") != NULL);
+	_CheckLine(output, "feed", 2, 12 * 1000 / 44, 8);
+	_CheckLine(output, "dac", 2, 7 * 1000 / 44, 5);
+	_CheckLine(output, "uart", 0, 0, 0);
+	_CheckLine(output, "coder", 0, 0, 0);
+}
+
+/*
+ * The 32 bits nanosecond timestamp wraps every 4.3 s, in the middle of
+ * a nested call here
+ */
+void Test_ClockWrap(void) {
+	const char* output;
+
+	_Setup((1ULL << 32) - 2 * _NS_PER_US);
+	const uint64_t origin = s_now_ns;
+	_Record(TRACE_CODER, 0, origin);
+	_Record(TRACE_UART, 0, origin + 1 * _NS_PER_US);
+	_Record(TRACE_UART, 1, origin + 4 * _NS_PER_US);
+	_Record(TRACE_CODER, 1, origin + 10 * _NS_PER_US);
+
+	output = _Summary();
+	TEST_CHECK(strstr(output, "4 events over 10 us\r\n") != NULL);
+	_CheckLine(output, "coder", 1, 700, 7);
+	_CheckLine(output, "uart", 1, 300, 3);
+}
+
+/*
+ * 260 uart calls of 2 us every 4 us then an enter without its exit:
+ * the last TRACE_BUFFER_LENGTH events start on the exit of call 4,
+ * calls 5 to 259 are complete in the window
+ */
+void Test_WrappedBuffer(void) {
+	const uint32_t nb_calls = 260;
+	const uint32_t period_us = 4;
+	const uint32_t duration_us = 2;
+	const char* output;
+	char header[48];
+
+	_Setup(0);
+	for (uint32_t cpt = 0; cpt < nb_calls; cpt++) {
+		uint64_t start = (uint64_t) cpt * period_us * _NS_PER_US;
+		_Record(TRACE_UART, 0, start);
+		_Record(TRACE_UART, 1, start + duration_us * _NS_PER_US);
+	}
+	_Record(TRACE_UART, 0, (uint64_t) nb_calls * period_us * _NS_PER_US);
+	TEST_CHECK(2 * nb_calls + 1 - TRACE_BUFFER_LENGTH == 9);
+
+	const uint32_t window_us = nb_calls * period_us - (4 * period_us + duration_us);
+	const uint32_t nb_complete = nb_calls - 5;
+	output = _Summary();
+	snprintf(header, sizeof(header), "%u events over %u us\r\n", TRACE_BUFFER_LENGTH, window_us);
+	TEST_CHECK(strstr(output, header) != NULL);
+	_CheckLine(output, "uart", nb_complete, nb_complete * duration_us * 1000 / window_us, duration_us);
+}
+
+void Test_Clear(void) {
+	char name[] = "trace";
+	char clear[] = "clear";
+	char* argv[] = {name, clear};
+
+	_Setup(0);
+	_Record(TRACE_DAC, 0, 1000);
+	_Record(TRACE_DAC, 1, 2000);
+	Trace_Command(&s_shell, 2, argv);
+	TEST_CHECK(strcmp(_Summary(), "No trace\r\n") == 0);
+}
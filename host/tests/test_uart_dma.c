@@ -0,0 +1,197 @@
+/**
+ ******************************************************************************
+ * @file test_uart_dma.c
+ * @brief Host test implementation file
+ *        UART interface in DMA modes, on simulated DMA streams
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the Rx stream is played by Host_DmaReceive(), which calls the half and
+ * complete callbacks as the DMA interrupt would; the idle line is raised in
+ * SR and handled by the USART interrupt. Every byte must be published once,
+ * whichever event comes first. The Tx stream is ended by Host_DmaComplete(),
+ * and a transfer refused by HAL_DMA_Start_IT() must leave nothing in flight.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "UART_Interface.h"
+
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _RX_SIZE (64)
+#define _TX_SIZE (64)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static UART_HandleTypeDef s_huart;
+static DMA_HandleTypeDef 	s_dma_rx;
+static DMA_HandleTypeDef 	s_dma_tx;
+static UART_Port 					s_port;
+static SPSC_RingBuffer 		s_rx;
+static SPSC_RingBuffer 		s_tx;
+static uint8_t 						s_rx_buf[_RX_SIZE];
+static uint8_t 						s_tx_buf[_TX_SIZE];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static bool _Setup(void);
+static void _IdleLine(void);
+static void Test_RxEvents(void);
+static void Test_RxOverflow(void);
+static void Test_TxDma(void);
+static void Test_TxStartError(void);
+static void Test_RxStartError(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_RxEvents);
+	TEST_RUN(Test_RxOverflow);
+	TEST_RUN(Test_TxDma);
+	TEST_RUN(Test_TxStartError);
+	TEST_RUN(Test_RxStartError);
+	return TEST_RESULT();
+}
+
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart) {
+	UART_Interface_RxEvent(huart);
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+	UART_Interface_RxEvent(huart);
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool _Setup(void) {
+	Host_Init();
+	Host_InitDma(&s_dma_rx);
+	Host_InitDma(&s_dma_tx);
+	memset(&s_huart, 0, sizeof(s_huart));
+	s_huart.Instance = USART1;
+	__HAL_LINKDMA(&s_huart, hdmarx, s_dma_rx);
+	__HAL_LINKDMA(&s_huart, hdmatx, s_dma_tx);
+	SPSC_RingBuffer_Init(&s_rx, s_rx_buf, _RX_SIZE);
+	SPSC_RingBuffer_Init(&s_tx, s_tx_buf, _TX_SIZE);
+	return UART_Interface_Init(&s_port, &s_huart, &s_rx, &s_tx, UART_MODE_DMA);
+}
+
+/*
+ * End of a burst, as seen by the USART interrupt
+ */
+void _IdleLine(void) {
+	USART1->SR |= USART_SR_IDLE;
+	Host_RunIRQ((Host_Callback) UART_Interface_IRQHandler, USART1);
+	USART1->SR &= ~USART_SR_IDLE;
+}
+
+/*
+ * Bursts ended by the idle line, by the half and complete DMA events, and
+ * both (complete right after an idle line) over several buffer wraps
+ */
+void Test_RxEvents(void) {
+	uint8_t expected[_RX_SIZE], received[_RX_SIZE];
+	uint32_t lines = 0;
+	uint8_t value = 0;
+
+	TEST_CHECK(_Setup());
+	for (uint32_t burst = 1; burst < 40; burst++) {
+		uint32_t length = (burst * 7) % (_RX_SIZE - 1) + 1;
+
+		for (uint32_t cpt = 0; cpt < length; cpt++, value++) {
+			expected[cpt] = (value % 10 == 9) ? '\n' : 'a' + value % 26;
+			lines += expected[cpt] == '\n';
+		}
+		TEST_EQUAL(Host_DmaReceive(&s_dma_rx, expected, length), length);
+		_IdleLine();
+		TEST_EQUAL(SPSC_RingBuffer_GetSize(&s_rx), length);
+		TEST_EQUAL(UART_Interface_GetLineCount(&s_port), lines);
+		TEST_EQUAL(SPSC_RingBuffer_GetSeveral(&s_rx, received, length), RB_OK);
+		TEST_CHECK(memcmp(received, expected, length) == 0);
+	}
+	UART_Interface_RxEvent(&s_huart);		// nothing new: a late DMA event publishes nothing
+	TEST_EQUAL(SPSC_RingBuffer_GetSize(&s_rx), 0);
+	TEST_EQUAL(UART_Interface_GetLineCount(&s_port), lines);
+	TEST_EQUAL(s_port.stats.rx_overflows, 0);
+}
+
+/*
+ * The DMA loops over unread bytes: the event keeps what fits and counts it
+ */
+void Test_RxOverflow(void) {
+	uint8_t data[_RX_SIZE + 16];
+
+	TEST_CHECK(_Setup());
+	memset(data, 'x', sizeof(data));
+	Host_DmaReceive(&s_dma_rx, data, _RX_SIZE - 8);		// published by the half event
+	Host_DmaReceive(&s_dma_rx, data, 24);								// wraps over 16 unread bytes
+	_IdleLine();
+	TEST_CHECK(s_port.stats.rx_overflows > 0);
+	TEST_CHECK(SPSC_RingBuffer_GetSize(&s_rx) <= _RX_SIZE);
+}
+
+/*
+ * A wrapped Tx buffer goes out in two transfers, in order
+ */
+void Test_TxDma(void) {
+	uint8_t sent[_TX_SIZE], data[_TX_SIZE - 1];
+
+	TEST_CHECK(_Setup());
+	for (uint32_t cpt = 0; cpt < sizeof(data); cpt++) data[cpt] = (uint8_t) cpt;
+	SPSC_RingBuffer_PutSeveral(&s_tx, data, 40);
+	UART_Interface_EnableIT(&s_port);
+	TEST_EQUAL(s_port.tx_dma_length, 40);
+	TEST_EQUAL(Host_DmaComplete(&s_dma_tx, sent, sizeof(sent)), 40);
+	TEST_CHECK(memcmp(sent, data, 40) == 0);
+	TEST_EQUAL(s_port.tx_dma_length, 0);
+
+	SPSC_RingBuffer_PutSeveral(&s_tx, data, 50);		// 24 before the wrap, 26 after
+	UART_Interface_EnableIT(&s_port);
+	TEST_EQUAL(Host_DmaComplete(&s_dma_tx, sent, sizeof(sent)), 24);
+	TEST_EQUAL(Host_DmaComplete(&s_dma_tx, sent + 24, sizeof(sent) - 24), 26);
+	TEST_CHECK(memcmp(sent, data, 50) == 0);
+	TEST_CHECK(SPSC_RingBuffer_IsEmpty(&s_tx));
+	TEST_EQUAL(s_port.stats.tx_dma_errors, 0);
+}
+
+/*
+ * A refused transfer is counted, leaves the bytes queued and nothing in
+ * flight, so that the next enable starts it
+ */
+void Test_TxStartError(void) {
+	const uint8_t data[] = "status\r\n";
+	uint8_t sent[sizeof(data)];
+
+	TEST_CHECK(_Setup());
+	SPSC_RingBuffer_PutSeveral(&s_tx, data, sizeof(data));
+	Host_SetDmaStartResult(HAL_ERROR);
+	UART_Interface_EnableIT(&s_port);
+	TEST_EQUAL(s_port.tx_dma_length, 0);
+	TEST_EQUAL(s_port.stats.tx_dma_errors, 1);
+	TEST_EQUAL(SPSC_RingBuffer_GetSize(&s_tx), sizeof(data));
+	TEST_EQUAL(UART_Interface_DropTx(&s_port, 2), 2);		// nothing in flight to keep
+
+	Host_SetDmaStartResult(HAL_OK);
+	UART_Interface_EnableIT(&s_port);
+	TEST_EQUAL(s_port.tx_dma_length, sizeof(data) - 2);
+	TEST_EQUAL(Host_DmaComplete(&s_dma_tx, sent, sizeof(sent)), sizeof(data) - 2);
+	TEST_CHECK(memcmp(sent, data + 2, sizeof(data) - 2) == 0);
+}
+
+void Test_RxStartError(void) {
+	TEST_CHECK(_Setup());
+	TEST_CHECK(!UART_Interface_Init(&s_port, &s_huart, &s_rx, &s_tx, UART_MODE_DMA));		// Rx stream already running
+	TEST_CHECK(UART_Interface_GetPort(USART1) == NULL);
+}
@@ -0,0 +1,217 @@
+/**
+ ******************************************************************************
+ * @file test_wav_converter.c
+ * @brief Host test implementation file
+ *        WAV converter kernels against a plain scalar reference
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the reference decodes one sample at a time from the byte layout of the
+ * format: 16 bits offset binary value, mean of both channels, shift to the
+ * DAC. Random frames start with full scale ones (-32768, 0x7FFFFF, +-1.0f,
+ * out of range floats, NaN), every kernel runs on odd frame counts at every
+ * source alignment and must not write past the last frame.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "WAV_Converter.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _MAX_FRAMES (67)
+#define _FRAME_MAX 	(8)			// bytes, 32 bits stereo
+#define _GUARD 			(0xA5A5)
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	const char* name;
+	uint16_t audio_format;
+	uint16_t nb_channels;
+	uint16_t bits_per_sample;
+} TEST_Format;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const TEST_Format s_formats[] = {
+	{"U8Mono",    WAV_FORMAT_PCM, 1, 8},
+	{"U8Stereo",  WAV_FORMAT_PCM, 2, 8},
+	{"S16Mono",   WAV_FORMAT_PCM, 1, 16},
+	{"S16Stereo", WAV_FORMAT_PCM, 2, 16},
+	{"S24Mono",   WAV_FORMAT_PCM, 1, 24},
+	{"S24Stereo", WAV_FORMAT_PCM, 2, 24},
+	{"F32Mono",   WAV_FORMAT_IEEE_FLOAT, 1, 32},
+	{"F32Stereo", WAV_FORMAT_IEEE_FLOAT, 2, 32},
+};
+
+static const uint32_t s_counts[] = {1, 2, 3, 5, 7, 13, 64, _MAX_FRAMES};
+
+static uint8_t s_src[_MAX_FRAMES * _FRAME_MAX + 4];
+static uint16_t s_dst[_MAX_FRAMES + 1];
+static uint32_t s_seed = 5;
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static uint32_t _Random(void);
+static void 		_FillSamples(uint8_t* src, const TEST_Format* format, uint32_t nb_samples);
+static int32_t 	_Sample16(const uint8_t* sample, const TEST_Format* format);
+static uint16_t _Reference(const uint8_t* frame, const TEST_Format* format);
+static bool 		_Check(const TEST_Format* format, uint32_t nb_frames, uint32_t offset);
+static void 		Test_Kernels(void);
+static void 		Test_FullScale(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	TEST_RUN(Test_Kernels);
+	TEST_RUN(Test_FullScale);
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+uint32_t _Random(void) {
+	s_seed = s_seed * 1103515245 + 12345;
+	return s_seed >> 8;
+}
+
+/*
+ * Full scale and edge values first, random ones after
+ */
+void _FillSamples(uint8_t* src, const TEST_Format* format, uint32_t nb_samples) {
+	static const uint32_t pcm_edges[] = {0x800000, 0x7FFFFF, 0x000000, 0xFFFFFF, 0x7FFF00, 0x8000FF};
+	static const float float_edges[] = {-1.0f, 1.0f, 0.0f, 1.01f, -1.01f, 1e10f, -1e10f, INFINITY, -INFINITY, NAN, 0.99999f, -0.99999f};
+	uint32_t size = format->bits_per_sample / 8;
+
+	for (uint32_t cpt = 0; cpt < nb_samples; cpt++, src += size) {
+		if (format->audio_format == WAV_FORMAT_IEEE_FLOAT) {
+			float value = (cpt < sizeof(float_edges) / sizeof(float_edges[0])) ? float_edges[cpt]
+							: (float)(int32_t)(_Random() - 0x800000) / 0x700000;		// -1.14 to 1.14
+			memcpy(src, &value, sizeof(value));
+		}
+		else {
+			uint32_t value = (cpt < sizeof(pcm_edges) / sizeof(pcm_edges[0])) ? pcm_edges[cpt] : _Random();
+			value >>= 24 - format->bits_per_sample;		// the most significant bytes of the edges
+			memcpy(src, &value, size);
+		}
+	}
+}
+
+/*
+ * Signed 16 bits value of one sample, the float ones clamped as the DAC does
+ */
+int32_t _Sample16(const uint8_t* sample, const TEST_Format* format) {
+	switch (format->bits_per_sample) {
+	case 8:
+		return (sample[0] - 128) * 256;
+	case 16:
+		return (int16_t)(sample[0] | (sample[1] << 8));
+	case 24:
+		return (int16_t)(sample[1] | (sample[2] << 8));		// 8 LSB dropped
+	}
+	return 0;
+}
+
+uint16_t _Reference(const uint8_t* frame, const TEST_Format* format) {
+	int32_t value;
+
+	if (format->audio_format == WAV_FORMAT_IEEE_FLOAT) {
+		float samples[2];
+		memcpy(samples, frame, format->nb_channels * sizeof(float));
+		float sample = (format->nb_channels == 1) ? samples[0] : (samples[0] + samples[1]) * 0.5f;
+
+		if (isnan(sample)) sample = 0;
+		if (sample > 1) sample = 1;
+		if (sample < -1) sample = -1;
+		value = (int32_t)(sample * 32767.0f);
+	}
+	else if (format->nb_channels == 1) {
+		value = _Sample16(frame, format);
+	}
+	else {
+		int32_t sum = _Sample16(frame, format) + _Sample16(frame + format->bits_per_sample / 8, format);
+		value = (sum >= 0) ? sum / 2 : -((-sum + 1) / 2);		// floor
+	}
+	return (uint16_t)(value + 32768) >> WAV_DAC_SHIFT;
+}
+
+/*
+ * Kernel output against the reference, frames at src + offset
+ */
+bool _Check(const TEST_Format* format, uint32_t nb_frames, uint32_t offset) {
+	WAV_Converter converter = WavConverter_Select(format->audio_format, format->nb_channels, format->bits_per_sample);
+	uint32_t frame_size = format->nb_channels * format->bits_per_sample / 8;
+	uint8_t* src = s_src + offset;
+	bool ok = true;
+
+	_FillSamples(src, format, nb_frames * format->nb_channels);
+	for (uint32_t cpt = 0; cpt <= nb_frames; cpt++) s_dst[cpt] = _GUARD;
+	converter(src, s_dst, nb_frames);
+
+	for (uint32_t cpt = 0; cpt < nb_frames; cpt++) {
+		uint16_t expected = _Reference(src + cpt * frame_size, format);
+		if (s_dst[cpt] != expected) {
+			printf("  %s %u frames at +%u: frame %u is %u, expected %u\n", format->name, nb_frames, offset, cpt, s_dst[cpt], expected);
+			ok = false;
+			break;
+		}
+	}
+	return ok && s_dst[nb_frames] == _GUARD;
+}
+
+void Test_Kernels(void) {
+	for (uint32_t format = 0; format < sizeof(s_formats) / sizeof(s_formats[0]); format++) {
+		TEST_CHECK(WavConverter_Select(s_formats[format].audio_format, s_formats[format].nb_channels, s_formats[format].bits_per_sample) != NULL);
+		for (uint32_t count = 0; count < sizeof(s_counts) / sizeof(s_counts[0]); count++) {
+			for (uint32_t offset = 0; offset < 4; offset++) {
+				TEST_CHECK(_Check(&s_formats[format], s_counts[count], offset));
+			}
+		}
+	}
+}
+
+/*
+ * Full scale values reach both ends of the DAC, never the other one
+ */
+void Test_FullScale(void) {
+	static const float floats[] = {1.0f, 1.01f, 1e10f, INFINITY, -1.0f, -1.01f, -1e10f, -INFINITY, NAN};
+	static const uint8_t s16[] = {0xFF, 0x7F, 0x00, 0x80};
+	static const uint8_t s24[] = {0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x80};
+	uint16_t dac_max = 0xFFFF >> WAV_DAC_SHIFT;
+	uint16_t out[9];
+
+	WavConverter_F32Mono((const uint8_t*) floats, out, 9);
+	for (uint32_t cpt = 0; cpt < 4; cpt++) TEST_EQUAL(out[cpt], dac_max);
+	for (uint32_t cpt = 4; cpt < 8; cpt++) TEST_EQUAL(out[cpt], 0);
+	TEST_EQUAL(out[8], WAV_DAC_SILENCE);
+
+	WavConverter_F32Stereo((const uint8_t*) floats, out, 4);		// {1, 1.01} {1e10, inf} {-1, -1.01} {-1e10, -inf}
+	TEST_EQUAL(out[0], dac_max);
+	TEST_EQUAL(out[1], dac_max);
+	TEST_EQUAL(out[2], 0);
+	TEST_EQUAL(out[3], 0);
+
+	WavConverter_S16Mono(s16, out, 2);
+	TEST_EQUAL(out[0], dac_max);
+	TEST_EQUAL(out[1], 0);
+	WavConverter_S16Stereo(s16, out, 1);
+	TEST_EQUAL(out[0], WAV_DAC_SILENCE - 1);		// (32767 - 32768) / 2 rounds down
+	WavConverter_S24Mono(s24, out, 2);
+	TEST_EQUAL(out[0], dac_max);
+	TEST_EQUAL(out[1], 0);
+}
@@ -0,0 +1,287 @@
+/**
+ ******************************************************************************
+ * @file test_wav_decoder.c
+ * @brief Host test implementation file
+ *        WAV decoder output, from files of a FAT image in memory
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note
+ * the output is driven as by the DAC DMA: a half buffer is rendered by each
+ * half / complete callback, and the main loop feeds the track buffers after
+ * each one. Files at WAV_OUTPUT_RATE must come out as their frames converted
+ * one by one, whatever the frame size and the buffer wraps.
+ *
+ * @note headers
+ * the chunk walker must skip metadata larger than the buffer and odd sized
+ * chunks with their pad byte, read EXTENSIBLE fmt chunks, and end with an
+ * error on too many chunks, a truncated chunk or a file which is not
+ * RIFF/WAVE. A data chunk cut by the end of the file plays what is there.
+ ******************************************************************************
+ */
+#include "test.h"
+#include "host_fat.h"
+#include "wav_file.h"
+#include "SDIO_Interface.h"
+#include "WAV_Converter.h"
+#include "WAV_Decoder.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define _HALF 				(256)			// DAC values per half transfer
+#define _NB_FRAMES 		(20000)
+#define _MAX_VALUES 	(3 * _NB_FRAMES)
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const WavFile_Format s_s16 = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16};
+static const WavFile_Format s_s24 = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 24};
+static const WavFile_Format s_align3 = {.audio_format = 1, .nb_channels = 1, .sample_rate = 22050, .bits_per_sample = 16, .byte_per_block = 3};
+static const WavFile_Format s_align8 = {.audio_format = 1, .nb_channels = 2, .sample_rate = 22050, .bits_per_sample = 16, .byte_per_block = 8};
+static const WavFile_Format s_big_list = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16, .list_size = 3 * 8192 + 100};
+static const WavFile_Format s_odd_list = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16, .list_size = 4095};
+static const WavFile_Format s_ext_pcm = {.audio_format = 1, .nb_channels = 2, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16, .extensible = true};
+static const WavFile_Format s_ext_f32 = {.audio_format = 3, .nb_channels = 1, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 32, .extensible = true};
+static const WavFile_Format s_chunks14 = {.audio_format = 1, .nb_channels = 1, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16, .list_size = 10, .nb_lists = 14};
+static const WavFile_Format s_chunks15 = {.audio_format = 1, .nb_channels = 1, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16, .list_size = 10, .nb_lists = 15};
+static const WavFile_Format s_list1000 = {.audio_format = 1, .nb_channels = 1, .sample_rate = WAV_OUTPUT_RATE, .bits_per_sample = 16, .list_size = 1000};
+
+static uint8_t  s_data[_NB_FRAMES * 8];
+static uint16_t s_expected[_MAX_VALUES];
+static uint16_t s_output[_MAX_VALUES + 2 * _HALF];
+static uint16_t s_dac_buf[2 * _HALF];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static bool 		_AddFile(const char* name, const WavFile_Format* format, uint32_t nb_frames);
+static bool 		_AddCut(const char* name, const WavFile_Format* format, uint32_t nb_frames, uint32_t length, const char* patch, uint32_t patch_offset);
+static uint32_t _Expect(const WavFile_Format* format, uint32_t nb_frames, uint16_t* expected);
+static uint32_t _Play(uint32_t nb_values);
+static void 		Test_Output16(void);
+static void 		Test_Output24(void);
+static void 		Test_Gapless(void);
+static void 		Test_BlockAlign(void);
+static void 		Test_LargeChunk(void);
+static void 		Test_OddChunk(void);
+static void 		Test_Extensible(void);
+static void 		Test_TooManyChunks(void);
+static void 		Test_Truncated(void);
+static void 		Test_NotRiff(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(void) {
+	for (uint32_t cpt = 0; cpt < sizeof(s_data); cpt++) {
+		s_data[cpt] = (uint8_t)(cpt * 37 + (cpt >> 7));
+	}
+	if (!HostFat_Format(8 * 1024 * 1024, 8)
+		|| !_AddFile("S16.WAV", &s_s16, _NB_FRAMES)
+		|| !_AddFile("S24.WAV", &s_s24, _NB_FRAMES)
+		|| !_AddFile("ALIGN3.WAV", &s_align3, 1000)
+		|| !_AddFile("ALIGN8.WAV", &s_align8, 1000)
+		|| !_AddFile("BIGLIST.WAV", &s_big_list, 5000)
+		|| !_AddFile("ODDLIST.WAV", &s_odd_list, 5000)
+		|| !_AddFile("EXTPCM.WAV", &s_ext_pcm, 5000)
+		|| !_AddFile("EXTF32.WAV", &s_ext_f32, 5000)
+		|| !_AddFile("CHUNKS14.WAV", &s_chunks14, 1000)
+		|| !_AddFile("CHUNKS15.WAV", &s_chunks15, 1000)
+		|| !_AddCut("CUTLIST.WAV", &s_list1000, 1000, 12 + 24 + 8 + 500, NULL, 0)		// in the LIST chunk
+		|| !_AddCut("CUTDATA.WAV", &s_s16, 5000, WAV_FILE_HEADER_SIZE + 3001 * 4 + 2, NULL, 0)		// frame 3001 split
+		|| !_AddCut("RIFX.WAV", &s_s16, 100, 0, "RIFX", 0)
+		|| !_AddCut("AVI.WAV", &s_s16, 100, 0, "AVI ", 8)
+		|| !_AddCut("SHORT.WAV", &s_s16, 100, 10, NULL, 0)
+		|| SDIO_Interface_MountSD() != FR_OK) {
+		printf("cannot build the volume\n");
+		return 1;
+	}
+	WavDecoder_Init();
+
+	TEST_RUN(Test_Output16);
+	TEST_RUN(Test_Output24);
+	TEST_RUN(Test_Gapless);
+	TEST_RUN(Test_BlockAlign);
+	TEST_RUN(Test_LargeChunk);
+	TEST_RUN(Test_OddChunk);
+	TEST_RUN(Test_Extensible);
+	TEST_RUN(Test_TooManyChunks);
+	TEST_RUN(Test_Truncated);
+	TEST_RUN(Test_NotRiff);
+	HostFat_Release();
+	return TEST_RESULT();
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+bool _AddFile(const char* name, const WavFile_Format* format, uint32_t nb_frames) {
+	return _AddCut(name, format, nb_frames, 0, NULL, 0);
+}
+
+/*
+ * File of length bytes (0 for all) with patch written at patch_offset
+ */
+bool _AddCut(const char* name, const WavFile_Format* format, uint32_t nb_frames, uint32_t length, const char* patch, uint32_t patch_offset) {
+	uint32_t data_length = nb_frames * format->nb_channels * format->bits_per_sample / 8;
+	uint8_t* wav = malloc(WavFile_Size(format, data_length));
+	bool result = false;
+
+	if (wav != NULL) {
+		uint32_t size = WavFile_Build(wav, format, s_data, data_length);
+		if (patch) memcpy(&wav[patch_offset], patch, strlen(patch));
+		result = HostFat_AddFile(name, wav, (length && length < size) ? length : size, false);
+	}
+	free(wav);
+	return result;
+}
+
+/*
+ * DAC values of the first nb_frames frames of s_data, returns nb_frames
+ */
+uint32_t _Expect(const WavFile_Format* format, uint32_t nb_frames, uint16_t* expected) {
+	WAV_Converter converter = WavConverter_Select(format->audio_format, format->nb_channels, format->bits_per_sample);
+
+	converter(s_data, expected, nb_frames);
+	return nb_frames;
+}
+
+/*
+ * Runs the output until nb_values are in s_output, returns the underruns
+ */
+uint32_t _Play(uint32_t nb_values) {
+	uint32_t nb_output = 2 * _HALF;
+	WAV_Stats stats;
+
+	WavDecoder_ResetStats();
+	WavDecoder_StartOutput(s_dac_buf, 2 * _HALF);
+	memcpy(s_output, s_dac_buf, sizeof(s_dac_buf));
+	while (nb_output < nb_values) {
+		WavDecoder_FeedDacBuffer();
+		WavDecoder_HalfTransferCallback();
+		memcpy(&s_output[nb_output], s_dac_buf, _HALF * sizeof(uint16_t));
+		WavDecoder_FeedDacBuffer();
+		WavDecoder_TransferCompleteCallback();
+		memcpy(&s_output[nb_output + _HALF], &s_dac_buf[_HALF], _HALF * sizeof(uint16_t));
+		nb_output += 2 * _HALF;
+	}
+	WavDecoder_GetStats(&stats);
+	return stats.underruns;
+}
+
+void Test_Output16(void) {
+	uint32_t nb_values = _Expect(&s_s16, _NB_FRAMES, s_expected);
+	SDIO_Stats sdio;
+
+	SDIO_Interface_ResetStats();
+	TEST_EQUAL(WavDecoder_OpenFile("S16.WAV"), WAV_OK);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+	TEST_EQUAL(s_output[nb_values], WAV_DAC_SILENCE);		// end of playlist
+
+	SDIO_Interface_GetStats(&sdio);		// only the first chunk (header) and the last sector are copied
+	TEST_CHECK(sdio.bytes_copied <= 4096 + 512);
+	TEST_EQUAL(sdio.multi_sector_reads, sdio.sd_reads);
+}
+
+void Test_Output24(void) {
+	uint32_t nb_values = _Expect(&s_s24, _NB_FRAMES, s_expected);		// 6 bytes frames, split by the buffer wrap
+
+	TEST_EQUAL(WavDecoder_OpenFile("S24.WAV"), WAV_OK);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+	TEST_EQUAL(s_output[nb_values], WAV_DAC_SILENCE);
+}
+
+void Test_Gapless(void) {
+	uint32_t nb_values = _Expect(&s_s16, _NB_FRAMES, s_expected);
+
+	nb_values += _Expect(&s_s24, _NB_FRAMES, &s_expected[nb_values]);
+	TEST_EQUAL(WavDecoder_OpenFile("S16.WAV"), WAV_OK);
+	TEST_EQUAL(WavDecoder_QueueFile("S24.WAV"), WAV_OK);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+	TEST_EQUAL(s_output[nb_values], WAV_DAC_SILENCE);
+}
+
+void Test_BlockAlign(void) {		// nBlockAlign not matching the channels and sample size
+	TEST_EQUAL(WavDecoder_OpenFile("ALIGN3.WAV"), WAV_UNSUPPORTED_FORMAT);
+	TEST_EQUAL(WavDecoder_OpenFile("ALIGN8.WAV"), WAV_UNSUPPORTED_FORMAT);
+	TEST_EQUAL(WavDecoder_OpenFile("S16.WAV"), WAV_OK);
+}
+
+/*
+ * Metadata three times the buffer size, skipped with a seek
+ */
+void Test_LargeChunk(void) {
+	uint32_t nb_values = _Expect(&s_big_list, 5000, s_expected);
+
+	TEST_EQUAL(WavDecoder_OpenFile("BIGLIST.WAV"), WAV_OK);
+	TEST_EQUAL(WavDecoder_GetMusicData()->data_size, 5000 * 4);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+	TEST_EQUAL(s_output[nb_values], WAV_DAC_SILENCE);
+}
+
+void Test_OddChunk(void) {		// 4095 bytes and a pad byte
+	uint32_t nb_values = _Expect(&s_odd_list, 5000, s_expected);
+
+	TEST_EQUAL(WavDecoder_OpenFile("ODDLIST.WAV"), WAV_OK);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+}
+
+/*
+ * WAVE_FORMAT_EXTENSIBLE, the format is the first bytes of the SubFormat
+ */
+void Test_Extensible(void) {
+	uint32_t nb_values = _Expect(&s_ext_pcm, 5000, s_expected);
+
+	TEST_EQUAL(WavDecoder_OpenFile("EXTPCM.WAV"), WAV_OK);
+	TEST_EQUAL(WavDecoder_GetMusicData()->audio_format, WAV_FORMAT_PCM);
+	TEST_EQUAL(WavDecoder_GetMusicData()->block_size, 40);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+
+	nb_values = _Expect(&s_ext_f32, 5000, s_expected);
+	TEST_EQUAL(WavDecoder_OpenFile("EXTF32.WAV"), WAV_OK);
+	TEST_EQUAL(WavDecoder_GetMusicData()->audio_format, WAV_FORMAT_IEEE_FLOAT);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+}
+
+/*
+ * fmt, 14 LIST and data: 16 chunks, the most walked
+ */
+void Test_TooManyChunks(void) {
+	TEST_EQUAL(WavDecoder_OpenFile("CHUNKS14.WAV"), WAV_OK);
+	TEST_EQUAL(WavDecoder_OpenFile("CHUNKS15.WAV"), WAV_NO_DATA);
+}
+
+void Test_Truncated(void) {
+	uint32_t nb_values = _Expect(&s_s16, 3001, s_expected);
+
+	TEST_EQUAL(WavDecoder_OpenFile("CUTLIST.WAV"), WAV_NO_DATA);
+
+	TEST_EQUAL(WavDecoder_OpenFile("CUTDATA.WAV"), WAV_OK);
+	TEST_EQUAL(WavDecoder_GetMusicData()->data_size, 5000 * 4);
+	TEST_EQUAL(_Play(nb_values + _HALF), 0);
+	TEST_CHECK(memcmp(s_output, s_expected, nb_values * sizeof(uint16_t)) == 0);
+	TEST_EQUAL(s_output[nb_values], WAV_DAC_SILENCE);		// the split frame is dropped
+}
+
+void Test_NotRiff(void) {
+	TEST_EQUAL(WavDecoder_OpenFile("RIFX.WAV"), WAV_NOT_RIFF);
+	TEST_EQUAL(WavDecoder_OpenFile("AVI.WAV"), WAV_NOT_RIFF);
+	TEST_EQUAL(WavDecoder_OpenFile("SHORT.WAV"), WAV_FILE_ERROR);
+	TEST_EQUAL(WavDecoder_OpenFile("MISSING.WAV"), WAV_FILE_ERROR);
+}
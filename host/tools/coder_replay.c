@@ -0,0 +1,165 @@
+/**
+ ******************************************************************************
+ * @file coder_replay.c
+ * @brief Host tool implementation file
+ *        Step response and noise of the coder speed estimators
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note usage
+ * 			esw_coder_replay                  steps of jittered edges, table
+ * 			esw_coder_replay edges.txt [fast|medium|slow] > speeds.csv
+ * without argument, speed steps with 5% period jitter are played through the
+ * former 30 periods average and the coder at each response: 90% step latency,
+ * and noise at the final speed on a constant speed trace once settled. A trace file holds one edge time per line, in
+ * seconds (e.g. a logic analyzer export), the speeds are written as CSV.
+ ******************************************************************************
+ */
+#include "coder_replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define REPLAY_MAX_EDGES 	(1000000)
+#define REPLAY_STEP_S 				(1.0)
+#define REPLAY_STEP_SAMPLES 	(2000)		// one per ms, step trace
+#define REPLAY_SETTLE_S 			(1.0)
+#define REPLAY_NOISE_SAMPLES 	(4000)		// one per ms, constant speed trace
+#define REPLAY_JITTER 				(0.05)
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	double from;		// turns per second
+	double to;
+} REPLAY_Step;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const REPLAY_Step s_steps[] = {
+	{1, 2},
+	{5, 10},
+	{20, 40},
+	{40, 20},
+	{100, 150},
+};
+
+static const char* const s_responses[CODER_NB_RESPONSES] = {"fast", "medium", "slow"};
+
+static double s_edges[REPLAY_MAX_EDGES];
+static float 	s_old[REPLAY_NOISE_SAMPLES];
+static float 	s_new[REPLAY_NOISE_SAMPLES];
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _Steps(void);
+static void _Measure(const REPLAY_Step* step, CODER_RESPONSE response, float latency[2], float noise[2]);
+static int 	_ReplayFile(const char* path, CODER_RESPONSE response);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+	CODER_RESPONSE response = CODER_RESPONSE_MEDIUM;
+
+	if (!CoderReplay_Init()) {
+		fprintf(stderr, "cannot start the coder\n");
+		return 1;
+	}
+	if (argc < 2) {
+		_Steps();
+		return 0;
+	}
+	for (int cpt = 0; argc >= 3 && cpt < CODER_NB_RESPONSES; cpt++) {
+		if (strcmp(argv[2], s_responses[cpt]) == 0) response = cpt;
+	}
+	return _ReplayFile(argv[1], response);
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _Steps(void) {
+	printf("90%% step latency (ms) / noise at the final speed, %.0f%% period jitter\n", REPLAY_JITTER * 100);
+	printf("  %-16s %16s", "turns/s", "30 periods avg");
+	for (int cpt = 0; cpt < CODER_NB_RESPONSES; cpt++) printf(" %16s", s_responses[cpt]);
+	printf("\n");
+
+	for (uint32_t step = 0; step < sizeof(s_steps) / sizeof(s_steps[0]); step++) {
+		const REPLAY_Step* s = &s_steps[step];
+		char label[32];
+
+		snprintf(label, sizeof(label), "%g -> %g", s->from, s->to);
+		printf("  %-16s", label);
+		for (int response = 0; response < CODER_NB_RESPONSES; response++) {
+			float latency[2];
+			float noise[2];
+
+			_Measure(s, response, latency, noise);
+			if (response == 0) printf(" %8.0f / %4.1f%%", latency[0], noise[0] * 100);
+			printf(" %8.0f / %4.1f%%", latency[1], noise[1] * 100);
+		}
+		printf("\n");
+	}
+}
+
+/*
+ * Latency on the step trace, noise on a constant trace at the final speed,
+ * of the average [0] and of the coder [1]
+ */
+void _Measure(const REPLAY_Step* step, CODER_RESPONSE response, float latency[2], float noise[2]) {
+	CoderReplay_Output output = {s_old, s_new, REPLAY_STEP_SAMPLES};
+	uint32_t nb_edges = CoderReplay_StepTrace(s_edges, REPLAY_MAX_EDGES, step->from, step->to, REPLAY_STEP_S, REPLAY_STEP_SAMPLES / 1000.0, REPLAY_JITTER);
+
+	CoderReplay_Run(s_edges, nb_edges, response, &output);
+	latency[0] = CoderReplay_Latency(s_old, output.nb_samples, step->from, step->to, REPLAY_STEP_S);
+	latency[1] = CoderReplay_Latency(s_new, output.nb_samples, step->from, step->to, REPLAY_STEP_S);
+
+	output.nb_samples = REPLAY_NOISE_SAMPLES;
+	nb_edges = CoderReplay_StepTrace(s_edges, REPLAY_MAX_EDGES, step->to, step->to, 0, REPLAY_NOISE_SAMPLES / 1000.0, REPLAY_JITTER);
+	CoderReplay_Run(s_edges, nb_edges, response, &output);
+	noise[0] = CoderReplay_Noise(s_old, output.nb_samples, step->to, REPLAY_SETTLE_S);
+	noise[1] = CoderReplay_Noise(s_new, output.nb_samples, step->to, REPLAY_SETTLE_S);
+}
+
+int _ReplayFile(const char* path, CODER_RESPONSE response) {
+	FILE* file = fopen(path, "r");
+	uint32_t nb_edges = 0;
+	double first = 0;
+
+	if (file == NULL) {
+		fprintf(stderr, "cannot open %s\n", path);
+		return 1;
+	}
+	while (nb_edges < REPLAY_MAX_EDGES && fscanf(file, "%lf", &s_edges[nb_edges]) == 1) {
+		if (nb_edges == 0) first = s_edges[0];
+		s_edges[nb_edges] -= first;		// trace starts at 0
+		nb_edges++;
+	}
+	fclose(file);
+	if (nb_edges == 0) return 1;
+
+	uint32_t nb_samples = (uint32_t)(s_edges[nb_edges - 1] * 1000) + 1;
+	float* speeds = malloc(2 * nb_samples * sizeof(float));
+	if (speeds == NULL) return 1;
+
+	CoderReplay_Output output = {speeds, speeds + nb_samples, nb_samples};
+	CoderReplay_Run(s_edges, nb_edges, response, &output);
+	printf("time_ms,average_30,coder_%s\n", s_responses[response]);
+	for (uint32_t cpt = 0; cpt < nb_samples; cpt++) {
+		printf("%u,%.4f,%.4f\n", cpt + 1, output.old_speed[cpt], output.new_speed[cpt]);
+	}
+	free(speeds);
+	return 0;
+}
@@ -0,0 +1,55 @@
+#!/bin/sh
+# ******************************************************************************
+# @file printf_size.sh
+# @brief Host tool implementation file
+#        Code size of Shell_Printf against the C library sprintf
+#
+# @creation 2026/10/17
+# @edition 2026/10/17
+#
+# @author Guillaume Dauguen
+#
+# ******************************************************************************
+# @note usage, from the repository root
+# 			host/tools/printf_size.sh
+# 			CC=arm-none-eabi-gcc CFLAGS="-mcpu=cortex-m4 -mthumb" \
+# 			LDFLAGS="--specs=nano.specs --specs=nosys.specs" host/tools/printf_size.sh
+# Shell_Printf: text of the formatter functions of Shell.o (-Os).
+# sprintf: text added to a static program by one sprintf call. The glibc
+# startup already links vfprintf, only a newlib (nano) build gives its real
+# cost.
+# ******************************************************************************
+set -e
+
+CC=${CC:-cc}
+TOOLS=$(echo "$CC" | sed -n 's/g\{0,1\}cc$//p')		# arm-none-eabi-gcc: arm-none-eabi-
+NM=${NM:-${TOOLS}nm}
+SIZE=${SIZE:-${TOOLS}size}
+CFLAGS="-Os -ffunction-sections -fdata-sections $CFLAGS"
+LDFLAGS=${LDFLAGS:--static}
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# formatter of Shell.c, the Tx path (_TxWrite, _MakeRoom) is shared with Shell_PrintString
+$CC $CFLAGS -I"$ROOT/host/hal" -I"$ROOT" -c "$ROOT/Shell.c" -o "$WORK/Shell.o"
+shell=$($NM -S -t d "$WORK/Shell.o" | awk '$4 ~ /^(Shell_Printf|_StartWriter|_Format|_Write|_WritePadding|_WriteNumber)$/ { size += $2 } END { print size }')
+
+cat > "$WORK/base.c" <<'SRC'
+volatile unsigned s_value;
+int main(void) { return (int) s_value; }
+SRC
+cat > "$WORK/sprintf.c" <<'SRC'
+#include <stdio.h>
+volatile unsigned s_value;
+char s_line[64];
+int main(void) { return sprintf(s_line, "speed %5u fill %4u 0x%08x\r\n", s_value, s_value, s_value); }
+SRC
+$CC $CFLAGS "$WORK/base.c" $LDFLAGS -Wl,--gc-sections -o "$WORK/base"
+$CC $CFLAGS "$WORK/sprintf.c" $LDFLAGS -Wl,--gc-sections -o "$WORK/sprintf"
+base=$($SIZE "$WORK/base" | awk 'NR == 2 { print $1 }')
+libc=$($SIZE "$WORK/sprintf" | awk 'NR == 2 { print $1 }')
+
+echo "$CC $CFLAGS"
+echo "  Shell_Printf  $shell bytes"
+echo "  sprintf       $((libc - base)) bytes"
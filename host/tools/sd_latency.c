@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ * @file sd_latency.c
+ * @brief Host tool implementation file
+ *        WAV playback against SD card latency profiles
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note usage
+ * 			esw_sd_latency                       built-in volume, 16 bits 44.1 kHz file
+ * 			esw_sd_latency card.img SONG.WAV     FAT image and 8.3 file name
+ * 			esw_sd_latency dir/ SONG.WAV         files of a directory
+ * each profile plays the file for SD_LATENCY_DURATION_MS of simulated time
+ * and prints the WavDecoder_GetStats() of the run: underruns, DAC values
+ * lost, lowest buffer fill and the buffer size which would have played
+ * without a click.
+ ******************************************************************************
+ */
+#include "host_fat.h"
+#include "playback.h"
+#include "wav_file.h"
+#include "SDIO_Interface.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+// ------------------------------------------------------------------------
+// -------------------------------- MACROS --------------------------------
+// ------------------------------------------------------------------------
+#define SD_LATENCY_DURATION_MS 	(20000)
+#define SD_LATENCY_SECONDS 			(10)		// built-in file
+
+// ------------------------------------------------------------------------
+// ----------------------------- STATIC TYPES -----------------------------
+// ------------------------------------------------------------------------
+typedef struct {
+	const char* 		name;
+	HostFat_Latency latency;
+} SD_Profile;
+
+// ------------------------------------------------------------------------
+// -------------------------- STATIC PROTOTYPES ---------------------------
+// ------------------------------------------------------------------------
+static const SD_Profile s_profiles[] = {		// fixed, per sector, jitter, stall period, stall
+	{"instant",                  {0,    0,   0,     0,      0}},
+	{"class 10 card",            {300,  20,  200,   0,      0}},
+	{"jitter 0-5 ms",            {300,  20,  5000,  0,      0}},
+	{"stall 20 ms / 100 reads",  {300,  20,  200,   100,    20000}},
+	{"stall 50 ms / 100 reads",  {300,  20,  200,   100,    50000}},
+	{"stall 100 ms / 200 reads", {300,  20,  200,   200,    100000}},
+	{"stall 250 ms / 500 reads", {300,  20,  200,   500,    250000}},
+};
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static bool _BuildVolume(void);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+	char* name = "TEST.WAV";
+	bool volume;
+
+	if (argc >= 3) {
+		struct stat info;
+		name = argv[2];
+		volume = (stat(argv[1], &info) == 0 && S_ISDIR(info.st_mode)) ? HostFat_ImportDir(argv[1]) : HostFat_LoadImage(argv[1]);
+	}
+	else {
+		volume = _BuildVolume();
+	}
+	if (!volume || SDIO_Interface_MountSD() != FR_OK) {
+		fprintf(stderr, "cannot mount the volume\n");
+		return 1;
+	}
+
+	WavDecoder_Init();
+	printf("%s, %u ms per profile\n", name, SD_LATENCY_DURATION_MS);
+	printf("  %-26s %9s %10s %9s %10s %9s\n", "profile", "underruns", "lost", "min fill", "min buffer", "card busy");
+	for (uint32_t cpt = 0; cpt < sizeof(s_profiles) / sizeof(s_profiles[0]); cpt++) {
+		WAV_Stats stats;
+		HostFat_Stats disk;
+
+		HostFat_SetLatency(&s_profiles[cpt].latency);
+		HostFat_ResetStats();
+		if (!Playback_Run(name, SD_LATENCY_DURATION_MS, &stats)) {
+			fprintf(stderr, "cannot play %s\n", name);
+			return 1;
+		}
+		HostFat_GetStats(&disk);
+		printf("  %-26s %9u %10u %9u %10u %8.1f%%\n", s_profiles[cpt].name, (unsigned) stats.underruns, (unsigned) stats.underrun_values,
+					 (unsigned) stats.min_fill, (unsigned) stats.min_buffer_size, disk.busy_us / (SD_LATENCY_DURATION_MS * 10.0));
+	}
+	HostFat_Release();
+	return 0;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+/*
+ * 16 MB volume of 4 KB clusters with a 16 bits stereo 44.1 kHz file
+ */
+bool _BuildVolume(void) {
+	const WavFile_Format format = {.audio_format = 1, .nb_channels = 2, .sample_rate = 44100, .bits_per_sample = 16};
+	uint32_t length = SD_LATENCY_SECONDS * 44100 * 4;
+	uint8_t* data = calloc(1, length);
+	uint8_t* wav = malloc(WavFile_Size(&format, length));
+	bool result = false;
+
+	if (data != NULL && wav != NULL && HostFat_Format(16 * 1024 * 1024, 8)) {
+		result = HostFat_AddFile("TEST.WAV", wav, WavFile_Build(wav, &format, data, length), false);
+	}
+	free(data);
+	free(wav);
+	return result;
+}
@@ -0,0 +1,58 @@
+/**
+ ******************************************************************************
+ * @file tlm_csv.c
+ * @brief Host tool implementation file
+ *        Telemetry capture to CSV
+ *
+ * @creation 2026/10/17
+ * @edition 2026/10/17
+ *
+ * @author Guillaume Dauguen
+ *
+ ******************************************************************************
+ * @note usage
+ * 			esw_tlm_csv capture.bin > capture.csv
+ * 			cat /dev/ttyUSB0 | esw_tlm_csv > capture.csv
+ * the capture is the raw byte stream of the telemetry UART (e.g. stty raw
+ * 921600 then cat). One CSV line per valid record, the record and error
+ * counts are printed on stderr at the end.
+ ******************************************************************************
+ */
+#include "tlm_decoder.h"
+
+#include <stdio.h>
+
+// ------------------------------------------------------------------------
+// ---------------------- STATIC FUCTIONS PROTOTYPES ----------------------
+// ------------------------------------------------------------------------
+static void _PrintRecord(const TlmDecoder_Record* record, void* context);
+
+// ------------------------------------------------------------------------
+// ------------------- PUBLIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+int main(int argc, char** argv) {
+	FILE* input = (argc >= 2) ? fopen(argv[1], "rb") : stdin;
+	uint8_t data[4096];
+	TlmDecoder decoder;
+	size_t length;
+
+	if (input == NULL) {
+		fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+	TlmDecoder_Init(&decoder, _PrintRecord, stdout);
+	TlmDecoder_PrintCsvHeader(stdout);
+	while ((length = fread(data, 1, sizeof(data), input)) > 0) {
+		TlmDecoder_Push(&decoder, data, length);
+	}
+	if (input != stdin) fclose(input);
+	fprintf(stderr, "%u records, %u bad frames\n", decoder.records, decoder.errors);
+	return 0;
+}
+
+// ------------------------------------------------------------------------
+// ------------------- STATIC FUNCTIONS IMPLEMENTATION --------------------
+// ------------------------------------------------------------------------
+void _PrintRecord(const TlmDecoder_Record* record, void* context) {
+	TlmDecoder_PrintCsv((FILE*) context, record);
+}